@@ -8,6 +8,9 @@ layout (location = 2) in vec2 vTexCoord;
 #endif
 layout (location = 5) in ivec4 vBoneIDs;
 layout (location = 6) in vec4 vBoneWeights;
+#ifdef INSTANCING
+layout (location = 7) in mat4 vInstanceModel;	// per-instance world matrix, occupies locations 7-10
+#endif
 
 //out
 #ifdef OUTLINE_DISCARD_ALPHA
@@ -15,7 +18,11 @@ out vec2 texCoord;
 #endif
 
 //uniform
+#ifdef INSTANCING
+uniform mat4 VP;
+#else
 uniform mat4 MVP;
+#endif
 uniform int boneIDOffset;
 layout (std140) uniform BoneMatrices
 {
@@ -29,6 +36,10 @@ layout (std140) uniform BoneMatrices
 
 void main()
 {	
+	#ifdef INSTANCING
+	mat4 MVP = VP * vInstanceModel;
+	#endif
+
 	mat4 boneMatrix = boneMatrices[vBoneIDs[0] + boneIDOffset] * vBoneWeights[0];
 	for (int i = 1; i < 4; i++)
 		boneMatrix += boneMatrices[vBoneIDs[i] + boneIDOffset] * vBoneWeights[i];
@@ -6,8 +6,11 @@ out vec2 texCoord2;
 out float blend;
 
 //uniform
-uniform vec2 atlasData;	//x - texture id, y - number of columns in atlas
-uniform vec2 atlasTexOffset;
+layout (std140) uniform MaterialInstanceData	//see Material::InstanceDataBlock
+{
+	vec2 atlasData;	//x - texture id, y - number of columns in atlas
+	vec2 atlasTexOffset;
+} materialInstance;
 uniform mat4 MVP;
 
 
@@ -18,15 +21,15 @@ void main()
 	texCoord2 = texCoord1;
 	blend = 1.0;
 	
-	if (atlasData != vec2(0.0))
+	if (materialInstance.atlasData != vec2(0.0))
 	{
-		blend = atlasData.x - floor(atlasData.x);
-		float texID = floor(atlasData.x);
+		blend = materialInstance.atlasData.x - floor(materialInstance.atlasData.x);
+		float texID = floor(materialInstance.atlasData.x);
 		
-		vec2 positionInAtlas = vec2(mod(texID, atlasData.y), -floor(texID / atlasData.y));
-		vec2 nextPositionInAtlas = vec2(mod((texID + 1.0), atlasData.y), -floor((texID + 1.0) / atlasData.y));
+		vec2 positionInAtlas = vec2(mod(texID, materialInstance.atlasData.y), -floor(texID / materialInstance.atlasData.y));
+		vec2 nextPositionInAtlas = vec2(mod((texID + 1.0), materialInstance.atlasData.y), -floor((texID + 1.0) / materialInstance.atlasData.y));
 		
-		texCoord1 = (vec2(0.0, 1.0 - atlasTexOffset.y) + positionInAtlas * atlasTexOffset) + (texCoord1 * atlasTexOffset);
-		texCoord2 = (vec2(0.0, 1.0 - atlasTexOffset.y) + nextPositionInAtlas * atlasTexOffset) + (texCoord2 * atlasTexOffset);
+		texCoord1 = (vec2(0.0, 1.0 - materialInstance.atlasTexOffset.y) + positionInAtlas * materialInstance.atlasTexOffset) + (texCoord1 * materialInstance.atlasTexOffset);
+		texCoord2 = (vec2(0.0, 1.0 - materialInstance.atlasTexOffset.y) + nextPositionInAtlas * materialInstance.atlasTexOffset) + (texCoord2 * materialInstance.atlasTexOffset);
 	}
 }
\ No newline at end of file
@@ -48,23 +48,26 @@ struct Material
 	sampler2D specular1;
 	sampler2D normal1;
 	
-	vec4 color;
-	bool disableColor;
 	#ifdef ENABLE_POM
 	sampler2D depth1;
-	float depthScale;
 	#endif
 	#ifdef PBR_SHADING
-	vec3 roughnessMetallicAoColor;
-	
 	sampler2D roughness1;
 	sampler2D metallic1;
 	sampler2D ao1;
 	sampler2D combined1;
 	#endif
-	
-	float shininess;
 };
+
+//Properties of the material which are not textures; uploaded by the engine only when they change (see Material::MaterialDataBlock)
+layout (std140) uniform MaterialData
+{
+	vec4 color;
+	vec3 roughnessMetallicAoColor;
+	float shininess;
+	float depthScale;
+	bool disableColor;
+} materialData;
 //in
 in VS_OUT
 {
@@ -228,22 +231,22 @@ Fragment getFragment()
 	frag.position = fragIn.worldPosition;
 	frag.normal = normal;
 	frag.albedo.rgb = texture(material.albedo1, texCoord).rgb;
-	if (!material.disableColor && frag.albedo.rgb == vec3(0.0))
-		frag.albedo.rgb = material.color.rgb;
+	if (!materialData.disableColor && frag.albedo.rgb == vec3(0.0))
+		frag.albedo.rgb = materialData.color.rgb;
 	
 	frag.specular = texture(material.specular1, texCoord).r;
 	//#ifdef PBR_SHADING
 	frag.alphaMetalAo.r = texture(material.roughness1, texCoord).r;
 	if (frag.alphaMetalAo.r == 0.0)	frag.alphaMetalAo.r = texture(material.combined1, texCoord).g;
-	if (frag.alphaMetalAo.r == 0.0)	frag.alphaMetalAo.r = material.roughnessMetallicAoColor.r;
+	if (frag.alphaMetalAo.r == 0.0)	frag.alphaMetalAo.r = materialData.roughnessMetallicAoColor.r;
 	frag.alphaMetalAo.r = pow(frag.alphaMetalAo.r, 2.0);
 	
 	frag.alphaMetalAo.g = texture(material.metallic1, texCoord).r;
 	if (frag.alphaMetalAo.g == 0.0)	frag.alphaMetalAo.g = texture(material.combined1, texCoord).b;
-	if (frag.alphaMetalAo.g == 0.0) frag.alphaMetalAo.g = material.roughnessMetallicAoColor.g;
+	if (frag.alphaMetalAo.g == 0.0) frag.alphaMetalAo.g = materialData.roughnessMetallicAoColor.g;
 	
 	frag.alphaMetalAo.b = texture(material.ao1, texCoord).r;
-	if (frag.alphaMetalAo.b == 0.0) frag.alphaMetalAo.b = material.roughnessMetallicAoColor.b;
+	if (frag.alphaMetalAo.b == 0.0) frag.alphaMetalAo.b = materialData.roughnessMetallicAoColor.b;
 	
 	//#endif
 	return frag;
@@ -4,24 +4,27 @@ struct Material
 	sampler2D specular1;
 	sampler2D normal1;
 	
-	vec4 color;
-	bool disableColor;
 	#ifdef ENABLE_POM
 	sampler2D depth1;
-	float depthScale;
 	#endif
 	#ifdef PBR_SHADING
-	vec3 roughnessMetallicAoColor;
-	
 	sampler2D roughness1;
 	sampler2D metallic1;
 	sampler2D ao1;
 	sampler2D combined1;
 	#endif
-	
-	float shininess;
 };
 
+//Properties of the material which are not textures; uploaded by the engine only when they change (see Material::MaterialDataBlock)
+layout (std140) uniform MaterialData
+{
+	vec4 color;
+	vec3 roughnessMetallicAoColor;
+	float shininess;
+	float depthScale;
+	bool disableColor;
+} materialData;
+
 //in
 in VS_OUT
 {
@@ -59,7 +62,7 @@ uniform Material material;
 
 vec2 ParallaxOcclusion(vec2 texCoord)	//Parallax Occlusion Mapping algorithm
 {
-	if (material.depthScale == 0.0)	//this won't optimize anything but rather prevent any unnecessary texCoord change
+	if (materialData.depthScale == 0.0)	//this won't optimize anything but rather prevent any unnecessary texCoord change
 		return texCoord;
 
 	vec3 viewDir = normalize(transpose(frag.TBN) * normalize(camPos - frag.worldPosition));
@@ -82,7 +85,7 @@ vec2 ParallaxOcclusion(vec2 texCoord)	//Parallax Occlusion Mapping algorithm
 	
 	float samples = mix(maxSamples, minSamples, abs(dot(viewDir, vec3(0.0, 0.0, 1.0))));
 	float depthOffset = 1.0 / samples;
-	vec2 unitOffset = viewDir.xy / viewDir.z * depthOffset * material.depthScale;
+	vec2 unitOffset = viewDir.xy / viewDir.z * depthOffset * materialData.depthScale;
 	
 	texCoord -= unitOffset;
 	
@@ -131,23 +134,23 @@ void main()
 	gNormal = normal;
 	vec4 albedoColor = texture(material.albedo1, texCoord);
 	gAlbedoSpec.rgb = albedoColor.rgb;
-	if (!material.disableColor && gAlbedoSpec.rgb == vec3(0.0))
-		gAlbedoSpec.rgb = material.color.rgb;
+	if (!materialData.disableColor && gAlbedoSpec.rgb == vec3(0.0))
+		gAlbedoSpec.rgb = materialData.color.rgb;
 	//else if (texture(material.albedo1, texCoord).a < 0.5)
 		//discard;
 	gAlbedoSpec.a = texture(material.specular1, texCoord).r;
 	#ifdef PBR_SHADING
 	gAlphaMetalAo.r = texture(material.roughness1, texCoord).r;
 	if (gAlphaMetalAo.r == 0.0)	gAlphaMetalAo.r = texture(material.combined1, texCoord).g;
-	if (gAlphaMetalAo.r == 0.0)	gAlphaMetalAo.r = material.roughnessMetallicAoColor.r;
+	if (gAlphaMetalAo.r == 0.0)	gAlphaMetalAo.r = materialData.roughnessMetallicAoColor.r;
 	gAlphaMetalAo.r = pow(gAlphaMetalAo.r, 2.0);
 	
 	gAlphaMetalAo.g = texture(material.metallic1, texCoord).r;
 	if (gAlphaMetalAo.g == 0.0)	gAlphaMetalAo.g = texture(material.combined1, texCoord).b;
-	if (gAlphaMetalAo.g == 0.0) gAlphaMetalAo.g = material.roughnessMetallicAoColor.g;
+	if (gAlphaMetalAo.g == 0.0) gAlphaMetalAo.g = materialData.roughnessMetallicAoColor.g;
 	
 	gAlphaMetalAo.b = texture(material.ao1, texCoord).r;
-	if (gAlphaMetalAo.b == 0.0) gAlphaMetalAo.b = material.roughnessMetallicAoColor.b;
+	if (gAlphaMetalAo.b == 0.0) gAlphaMetalAo.b = materialData.roughnessMetallicAoColor.b;
 	
 	#endif
 	
@@ -6,6 +6,10 @@ layout (location = 3) in vec3 vTangent;
 layout (location = 4) in vec3 vBitangent;
 layout (location = 5) in ivec4 vBoneIDs;
 layout (location = 6) in vec4 vBoneWeights;
+#ifdef INSTANCING
+layout (location = 7) in mat4 vInstanceModel;	// per-instance world matrix, occupies locations 7-10
+layout (location = 11) in mat4 vInstancePrevModel;	// per-instance world matrix of the previous frame, occupies locations 11-14
+#endif
 
 //out
 out VS_OUT
@@ -26,13 +30,21 @@ out VS_OUT
 
 //uniform
 uniform int boneIDOffset;
+#ifdef INSTANCING
+uniform mat4 VP;
+#else
 uniform mat4 model;
 uniform mat4 MVP;
+uniform mat3 normalMat;
+#endif
 uniform bool tangentless;
 #ifdef CALC_VELOCITY_BUFFER
+#ifdef INSTANCING
+uniform mat4 prevVP;
+#else
 uniform mat4 prevMVP;
 #endif
-uniform mat3 normalMat;
+#endif
 layout (std140) uniform BoneMatrices
 {
 	mat4 boneMatrices[BONE_MATS_BATCH_SIZE];
@@ -44,6 +56,15 @@ layout (std140) uniform PreviousBoneMatrices
 
 void main()
 {
+	#ifdef INSTANCING
+	mat4 model = vInstanceModel;
+	mat4 MVP = VP * model;
+	mat3 normalMat = transpose(inverse(mat3(model)));
+	#ifdef CALC_VELOCITY_BUFFER
+	mat4 prevMVP = prevVP * vInstancePrevModel;
+	#endif
+	#endif
+
 	mat4 boneMatrix = boneMatrices[vBoneIDs[0] + boneIDOffset] * vBoneWeights[0];
 	for (int i = 1; i < 4; i++)
 		boneMatrix += boneMatrices[vBoneIDs[i] + boneIDOffset] * vBoneWeights[i];
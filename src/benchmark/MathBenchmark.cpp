@@ -0,0 +1,88 @@
+// Micro-benchmark of the batched math kernels (math/Simd.h) against the equivalent glm code.
+// Usage: gee_math_benchmark [element count] [iterations]
+
+#include <math/Simd.h>
+#include <math/Box.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace GEE;
+
+template <typename Func>
+double MeasureNanosecondsPerElement(Func&& func, std::size_t elementCount, unsigned int iterations)
+{
+	func();	// warm up the caches
+	auto begin = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+		func();
+	auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(elementCount * iterations);
+}
+
+void PrintResult(const std::string& kernelName, double glmTime, double simdTime)
+{
+	std::cout << kernelName << ":\tglm " << glmTime << " ns\tkernel " << simdTime << " ns\tspeedup x" << glmTime / simdTime << '\n';
+}
+
+int main(int argc, char** argv)
+{
+	const std::size_t count = (argc > 1) ? (std::stoul(argv[1])) : (10000);
+	const unsigned int iterations = (argc > 2) ? (static_cast<unsigned int>(std::stoul(argv[2]))) : (200);
+
+	std::mt19937 randomEngine(1234);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	auto random = [&]() { return distribution(randomEngine); };
+
+	std::vector<Vec3f> positions(count), scales(count);
+	std::vector<Quatf> rotations(count), rotations2(count), outQuats(count);
+	std::vector<Mat4f> matrices(count), matrices2(count), outMatrices(count);
+	std::vector<Boxf<Vec3f>> boxes(count, Boxf<Vec3f>(Vec3f(0.0f), Vec3f(1.0f))), outBoxes = boxes;
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		positions[i] = Vec3f(random(), random(), random()) * 100.0f;
+		scales[i] = Vec3f(random(), random(), random()) + 2.0f;
+		rotations[i] = glm::normalize(Quatf(random(), random(), random(), random()));
+		rotations2[i] = glm::normalize(Quatf(random(), random(), random(), random()));
+		boxes[i] = Boxf<Vec3f>(positions[i], scales[i]);
+	}
+	Math::TRSToMatrices(positions.data(), rotations.data(), scales.data(), matrices.data(), count);
+	Math::TRSToMatrices(positions.data(), rotations2.data(), scales.data(), matrices2.data(), count);
+
+	std::cout << "Instruction set: " << Math::GetSimdInstructionSetName() << ", " << count << " elements, " << iterations << " iterations\n";
+
+	PrintResult("TRS to matrix",
+		MeasureNanosecondsPerElement([&]() { for (std::size_t i = 0; i < count; i++) outMatrices[i] = glm::scale(glm::translate(Mat4f(1.0f), positions[i]) * glm::mat4_cast(rotations[i]), scales[i]); }, count, iterations),
+		MeasureNanosecondsPerElement([&]() { Math::TRSToMatrices(positions.data(), rotations.data(), scales.data(), outMatrices.data(), count); }, count, iterations));
+
+	PrintResult("Matrix * matrix",
+		MeasureNanosecondsPerElement([&]() { for (std::size_t i = 0; i < count; i++) outMatrices[i] = matrices[i] * matrices2[i]; }, count, iterations),
+		MeasureNanosecondsPerElement([&]() { Math::MultiplyMatrices(matrices.data(), matrices2.data(), outMatrices.data(), count); }, count, iterations));
+
+	PrintResult("Quat * quat",
+		MeasureNanosecondsPerElement([&]() { for (std::size_t i = 0; i < count; i++) outQuats[i] = rotations[i] * rotations2[i]; }, count, iterations),
+		MeasureNanosecondsPerElement([&]() { Math::MultiplyQuaternions(rotations.data(), rotations2.data(), outQuats.data(), count); }, count, iterations));
+
+	PrintResult("Quat normalize",
+		MeasureNanosecondsPerElement([&]() { outQuats = rotations; for (std::size_t i = 0; i < count; i++) outQuats[i] = glm::normalize(outQuats[i]); }, count, iterations),
+		MeasureNanosecondsPerElement([&]() { outQuats = rotations; Math::NormalizeQuaternions(outQuats.data(), count); }, count, iterations));
+
+	PrintResult("AABB transform",
+		MeasureNanosecondsPerElement([&]()
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				Mat3f absMatrix(matrices[i]);
+				for (int axis = 0; axis < 3; axis++)
+					absMatrix[axis] = glm::abs(absMatrix[axis]);
+				outBoxes[i] = Boxf<Vec3f>(Vec3f(matrices[i] * Vec4f(boxes[i].Position, 1.0f)), absMatrix * boxes[i].Size);
+			}
+		}, count, iterations),
+		MeasureNanosecondsPerElement([&]() { Math::TransformBoxes(boxes.data(), matrices.data(), outBoxes.data(), count); }, count, iterations));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,534 @@
+// Benchmarks the projects under Projects/: measures their load time and the duration of fixed update steps (and of rendering, if enabled) while the camera follows a scripted path.
+// Usage: gee_bench run [--steps N] [--render | --software-gl] [--output report.json] [project files...]	- without project files, every project under Projects/ is benchmarked
+//        gee_bench compare <baseline report> <current report> [threshold %]	- exits with 1 if any metric got worse than the threshold (10% by default)
+// --render renders every step to a hidden window and waits for the GPU; --software-gl does the same with Mesa's software rasterizer (LIBGL_ALWAYS_SOFTWARE), for machines without a GPU.
+// Run it from the folder which contains Projects/ and Assets/.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <editor/GameEngineEngineEditor.h>
+#include <game/Game.h>
+#include <game/GameScene.h>
+#include <rendering/Renderer.h>
+#include <rendering/RenderToolbox.h>
+#include <rendering/GpuProfiler.h>
+#include <scene/Actor.h>
+#include <scene/CameraComponent.h>
+#include <utility/OperatingSystem.h>
+#include <utility/CommandLine.h>
+#include <utility/CerealArchives.h>	// cereal bundles rapidjson, which reads the reports
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef GEE_OS_WINDOWS
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace GEE;
+Editor::EditorManager* Editor::EditorEventProcessor::EditorHandle = nullptr;
+
+// Compared by gee_bench compare. Lower is better for all of them.
+const char* const ComparedMetrics[] = { "load_ms", "update_mean_ms", "update_p50_ms", "update_p99_ms", "render_mean_ms", "render_p50_ms", "render_p99_ms", "draw_calls_per_frame", "peak_memory_mb" };
+
+template <typename Func>
+double MeasureMilliseconds(Func&& func)
+{
+	auto begin = std::chrono::steady_clock::now();
+	func();
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+/**
+ * @return the peak resident set size of the process so far, in megabytes.
+*/
+double GetPeakMemoryMegabytes()
+{
+#ifdef GEE_OS_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0.0;
+	return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0.0;
+	return static_cast<double>(usage.ru_maxrss) / 1024.0;	// in kilobytes on Linux
+#endif
+}
+
+struct TimeStats
+{
+	double Mean = 0.0, P50 = 0.0, P99 = 0.0;
+
+	TimeStats() = default;
+	TimeStats(std::vector<double> times)	// nearest-rank percentiles
+	{
+		if (times.empty())
+			return;
+
+		std::sort(times.begin(), times.end());
+		for (double time : times)
+			Mean += time;
+		Mean /= static_cast<double>(times.size());
+
+		auto percentile = [&times](double p) { return times[std::min(times.size() - 1, static_cast<std::size_t>(std::ceil(p * static_cast<double>(times.size()))) - 1)]; };
+		P50 = percentile(0.5);
+		P99 = percentile(0.99);
+	}
+};
+
+struct ProjectResult
+{
+	std::string Project;
+	bool bLoaded = false;
+	double LoadTime = 0.0;
+	TimeStats Update, Render;
+	double DrawCallsPerFrame = 0.0;
+	double PeakMemory = 0.0;
+};
+
+/**
+ * @brief Renders only the main scene, to the default framebuffer, like a shipped game would.
+*/
+class BenchmarkRenderer : public GameRenderer
+{
+public:
+	BenchmarkRenderer(RenderEngineManager& renderHandle, RenderToolboxCollection& tbCollection) :
+		GameRenderer(renderHandle, nullptr),
+		TbCollection(tbCollection)
+	{
+	}
+	void RenderPass(GameScene* mainScene, GameScene*, GameScene*, GameScene*) override
+	{
+		PrepareFrame(mainScene);
+		if (!mainScene || !mainScene->GetActiveCamera())
+			return;
+
+		EnsureShadowMapCorectness(RenderingContextID(0), TbCollection, mainScene->GetRenderData());
+		SceneMatrixInfo renderInfo = mainScene->GetActiveCamera()->GetRenderInfo(0, TbCollection);
+		SceneRenderer(Impl.RenderHandle).FullRender(renderInfo, Viewport(Vec2f(0.0f)), true, false);
+	}
+
+private:
+	RenderToolboxCollection& TbCollection;
+};
+
+/**
+ * @brief Loads the projects one by one into the same game, because the physics engine can only be initialized once per process.
+ * Without a window, the game is headless (see Game::InitHeadless()) and nothing is rendered.
+*/
+class BenchmarkGame : public Game
+{
+public:
+	BenchmarkGame(const GameSettings& settings, SystemWindow* window) :
+		Game(settings.Video.Shading, settings),
+		TbCollection(nullptr),
+		bMeasuring(false)
+	{
+		Settings = MakeUnique<GameSettings>(settings);
+		if (window)
+		{
+			Init(window, Vec2u(Settings->Video.Resolution));
+			TbCollection = &RenderEng.AddRenderTbCollection(MakeUnique<RenderToolboxCollection>("GEE_Bench_Collection", Settings->Video, RenderEng));
+		}
+		else
+			InitHeadless();
+	}
+
+	ProjectResult RunProject(const std::string& path, unsigned int stepCount)
+	{
+		ProjectResult result;
+		result.Project = path;
+
+		result.LoadTime = MeasureMilliseconds([&]() {
+			result.bLoaded = LoadSceneFromFile(path, "GEE_Main");
+			if (!result.bLoaded)
+				return;
+
+			TreeLoader.FinishAll();	// trees loaded asynchronously are part of the load time
+			if (!GameManager::IsHeadless())
+				SceneRenderer(RenderEng).PreRenderLoopPassStatic(0, GetSceneRenderDatas());
+		});
+
+		if (!result.bLoaded)
+		{
+			std::cout << "ERROR: Cannot load project " << path << ".\n";
+			return result;
+		}
+
+		GameScene& scene = *GetScene("GEE_Main");
+		SetMainScene(&scene);
+		SetActiveScene(&scene);
+		scene.MarkAsStarted();
+
+		CameraComponent& camera = GetBenchmarkCamera(scene);
+		const Vec3f cameraStartPosition = camera.GetTransform().GetPos();
+		const Quatf cameraStartRotation = camera.GetTransform().GetRot();
+
+		UpdateTimes.clear();
+		RenderTimes.clear();
+		DrawCalls.clear();
+		UpdateTimes.reserve(stepCount);
+		RenderTimes.reserve(stepCount);
+		DrawCalls.reserve(stepCount);
+
+		const Time timeStep = 1.0 / 60.0;
+		bMeasuring = true;
+		for (unsigned int step = 0; step < stepCount; step++)
+		{
+			// The camera circles around its starting position and turns around once, so every part of the scene gets rendered.
+			const float angle = glm::two_pi<float>() * static_cast<float>(step) / static_cast<float>(stepCount);
+			camera.GetTransform().SetPosition(cameraStartPosition + Vec3f(std::cos(angle) - 1.0f, 0.0f, std::sin(angle)) * 2.0f);
+			camera.GetTransform().SetRotation(glm::angleAxis(angle, Vec3f(0.0f, 1.0f, 0.0f)) * cameraStartRotation);
+
+			if (GameLoopIteration(timeStep, timeStep))
+				break;
+		}
+		bMeasuring = false;
+
+		result.Update = TimeStats(UpdateTimes);
+		result.Render = TimeStats(RenderTimes);
+		if (!DrawCalls.empty())
+		{
+			for (unsigned int drawCallCount : DrawCalls)
+				result.DrawCallsPerFrame += static_cast<double>(drawCallCount);
+			result.DrawCallsPerFrame /= static_cast<double>(DrawCalls.size());
+		}
+		result.PeakMemory = GetPeakMemoryMegabytes();
+
+		SetActiveScene(nullptr);
+		SetMainScene(nullptr);
+		DeleteScene(scene);
+
+		return result;
+	}
+
+	void Update(Time deltaTime) override
+	{
+		const double updateTime = MeasureMilliseconds([&]() { Game::Update(deltaTime); });
+		if (bMeasuring)
+			UpdateTimes.push_back(updateTime);
+	}
+
+	void Render() override
+	{
+		const unsigned int drawCallsBefore = GpuProfiler::GetTotalStats().DrawCalls;
+		const double renderTime = MeasureMilliseconds([&]() {
+			BenchmarkRenderer(RenderEng, *TbCollection).RenderPass(GetMainScene(), nullptr, nullptr, nullptr);
+			glFinish();	// include the GPU work; the window is hidden, so the buffers are not swapped
+		});
+
+		if (bMeasuring)
+		{
+			RenderTimes.push_back(renderTime);
+			DrawCalls.push_back(GpuProfiler::GetTotalStats().DrawCalls - drawCallsBefore);
+		}
+	}
+
+private:
+	CameraComponent& GetBenchmarkCamera(GameScene& scene)
+	{
+		if (!scene.GetActiveCamera())
+		{
+			if (Actor* cameraActor = scene.FindActor("CameraActor"))
+				if (CameraComponent* camera = cameraActor->GetRoot()->GetComponent<CameraComponent>("Camera"))
+					scene.BindActiveCamera(camera);
+		}
+
+		if (!scene.GetActiveCamera())	// the camera is not saved with the project
+		{
+			const float aspectRatio = Settings->Video.Resolution.x / Settings->Video.Resolution.y;
+			scene.BindActiveCamera(&scene.GetRootActor()->GetRoot()->CreateComponent<CameraComponent>("GEE_Bench_Camera", glm::perspective(glm::radians(90.0f), aspectRatio, 0.01f, 100.0f)));
+		}
+
+		return *scene.GetActiveCamera();
+	}
+
+	RenderToolboxCollection* TbCollection;
+	bool bMeasuring;
+	std::vector<double> UpdateTimes, RenderTimes;
+	std::vector<unsigned int> DrawCalls;
+};
+
+/**
+ * @return the loose project files in the folder and the project files in its subfolders (Projects/Name/Name.json), without backups.
+*/
+std::vector<std::string> FindProjects(const std::string& projectsFolder)
+{
+	std::vector<std::string> projects;
+	if (!std::filesystem::is_directory(projectsFolder))
+		return projects;
+
+	for (const auto& entry : std::filesystem::directory_iterator(projectsFolder))
+	{
+		std::filesystem::path path = entry.path();
+		if (entry.is_directory())
+			path /= path.filename().string() + ".json";
+
+		if (std::filesystem::is_regular_file(path) && path.extension() == ".json" && path.filename().string().find("backup") == std::string::npos)
+			projects.push_back(path.generic_string());
+	}
+
+	std::sort(projects.begin(), projects.end());
+	return projects;
+}
+
+void WriteJsonString(std::ostream& stream, const std::string& str)
+{
+	stream << '"';
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			stream << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+			stream << ' ';
+		else
+			stream << c;
+	}
+	stream << '"';
+}
+
+void WriteReport(std::ostream& stream, const std::vector<ProjectResult>& results, unsigned int stepCount, const std::string& mode)
+{
+	stream << std::fixed << std::setprecision(4) << "{\n\"mode\": ";
+	WriteJsonString(stream, mode);
+	stream << ",\n\"steps\": " << stepCount << ",\n\"peak_memory_mb\": " << GetPeakMemoryMegabytes() << ",\n\"projects\": [";
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const ProjectResult& result = results[i];
+		stream << ((i == 0) ? ("") : (",")) << "\n{\"project\": ";
+		WriteJsonString(stream, result.Project);
+		stream << ", \"loaded\": " << ((result.bLoaded) ? ("true") : ("false"));
+		if (result.bLoaded)
+			stream << ", \"load_ms\": " << result.LoadTime <<
+				", \"update_mean_ms\": " << result.Update.Mean << ", \"update_p50_ms\": " << result.Update.P50 << ", \"update_p99_ms\": " << result.Update.P99 <<
+				", \"render_mean_ms\": " << result.Render.Mean << ", \"render_p50_ms\": " << result.Render.P50 << ", \"render_p99_ms\": " << result.Render.P99 <<
+				", \"draw_calls_per_frame\": " << result.DrawCallsPerFrame << ", \"peak_memory_mb\": " << result.PeakMemory;
+		stream << '}';
+	}
+	stream << "\n]\n}\n";
+}
+
+/**
+ * @brief Reads the numeric metrics of every project from a report written by WriteReport().
+ * @return the metrics of each project, by project name. Empty if the file could not be read.
+*/
+std::map<std::string, std::map<std::string, double>> ReadReport(const std::string& filepath)
+{
+	std::map<std::string, std::map<std::string, double>> projects;
+	std::ifstream file(filepath);
+	if (!file.good())
+	{
+		std::cerr << "ERROR: Cannot open report " << filepath << ".\n";
+		return projects;
+	}
+
+	std::stringstream content;
+	content << file.rdbuf();
+	const std::string str = content.str();
+
+	CEREAL_RAPIDJSON_NAMESPACE::Document report;
+	report.Parse(str.c_str(), str.size());
+	if (report.HasParseError() || !report.IsObject() || !report.HasMember("projects") || !report["projects"].IsArray())
+	{
+		std::cerr << "ERROR: " << filepath << " is not a gee_bench report.\n";
+		return projects;
+	}
+
+	// Every numeric member of a project object is a metric; the rest (e.g. "loaded") is skipped.
+	for (const auto& project : report["projects"].GetArray())
+	{
+		if (!project.IsObject() || !project.HasMember("project") || !project["project"].IsString())
+			continue;
+
+		std::map<std::string, double>& metrics = projects[project["project"].GetString()];
+		for (const auto& member : project.GetObject())
+			if (member.value.IsNumber())
+				metrics[member.name.GetString()] = member.value.GetDouble();
+	}
+
+	return projects;
+}
+
+int Compare(const std::string& baselinePath, const std::string& currentPath, double threshold)
+{
+	auto baseline = ReadReport(baselinePath), current = ReadReport(currentPath);
+	if (baseline.empty() || current.empty())
+		return 2;
+
+	unsigned int regressionCount = 0;
+	std::cout << std::fixed << std::setprecision(3) << "project\tmetric\tbaseline\tcurrent\tchange\n";
+	for (const auto& [project, currentMetrics] : current)
+	{
+		auto baselineProject = baseline.find(project);
+		if (baselineProject == baseline.end())
+		{
+			std::cout << project << "\t(not in the baseline)\n";
+			continue;
+		}
+
+		for (const char* metric : ComparedMetrics)
+		{
+			auto baselineValue = baselineProject->second.find(metric), currentValue = currentMetrics.find(metric);
+			if (baselineValue == baselineProject->second.end() || currentValue == currentMetrics.end() || baselineValue->second <= 0.0)	// a metric which was zero (e.g. render times of headless runs) has no meaningful relative change
+				continue;
+
+			const double change = (currentValue->second - baselineValue->second) / baselineValue->second * 100.0;
+			const bool bRegression = change > threshold;
+			if (bRegression)
+				regressionCount++;
+
+			std::cout << project << '\t' << metric << '\t' << baselineValue->second << '\t' << currentValue->second << '\t' << std::showpos << change << std::noshowpos << '%' << ((bRegression) ? ("\tREGRESSION") : ("")) << '\n';
+		}
+	}
+
+	for (const auto& baselineProject : baseline)
+		if (current.find(baselineProject.first) == current.end())
+			std::cout << baselineProject.first << "\t(missing from the current report)\n";
+
+	std::cout << regressionCount << " metrics got worse by more than " << threshold << "%.\n";
+	return (regressionCount > 0) ? (1) : (0);
+}
+
+int PrintUsage()
+{
+	std::cerr << "Usage: gee_bench run [--steps N] [--render | --software-gl] [--output report.json] [project files...]\n"
+				 "       gee_bench compare <baseline report> <current report> [threshold %]\n";
+	return 1;
+}
+
+int Run(int argc, char** argv)
+{
+	unsigned int stepCount = 600;
+	bool bRender = false, bSoftwareGL = false;
+	std::string outputPath;
+	std::vector<std::string> projects;
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--steps" || arg == "--output")	// options which take a value are never treated as project files
+		{
+			if (i + 1 >= argc || (arg == "--steps" && !CommandLine::ParseUnsigned(argv[i + 1], stepCount, 1)))
+				return PrintUsage();
+			if (arg == "--output")
+				outputPath = argv[i + 1];
+			i++;
+		}
+		else if (arg == "--render")
+			bRender = true;
+		else if (arg == "--software-gl")
+			bRender = bSoftwareGL = true;
+		else
+			projects.push_back(arg);
+	}
+
+	if (projects.empty())
+		projects = FindProjects("Projects");
+	if (projects.empty())
+	{
+		std::cerr << "ERROR: No projects to benchmark.\n";
+		return 1;
+	}
+
+	GameSettings settings;
+	settings.Video.bVSync = false;
+	SystemWindow* window = nullptr;
+	if (bRender)
+	{
+		if (bSoftwareGL)
+		{
+#ifdef GEE_OS_WINDOWS
+			std::cout << "WARNING: Software OpenGL is only selected automatically with Mesa; place Mesa's opengl32.dll next to the executable instead.\n";
+#else
+			setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);	// read by Mesa when the context is created
+#endif
+		}
+
+		glfwInit();
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, GEE_GL_VERSION_MAJOR);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, GEE_GL_VERSION_MINOR);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		window = glfwCreateWindow(static_cast<int>(settings.Video.Resolution.x), static_cast<int>(settings.Video.Resolution.y), "GEE Benchmark", nullptr, nullptr);
+		if (!window)
+		{
+			std::cerr << "CRITICAL ENGINE ERROR: Cannot create GLFW window. Please check that your system supports OpenGL " <<
+				GEE_GL_VERSION_MAJOR << "." << GEE_GL_VERSION_MINOR << ".\n";
+			return -1;
+		}
+
+		glfwMakeContextCurrent(window);
+		if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+		{
+			std::cerr << "CRITICAL ENGINE ERROR: Cannot load GL functions.";
+			return -1;
+		}
+	}
+
+	BenchmarkGame game(settings, window);
+	game.PreGameLoop();
+
+	std::vector<ProjectResult> results;
+	for (const std::string& project : projects)
+	{
+		results.push_back(game.RunProject(project, stepCount));
+		const ProjectResult& result = results.back();
+		if (result.bLoaded)
+			std::cout << std::fixed << std::setprecision(3) << "INFO: " << project << ": load " << result.LoadTime << " ms, update " << result.Update.Mean << " ms (p99 " << result.Update.P99 << " ms), render " << result.Render.Mean << " ms (p99 " << result.Render.P99 << " ms).\n";
+	}
+
+	const std::string mode = (bSoftwareGL) ? ("software-gl") : ((bRender) ? ("render") : ("headless"));
+	if (outputPath.empty())
+		WriteReport(std::cout, results, stepCount, mode);
+	else
+	{
+		std::ofstream file(outputPath);
+		WriteReport(file, results, stepCount, mode);
+		if (!file.good())
+		{
+			std::cerr << "ERROR: Cannot write the report to " << outputPath << ".\n";
+			return 1;
+		}
+		std::cout << "INFO: Wrote the report of " << results.size() << " projects to " << outputPath << ".\n";
+	}
+
+	if (window)
+		glfwTerminate();
+
+	// A project which fails to load is a regression too.
+	return (std::all_of(results.begin(), results.end(), [](const ProjectResult& result) { return result.bLoaded; })) ? (0) : (1);
+}
+
+int main(int argc, char** argv)
+{
+	const std::string mode = (argc > 1) ? (argv[1]) : (std::string());
+	if (mode == "run")
+		return Run(argc, argv);
+	if (mode == "compare" && argc >= 4)
+	{
+		double threshold = 10.0;
+		if (argc > 4 && !CommandLine::ParseDouble(argv[4], threshold))
+			return PrintUsage();
+		return Compare(argv[2], argv[3], threshold);
+	}
+
+	return PrintUsage();
+}
\ No newline at end of file
@@ -257,6 +257,12 @@ namespace GEE
 		}
 	}
 
+	Animation::Animation(const Hierarchy::Tree& tree, const String& name, Time duration) :
+		Localization(tree, name),
+		Duration(duration)
+	{
+	}
+
 	AnimationChannel::AnimationChannel(aiNodeAnim* aiChannel, double ticksPerSecond) :
 		Name(aiChannel->mNodeName.C_Str())
 	{
@@ -271,6 +277,10 @@ namespace GEE
 				static_cast<Time>(aiChannel->mScalingKeys[i].mTime / ticksPerSecond), aiToGlm(aiChannel->mScalingKeys[i].mValue))));
 	}
 
+	AnimationChannel::AnimationChannel(const String& name) :
+		Name(name)
+	{
+	}
 
 	Vec3f aiToGlm(const aiVector3D& aiVec)
 	{
@@ -143,6 +143,10 @@ namespace GEE
 		std::vector<SharedPtr<AnimationQuatKey>> RotKeys;
 		std::vector<SharedPtr<AnimationVecKey>> ScaleKeys;
 		AnimationChannel(aiNodeAnim*, double tickPerSecond);
+		/**
+		 * @brief Creates a channel without any keys.
+		*/
+		explicit AnimationChannel(const String& name);
 	};
 
 	struct Animation
@@ -156,6 +160,10 @@ namespace GEE
 		Time Duration;
 
 		Animation(const Hierarchy::Tree& tree, aiAnimation*);
+		/**
+		 * @brief Creates an animation without any channels.
+		*/
+		Animation(const Hierarchy::Tree& tree, const String& name, Time duration);
 	};
 
 	Vec3f aiToGlm(const aiVector3D&);
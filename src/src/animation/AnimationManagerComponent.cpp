@@ -184,6 +184,11 @@ namespace GEE
 		return Anim;
 	}
 
+	Component& AnimationInstance::GetAnimRootComp() const
+	{
+		return AnimRootComp;
+	}
+
 	bool AnimationInstance::HasFinished() const
 	{
 		return TimePassed > GetAnimation().Duration;
@@ -256,6 +261,8 @@ namespace GEE
 
 	template void AnimationInstance::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void AnimationInstance::load_and_construct<cereal::JSONInputArchive>(cereal::JSONInputArchive&, cereal::construct<AnimationInstance>&);
+	template void AnimationInstance::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void AnimationInstance::load_and_construct<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&, cereal::construct<AnimationInstance>&);
 
 	AnimationManagerComponent::AnimationManagerComponent(Actor& actor, Component* parentComp, const std::string& name) :
 		Component(actor, parentComp, name, Transform()),
@@ -281,6 +288,11 @@ namespace GEE
 		return CurrentAnim;
 	}
 
+	Component* AnimationManagerComponent::GetParallelUpdateExternalSubtree() const
+	{
+		return (CurrentAnim) ? (&CurrentAnim->GetAnimRootComp()) : (nullptr);
+	}
+
 	void AnimationManagerComponent::AddAnimationInstance(AnimationInstance&& animInstance)
 	{
 		AnimInstances.push_back(MakeUnique<AnimationInstance>(std::move(animInstance)));
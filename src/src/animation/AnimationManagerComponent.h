@@ -59,6 +59,7 @@ namespace GEE
 
 		Animation::AnimationLoc GetLocalization() const;
 		Animation& GetAnimation() const;
+		Component& GetAnimRootComp() const;
 		bool HasFinished() const;
 		void Update(Time);
 		void Stop();
@@ -83,6 +84,11 @@ namespace GEE
 		void AddAnimationInstance(AnimationInstance&&);
 
 		void Update(Time dt) override;
+		ComponentUpdatePhase GetUpdatePhase() const override { return ComponentUpdatePhase::Animation; }
+		/**
+		 * @return the root of the Components animated by the current animation, which are modified during the Animation phase.
+		*/
+		Component* GetParallelUpdateExternalSubtree() const override;
 		void SelectAnimation(AnimationInstance*);
 
 		void GetEditorDescription(ComponentDescriptionBuilder) override;
@@ -2,6 +2,7 @@
 #include <game/GameScene.h>
 #include <scene/BoneComponent.h>
 #include <scene/ModelComponent.h>
+#include <math/Simd.h>
 
 namespace GEE
 {
@@ -73,11 +74,21 @@ namespace GEE
 		//std::cout << "nr bones: " << Bones.size() << '\n';
 		//std::cout << "Bone ID Offset: " << BoneIDOffset << '\n';
 
-		for (int i = 0; i < static_cast<int>(Bones.size()); i++)
+		const std::size_t boneCount = Bones.size();
+		BoneWorldMatrices.resize(boneCount);
+		BoneOffsets.resize(boneCount);
+		for (std::size_t i = 0; i < boneCount; i++)
 		{
-			boneMats[Bones[i]->GetID() + BoneIDOffset] = globalInverseMat * Bones[i]->GetTransform().GetWorldTransformMatrix() * Bones[i]->BoneOffset;
-			//std::cout << Bones[i]->GetName() << " " << Bones[i]->GetID() + BoneIDOffset << '\n';
+			BoneWorldMatrices[i] = Bones[i]->GetTransform().GetWorldTransformMatrix();
+			BoneOffsets[i] = Bones[i]->BoneOffset;
 		}
+
+		// globalInverse * world * offset for every bone
+		Math::MultiplyMatrices(BoneWorldMatrices.data(), BoneOffsets.data(), BoneWorldMatrices.data(), boneCount);
+		Math::MultiplyMatrices(globalInverseMat, BoneWorldMatrices.data(), BoneWorldMatrices.data(), boneCount);
+
+		for (std::size_t i = 0; i < boneCount; i++)
+			boneMats[Bones[i]->GetID() + BoneIDOffset] = BoneWorldMatrices[i];
 	}
 
 	void SkeletonInfo::AddBone(BoneComponent& bone)
@@ -167,6 +178,8 @@ namespace GEE
 
 	template void SkeletonInfo::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void SkeletonInfo::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void SkeletonInfo::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void SkeletonInfo::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 
 	SkeletonInfo::~SkeletonInfo()
 	{
@@ -39,6 +39,7 @@ namespace GEE
 
 		unsigned int BoneIDOffset;
 
+		std::vector<Mat4f> BoneWorldMatrices, BoneOffsets;	// gathered by FillMatricesVec(), so the bone matrices are computed with batched calls; kept so their memory is reused
 	};
 
 	class SkeletonBatch
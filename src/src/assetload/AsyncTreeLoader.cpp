@@ -0,0 +1,285 @@
+#include <assetload/AsyncTreeLoader.h>
+#include <assetload/FileLoader.h>
+#include <assetload/MeshCache.h>
+#include <rendering/Material.h>
+#include <game/GameScene.h>
+#include <scene/hierarchy/HierarchyTree.h>
+#include <utility/Jobs.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <algorithm>
+#include <chrono>
+
+namespace GEE
+{
+	struct AsyncTreeLoader::Request
+	{
+		String Path;
+		GameScene* Scene;
+		bool bKeepVertsData;
+		std::vector<Callback> Callbacks;
+
+		LoadingState State = LoadingState::Reading;
+		float Progress = 0.0f;
+		Hierarchy::Tree* TargetTree = nullptr;	// created once the files have been read
+		Hierarchy::Tree* LoadedTree = nullptr;
+
+		// Written by the reading job; accessed by the main thread only once the job is finished.
+		JobHandle ReadJob;
+		UniquePtr<MeshCache::Contents> CachedContents;
+		UniquePtr<Assimp::Importer> Importer;
+		const aiScene* AssimpScene = nullptr;
+		MaterialLoadingData MatLoadingData;
+
+		UniquePtr<MeshCache::Instantiator> TreeInstantiator;
+	};
+
+	namespace
+	{
+		std::vector<String> GetTexturePaths(const MeshCache::Contents& contents)
+		{
+			std::vector<String> paths;
+			for (const auto& material : contents.Materials)
+				for (const auto& texture : material.Textures)
+					paths.push_back(texture.Path);
+
+			return paths;
+		}
+
+		/**
+		 * @return paths of the texture files used by the materials of the scene, in the form used by Material::LoadFromAiMaterial(). Embedded textures are skipped.
+		*/
+		std::vector<String> GetTexturePaths(const aiScene& scene, const String& directory)
+		{
+			std::vector<String> paths;
+			for (unsigned int i = 0; i < scene.mNumMaterials; i++)
+				for (int type = aiTextureType_NONE + 1; type <= AI_TEXTURE_TYPE_MAX; type++)
+					for (unsigned int j = 0; j < scene.mMaterials[i]->GetTextureCount(static_cast<aiTextureType>(type)); j++)
+					{
+						aiString path;
+						scene.mMaterials[i]->GetTexture(static_cast<aiTextureType>(type), j, &path);
+						if (path.length > 0 && path.C_Str()[0] != '*')
+							paths.push_back(directory + path.C_Str());
+					}
+
+			return paths;
+		}
+	}
+
+	AsyncTreeLoader::LoadingState AsyncTreeLoader::TreeFuture::GetState() const
+	{
+		return (LoadRequest) ? (LoadRequest->State) : (LoadingState::Failed);
+	}
+
+	bool AsyncTreeLoader::TreeFuture::IsReady() const
+	{
+		const LoadingState state = GetState();
+		return state == LoadingState::Loaded || state == LoadingState::Failed;
+	}
+
+	float AsyncTreeLoader::TreeFuture::GetProgress() const
+	{
+		return (LoadRequest) ? (LoadRequest->Progress) : (0.0f);
+	}
+
+	Hierarchy::Tree* AsyncTreeLoader::TreeFuture::GetTree() const
+	{
+		return (LoadRequest) ? (LoadRequest->LoadedTree) : (nullptr);
+	}
+
+	AsyncTreeLoader::AsyncTreeLoader() :
+		FrameBudget(0.004)
+	{
+	}
+
+	AsyncTreeLoader::TreeFuture AsyncTreeLoader::LoadAsync(GameScene& scene, const String& path, Callback onLoaded, bool keepVertsData)
+	{
+		auto found = std::find_if(Requests.begin(), Requests.end(), [&path](const SharedPtr<Request>& request) { return request->Path == path; });
+		if (found != Requests.end())
+		{
+			if (onLoaded)
+				(*found)->Callbacks.push_back(std::move(onLoaded));
+			return TreeFuture(*found);
+		}
+
+		SharedPtr<Request> request = MakeShared<Request>();
+		request->Path = path;
+		request->Scene = &scene;
+		request->bKeepVertsData = keepVertsData;
+		if (onLoaded)
+			request->Callbacks.push_back(std::move(onLoaded));
+
+		if (Hierarchy::Tree* loadedTree = scene.GetGameHandle()->FindHierarchyTree(path))
+		{
+			Complete(*request, loadedTree);
+			CallCallbacks(*request);
+			return TreeFuture(request);
+		}
+
+		EngineDataLoader::CreateAssimpLogger();
+		request->ReadJob = JobSystem::Get().Schedule([request]() { ReadFiles(*request); });
+		Requests.push_back(request);
+
+		return TreeFuture(request);
+	}
+
+	void AsyncTreeLoader::Update()
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		auto getElapsedTime = [startTime]() { return std::chrono::duration<Time>(std::chrono::steady_clock::now() - startTime).count(); };
+
+		// Requests are built in the order they were made; a request whose files are still being read does not hold back the following ones.
+		std::vector<SharedPtr<Request>> completedRequests;
+		for (auto it = Requests.begin(); it != Requests.end() && getElapsedTime() < FrameBudget;)
+		{
+			Request& request = **it;
+			if (request.State == LoadingState::Reading && !request.ReadJob.IsFinished())
+				++it;
+			else if (Advance(request))
+			{
+				completedRequests.push_back(*it);
+				it = Requests.erase(it);
+			}
+		}
+
+		// Callbacks are called last, because they may start loading other trees.
+		for (const auto& request : completedRequests)
+			CallCallbacks(*request);
+	}
+
+	void AsyncTreeLoader::Finish(const String& path)
+	{
+		auto found = std::find_if(Requests.begin(), Requests.end(), [&path](const SharedPtr<Request>& request) { return request->Path == path; });
+		if (found == Requests.end())
+			return;
+
+		SharedPtr<Request> request = *found;
+		Requests.erase(found);
+
+		request->ReadJob.Wait();
+		while (!Advance(*request))
+			continue;
+
+		CallCallbacks(*request);
+	}
+
+	void AsyncTreeLoader::FinishAll()
+	{
+		while (!Requests.empty())
+			Finish(Requests.front()->Path);
+	}
+
+	void AsyncTreeLoader::CancelScene(GameScene& scene)
+	{
+		// The reading jobs keep their requests alive, so they do not have to be waited for.
+		Requests.erase(std::remove_if(Requests.begin(), Requests.end(), [&scene](const SharedPtr<Request>& request) { return request->Scene == &scene; }), Requests.end());
+	}
+
+	void AsyncTreeLoader::ReadFiles(Request& request)
+	{
+		std::vector<String> texturePaths;
+		if ((request.CachedContents = MeshCache::Open(request.Path, EngineDataLoader::AssimpImportFlags)))
+			texturePaths = GetTexturePaths(*request.CachedContents);
+		else
+		{
+			request.Importer = MakeUnique<Assimp::Importer>();
+			request.AssimpScene = EngineDataLoader::ReadAssimpScene(*request.Importer, request.Path);
+			if (!request.AssimpScene)
+				return;
+
+			texturePaths = GetTexturePaths(*request.AssimpScene, extractDirectory(request.Path));
+		}
+
+		std::sort(texturePaths.begin(), texturePaths.end());
+		texturePaths.erase(std::unique(texturePaths.begin(), texturePaths.end()), texturePaths.end());
+
+		std::vector<Texture::DecodedImage> images(texturePaths.size());
+		JobSystem::Get().ParallelFor(texturePaths.size(), 1, [&texturePaths, &images](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+				images[i] = Texture::Loader<unsigned char>::DecodeFile2D(texturePaths[i]);
+		}).Wait();
+
+		// Images which could not be decoded are kept too, so the main thread does not try to read them again.
+		for (std::size_t i = 0; i < texturePaths.size(); i++)
+			request.MatLoadingData.DecodedImages.emplace(texturePaths[i], std::move(images[i]));
+	}
+
+	bool AsyncTreeLoader::Advance(Request& request)
+	{
+		switch (request.State)
+		{
+		case LoadingState::Reading:
+		{
+			GameManager& gameHandle = *request.Scene->GetGameHandle();
+			if (Hierarchy::Tree* loadedTree = gameHandle.FindHierarchyTree(request.Path))
+			{
+				Complete(request, loadedTree);	// loaded by someone else in the meantime
+				return true;
+			}
+
+			if (!request.CachedContents && !request.AssimpScene)
+			{
+				Complete(request, nullptr);
+				return true;
+			}
+
+			request.TargetTree = &request.Scene->CreateHierarchyTree(request.Path);
+			Hierarchy::Tree& tree = *request.TargetTree;
+			if (request.CachedContents)
+			{
+				request.TreeInstantiator = MakeUnique<MeshCache::Instantiator>(*request.CachedContents, tree, request.MatLoadingData, request.bKeepVertsData);
+				request.State = LoadingState::Instantiating;
+				return false;
+			}
+
+			// Assimp scenes are converted in a single step. The next load of this file will use the mesh cache, which is built in small steps.
+			EngineDataLoader::ImportHierarchyTree(gameHandle, request.AssimpScene, request.Path, tree, request.MatLoadingData, true);
+			MeshCache::Write(tree, request.Path, EngineDataLoader::AssimpImportFlags);
+			if (!request.bKeepVertsData)
+				tree.RemoveVertsData();
+
+			Complete(request, &tree);
+			return true;
+		}
+		case LoadingState::Instantiating:
+		{
+			const bool bFinished = request.TreeInstantiator->Step();
+			request.Progress = request.TreeInstantiator->GetProgress();
+			if (bFinished)
+				Complete(request, request.TargetTree);
+
+			return bFinished;
+		}
+		default:
+			return true;
+		}
+	}
+
+	void AsyncTreeLoader::Complete(Request& request, Hierarchy::Tree* loadedTree)
+	{
+		if (loadedTree)
+			EngineDataLoader::RegisterLoadedMaterials(*request.Scene->GetGameHandle()->GetRenderEngineHandle(), request.MatLoadingData);
+
+		request.State = (loadedTree) ? (LoadingState::Loaded) : (LoadingState::Failed);
+		request.Progress = 1.0f;
+		request.LoadedTree = loadedTree;
+		if (!loadedTree)
+			std::cout << "ERROR: Cannot load tree " << request.Path << " asynchronously.\n";
+
+		// Release the file data; only the state is needed by futures from now on.
+		request.TreeInstantiator = nullptr;
+		request.CachedContents = nullptr;
+		request.AssimpScene = nullptr;
+		request.Importer = nullptr;
+		request.MatLoadingData = MaterialLoadingData();
+	}
+
+	void AsyncTreeLoader::CallCallbacks(Request& request)
+	{
+		std::vector<Callback> callbacks = std::move(request.Callbacks);
+		request.Callbacks.clear();
+		for (const Callback& callback : callbacks)
+			callback(request.LoadedTree);
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <utility/Utility.h>
+#include <functional>
+#include <deque>
+
+namespace GEE
+{
+	class GameScene;
+	namespace Hierarchy
+	{
+		class Tree;
+	}
+
+	/**
+	 * @brief Loads Hierarchy::Trees from files without blocking the game loop.
+	 * Reading the file (the mesh cache or an Assimp import, including vertex processing and tangent generation) and decoding the textures is done by the job system.
+	 * Everything that needs the OpenGL context or modifies a scene (creating the tree, uploading meshes and textures) is done on the main thread by Update(), within a time budget per frame.
+	 * All methods must be called on the main thread.
+	*/
+	class AsyncTreeLoader
+	{
+		struct Request;
+	public:
+		enum class LoadingState
+		{
+			Reading,	// the file is being read by worker threads
+			Instantiating,	// the tree is being built on the main thread
+			Loaded,
+			Failed
+		};
+		/**
+		 * @brief Called on the main thread once the tree is loaded, with nullptr if it could not be loaded.
+		*/
+		using Callback = std::function<void(Hierarchy::Tree*)>;
+
+		/**
+		 * @brief Refers to the result of LoadAsync(). Cheap to copy. Can be polled every frame to show the loading state.
+		*/
+		class TreeFuture
+		{
+		public:
+			TreeFuture() = default;
+
+			bool IsValid() const { return LoadRequest != nullptr; }
+			LoadingState GetState() const;
+			/**
+			 * @return true if the tree is loaded or could not be loaded.
+			*/
+			bool IsReady() const;
+			/**
+			 * @return an approximate fraction of the work which has been done, from 0 to 1.
+			*/
+			float GetProgress() const;
+			/**
+			 * @return the loaded tree or nullptr if it is not loaded (yet).
+			*/
+			Hierarchy::Tree* GetTree() const;
+
+		private:
+			TreeFuture(SharedPtr<Request> request) : LoadRequest(std::move(request)) {}
+			SharedPtr<Request> LoadRequest;
+			friend class AsyncTreeLoader;
+		};
+
+		AsyncTreeLoader();
+
+		/**
+		 * @brief Starts loading the tree from the given file into the scene. If the tree is already being loaded, the returned future refers to the same request.
+		 * If the tree has already been loaded, the callback is called immediately.
+		 * @param keepVertsData: see EngineDataLoader::LoadHierarchyTree().
+		*/
+		TreeFuture LoadAsync(GameScene&, const String& path, Callback onLoaded = nullptr, bool keepVertsData = true);
+
+		/**
+		 * @brief Builds the trees whose files have been read, spending at most about the frame budget. Called by the game loop once per frame.
+		*/
+		void Update();
+		/**
+		 * @brief Blocks until the tree from the given file is loaded, if it is being loaded. Used by synchronous loading, so it never creates a duplicate of a tree that is being loaded asynchronously.
+		*/
+		void Finish(const String& path);
+		void FinishAll();
+		/**
+		 * @brief Drops all requests which load trees into the given scene (e.g. because the scene is being deleted). Their callbacks are not called.
+		*/
+		void CancelScene(GameScene&);
+
+		bool IsIdle() const { return Requests.empty(); }
+		unsigned int GetPendingCount() const { return static_cast<unsigned int>(Requests.size()); }
+
+		Time GetFrameBudget() const { return FrameBudget; }
+		/**
+		 * @brief Sets the time (in seconds) which Update() can spend building trees in a single frame. A single step (e.g. uploading a large mesh) can exceed it.
+		*/
+		void SetFrameBudget(Time budget) { FrameBudget = budget; }
+
+	private:
+		static void ReadFiles(Request&);
+		/**
+		 * @brief Performs the next piece of main thread work of the request.
+		 * @return true if the request is complete.
+		*/
+		static bool Advance(Request&);
+		static void Complete(Request&, Hierarchy::Tree* loadedTree);
+		static void CallCallbacks(Request&);
+
+		std::deque<SharedPtr<Request>> Requests;
+		Time FrameBudget;
+	};
+}
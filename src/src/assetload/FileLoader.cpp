@@ -17,6 +17,9 @@
 #include <scene/hierarchy/HierarchyNode.h>
 #include <scene/hierarchy/HierarchyNodeInstantiation.h>
 #include <assetload/FileLoader.h>
+#include <assetload/MeshCache.h>
+#include <assetload/AsyncTreeLoader.h>
+#include <assetload/SceneFile.h>
 #include <rendering/Texture.h>
 #include <rendering/LightProbe.h>
 #include <scene/SoundSourceComponent.h>
@@ -26,8 +29,10 @@
 #include <game/GameScene.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include <cctype>
 #include <functional>
 #include <fstream>
+#include <filesystem>
 
 #include <editor/EditorManager.h>
 #include <editor/GEditorSettings.h>
@@ -37,6 +42,7 @@ namespace GEE
 {
 	FT_Library* EngineDataLoader::FTLib = nullptr;
 	auto assimpDebugStream = Assimp::LogStream::createDefaultStream(aiDefaultLogStream::aiDefaultLogStream_STDOUT);
+	const unsigned int EngineDataLoader::AssimpImportFlags = aiProcess_GenUVCoords | aiProcess_TransformUVCoords | aiProcess_OptimizeMeshes | aiProcess_SplitLargeMeshes | aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices | aiProcess_ValidateDataStructure;
 
 
 	void EngineDataLoader::LoadMaterials(RenderEngineManager* renderHandle, std::string path, std::string directory)
@@ -528,15 +534,7 @@ namespace GEE
 			}
 
 			
-			SharedPtr<Material> material = nullptr;
-			
-			std::string materialNameStr = materialName.C_Str();
-			if (materialNameStr.size() > 6 && materialNameStr.substr(materialNameStr.size() - 6) == "_atlas")
-			{
-				material = std::static_pointer_cast<Material>(MakeShared<AtlasMaterial>(Material::MaterialLoc(treeObjLoc, materialNameStr), glm::ivec2(4, 2)));	//TODO: remove this ivec2(4, 2)
-			}
-			else
-				material = MakeShared<Material>(Material::MaterialLoc(treeObjLoc, materialNameStr));	//we name all materials "undefined" by default; their name should be contained in the files
+			SharedPtr<Material> material = MaterialUtil::MakeImportedMaterial(Material::MaterialLoc(treeObjLoc, materialName.C_Str()));
 
 			material->LoadFromAiMaterial(scene, assimpMaterial, directory, matLoadingData);
 
@@ -825,10 +823,84 @@ namespace GEE
 		}
 	}
 
+	template <typename Archive>
+	void EngineDataLoader::LoadSceneFromArchive(Archive& archive, GameScene& scene, Editor::GEditorSettings& editorSettings)
+	{
+		// Everything is read in the order it is saved by SceneFile::Save() and GameScene::Save(), since binary archives cannot look values up by name.
+		try
+		{
+			archive(cereal::make_nvp("GEditorSettings", editorSettings));
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "INFO: No GEditor settings found: " << exception.what() << '\n';
+		}
+
+		try
+		{
+			GEE::CerealActorSerializationData::ScenePtr = &scene;
+			scene.GetRenderData()->LoadSkeletonBatches(archive);
+			CerealTreeSerializationData::TreeScene = &scene;
+
+			{
+				std::vector<UniquePtr<Hierarchy::Tree>> localHierarchyTrees;
+				archive(cereal::make_nvp("HierarchyTrees", localHierarchyTrees));
+				CerealTreeSerializationData::TreeScene = nullptr;
+
+				std::cout << "Loaded " << localHierarchyTrees.size() << " trees.\n";
+				for (auto& smartPtr : localHierarchyTrees)
+					scene.HierarchyTrees.push_back(UniquePtr<Hierarchy::Tree>(smartPtr.release()));
+			}
+
+			LightProbeLoader::LoadLightProbeTextureArrays(scene.GetRenderData());
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: While loading skel batches and hierarchy trees: " << exception.what() << '\n';
+		}
+
+		try
+		{
+			scene.GetRootActor()->Load(archive);
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: While loading scene actors and components: " << exception.what() << '\n';
+		}
+
+		try
+		{
+			scene.GetGameHandle()->GetGameSettings()->Serialize(archive);
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: While loading game settings: " << exception.what() << '\n';
+		}
+
+
+		try
+		{
+			archive.serializeDeferments();
+		}
+		catch (Exception& exception)
+		{
+			std::cout << "ERROR: While loading deferments: " << exception.what() << '\n';
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: While loading deferments: " << exception.what() << '\n';
+		}
+
+		scene.Load(archive);
+
+		scene.GetRootActor()->DebugHierarchy();
+	}
+
 	bool EngineDataLoader::SetupSceneFromFile(GameManager* gameHandle, const std::string& filepath, const std::string& name)
 	{	
+		const SceneFileFormat format = SceneFile::GetFormat(filepath);
 		GameScene& scene = gameHandle->CreateScene((name.empty()) ? (filepath) : (name));
-		std::ifstream file(filepath);
+		std::ifstream file(filepath, (format == SceneFileFormat::Binary) ? (std::ios::in | std::ios::binary) : (std::ios::in));
 		std::string fileExtension = getFilepathExtension(filepath);
 		std::stringstream filestr;
 
@@ -840,82 +912,45 @@ namespace GEE
 
 		if (fileExtension != ".geeprojectold")
 		{
-			std::cout << "Serializing...\n";
+			std::cout << "Serializing " << filepath << "...\n";
 			GameManager::DefaultScene = &scene;
+			bool bLoaded = true;
 			if (filestr.good())
 			{
-				cereal::JSONInputArchive archive(filestr);
-				try
-				{
-					GEE::CerealActorSerializationData::ScenePtr = &scene;
-					scene.GetRenderData()->LoadSkeletonBatches(archive);
-					CerealTreeSerializationData::TreeScene = &scene;
+				// Games do not have editor settings, but they still have to be read to reach the rest of the file.
+				Editor::GEditorSettings defaultEditorSettings;
+				Editor::EditorManager* editorHandle = dynamic_cast<Editor::EditorManager*>(gameHandle);
+				Editor::GEditorSettings& editorSettings = (editorHandle) ? (*editorHandle->GetEditorSettings()) : (defaultEditorSettings);
 
-					auto& geditorSettings = *dynamic_cast<Editor::EditorManager*>(gameHandle)->GetEditorSettings();
+				if (format == SceneFileFormat::Binary)
+				{
 					try
 					{
-						archive(cereal::make_nvp("GEditorSettings", geditorSettings));
+						cereal::PortableBinaryInputArchive archive(filestr);
+						std::vector<std::string> treePaths;
+						if ((bLoaded = SceneFile::ReadBinaryHeader(archive, treePaths)))
+						{
+							PrefetchHierarchyTrees(scene, treePaths);
+							LoadSceneFromArchive(archive, scene, editorSettings);
+						}
 					}
 					catch (cereal::Exception& exception)
 					{
-						std::cout << "INFO: No GEditor settings found: " << exception.what() << '\n';
+						std::cout << "ERROR: While reading " << filepath << ": " << exception.what() << '\n';
+						bLoaded = false;
 					}
-
-					{
-						std::vector<UniquePtr<Hierarchy::Tree>> localHierarchyTrees;
-						archive(cereal::make_nvp("HierarchyTrees", localHierarchyTrees));
-						CerealTreeSerializationData::TreeScene = nullptr;
-
-						std::cout << "Loaded " << localHierarchyTrees.size() << " trees.\n";
-						for (auto& smartPtr : localHierarchyTrees)
-							scene.HierarchyTrees.push_back(UniquePtr<Hierarchy::Tree>(smartPtr.release()));
-					}
-
-					LightProbeLoader::LoadLightProbeTextureArrays(scene.GetRenderData());
-				}
-				catch (cereal::Exception& exception)
-				{
-					std::cout << "ERROR: While loading skel batches and hierarchy trees: " << exception.what() << '\n';
-				}
-
-
-				try
-				{
-					scene.GetRootActor()->Load(archive);
-				}
-				catch (cereal::Exception& exception)
-				{
-					std::cout << "ERROR: While loading scene actors and components: " << exception.what() << '\n';
 				}
-
-				try
-				{
-					gameHandle->GetGameSettings()->Serialize(archive);
-				}
-				catch (cereal::Exception& exception)
-				{
-					std::cout << "ERROR: While loading game settings: " << exception.what() << '\n';
-				}
-
-
-				try
-				{
-					archive.serializeDeferments();
-				}
-				catch (Exception& exception)
-				{
-					std::cout << "ERROR: While loading deferments: " << exception.what() << '\n';
-				}
-				catch (cereal::Exception& exception)
+				else
 				{
-					std::cout << "ERROR: While loading deferments: " << exception.what() << '\n';
+					// Start reading the trees before the whole document is parsed.
+					PrefetchHierarchyTrees(scene, filestr.str());
+					cereal::JSONInputArchive archive(filestr);
+					LoadSceneFromArchive(archive, scene, editorSettings);
 				}
-
-				scene.Load(archive);
-
-				scene.GetRootActor()->DebugHierarchy();
 			}
 			GameManager::DefaultScene = nullptr;
+			if (!bLoaded)
+				return false;
 		}
 		else
 		{
@@ -1006,6 +1041,45 @@ namespace GEE
 		return true;
 	}
 
+	void EngineDataLoader::PrefetchHierarchyTrees(GameScene& scene, const std::string& projectJson)
+	{
+		// Only the key is searched for; any whitespace cereal puts around the colon is skipped.
+		const std::string key = "\"MeshTreePath\"";	// see MeshInstance::Save()
+		std::vector<std::string> treePaths;
+		auto skipWhitespace = [&projectJson](std::size_t pos) { while (pos < projectJson.size() && std::isspace(static_cast<unsigned char>(projectJson[pos]))) pos++; return pos; };
+
+		for (std::size_t keyPos = projectJson.find(key); keyPos != std::string::npos; keyPos = projectJson.find(key, keyPos + key.size()))
+		{
+			std::size_t valuePos = skipWhitespace(keyPos + key.size());
+			if (valuePos >= projectJson.size() || projectJson[valuePos] != ':')
+				continue;	// the text is a value, not a key
+			valuePos = skipWhitespace(valuePos + 1);
+			if (valuePos >= projectJson.size() || projectJson[valuePos] != '"')
+				continue;
+
+			std::string path;
+			for (std::size_t i = valuePos + 1; i < projectJson.size() && projectJson[i] != '"'; i++)
+			{
+				if (projectJson[i] == '\\' && i + 1 < projectJson.size())
+					i++;	// skip the escape character (e.g. in Windows paths)
+				path += projectJson[i];
+			}
+
+			treePaths.push_back(path);
+		}
+
+		PrefetchHierarchyTrees(scene, treePaths);
+	}
+
+	void EngineDataLoader::PrefetchHierarchyTrees(GameScene& scene, const std::vector<std::string>& treePaths)
+	{
+		AsyncTreeLoader& treeLoader = scene.GetGameHandle()->GetTreeLoader();
+		for (const std::string& path : treePaths)
+			// Trees which do not come from files (e.g. the engine's basic shapes) are already loaded and are skipped by the loader.
+			if (!path.empty() && std::filesystem::exists(path))
+				treeLoader.LoadAsync(scene, path);
+	}
+
 	void EngineDataLoader::LoadModel(std::string path, Component& comp, MeshTreeInstancingType type, Material* overrideMaterial)
 	{
 		auto& tree = *LoadHierarchyTree(comp.GetScene(), path);
@@ -1026,26 +1100,61 @@ namespace GEE
 
 		RenderEngineManager& renderHandle = *gameHandle.GetRenderEngineHandle();
 
+		// If the tree is being loaded asynchronously, finish loading it now.
+		gameHandle.GetTreeLoader().Finish(path);
+
 		if (Hierarchy::Tree* found = gameHandle.FindHierarchyTree(path, treePtr))
 		{
 			if (PrimitiveDebugger::bDebugMeshTrees)
 				std::cout << "Found " << path << ".\n";
 			return found;
 		}
-		if (!treePtr)
-			treePtr = &scene.CreateHierarchyTree(path);
 
+		MaterialLoadingData matLoadingData;
+		if (UniquePtr<MeshCache::Contents> cachedTree = MeshCache::Open(path, AssimpImportFlags))
+		{
+			if (!treePtr)
+				treePtr = &scene.CreateHierarchyTree(path);
+
+			MeshCache::Instantiate(*cachedTree, *treePtr, matLoadingData, keepVertsData);
+			std::cout << "Loaded tree (" << path << ") from the mesh cache.\n";
+		}
+		else
+		{
+			CreateAssimpLogger();
+			Assimp::Importer importer;
+			const aiScene* assimpScene = ReadAssimpScene(importer, path);
+			if (!assimpScene)
+				return nullptr;
+
+			if (!treePtr)
+				treePtr = &scene.CreateHierarchyTree(path);
+
+			// Vertex data has to be kept until the tree is written to the mesh cache.
+			ImportHierarchyTree(gameHandle, assimpScene, path, *treePtr, matLoadingData, true);
+
+			MeshCache::Write(*treePtr, path, AssimpImportFlags);
+			if (!keepVertsData)
+				treePtr->RemoveVertsData();
+		}
+
+		RegisterLoadedMaterials(renderHandle, matLoadingData);
+
+		return treePtr;
+	}
+
+	void EngineDataLoader::CreateAssimpLogger()
+	{
 		if (Assimp::DefaultLogger::isNullLogger())
 		{
 			auto log = Assimp::DefaultLogger::create();
 			log->attachStream(assimpDebugStream);
 		}
+	}
 
-		Assimp::Importer importer;
-		const aiScene* assimpScene;
-		MaterialLoadingData matLoadingData;
-
-		assimpScene = importer.ReadFile(path, aiProcess_GenUVCoords | aiProcess_TransformUVCoords | aiProcess_OptimizeMeshes | aiProcess_SplitLargeMeshes | aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices | aiProcess_ValidateDataStructure);
+	const aiScene* EngineDataLoader::ReadAssimpScene(Assimp::Importer& importer, const std::string& path)
+	{
+		const aiScene* assimpScene = importer.ReadFile(path, AssimpImportFlags);
 		if (!assimpScene || assimpScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !assimpScene->mRootNode)
 		{
 			std::cerr << "Can't load mesh scene " << path << ".\n";
@@ -1056,32 +1165,39 @@ namespace GEE
 		if (assimpScene->mFlags & AI_SCENE_FLAGS_VALIDATION_WARNING)
 			std::cout << "WARNING! A validation problem occured while loading MeshTree " + path + "\n";
 
-		 
+		return assimpScene;
+	}
+
+	void EngineDataLoader::ImportHierarchyTree(GameManager& gameHandle, const aiScene* assimpScene, const std::string& path, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData)
+	{
 		std::string directory = extractDirectory(path);
 		std::vector<ModelComponent*> modelsPtr;
 
-		std::cout << "Loaded tree (" << path << ") root: " << &treePtr->GetRoot() << '\n';
+		std::cout << "Loaded tree (" << path << ") root: " << &tree.GetRoot() << '\n';
 
 		{
-			treePtr->ResetBoneMapping(false);	// first, clear the bone mapping
+			tree.ResetBoneMapping(false);	// first, clear the bone mapping
 
 			for (int i = 0; i < static_cast<int>(assimpScene->mNumMeshes); i++)
 				if (assimpScene->mMeshes[i]->HasBones())
 				{
-					treePtr->ResetBoneMapping(true);	// if there are bones, create a new bone mapping
+					tree.ResetBoneMapping(true);	// if there are bones, create a new bone mapping
 					break;
 				}
 		}
 
-		LoadHierarchyNodeFromAi(gameHandle, assimpScene, directory, &matLoadingData, *treePtr, (assimpScene->mRootNode->mNumMeshes > 0) ? (treePtr->GetRoot().CreateChild<ModelComponent>(treePtr->GetRoot().GetCompBaseType().GetName() + "RootMeshes")) : (treePtr->GetRoot()), assimpScene->mRootNode, treePtr->GetBoneMapping(), nullptr, Transform(), keepVertsData);
+		LoadHierarchyNodeFromAi(gameHandle, assimpScene, directory, &matLoadingData, tree, (assimpScene->mRootNode->mNumMeshes > 0) ? (tree.GetRoot().CreateChild<ModelComponent>(tree.GetRoot().GetCompBaseType().GetName() + "RootMeshes")) : (tree.GetRoot()), assimpScene->mRootNode, tree.GetBoneMapping(), nullptr, Transform(), keepVertsData);
 
 		for (int i = 0; i < static_cast<int>(assimpScene->mNumAnimations); i++)
 		{
-			treePtr->AddAnimation(Animation(*treePtr, assimpScene->mAnimations[i]));
+			tree.AddAnimation(Animation(tree, assimpScene->mAnimations[i]));
 			int animIndex = assimpScene->mNumAnimations - 1;
 			std::cout << assimpScene->mAnimations[animIndex]->mDuration / assimpScene->mAnimations[animIndex]->mTicksPerSecond << "<- czas; " << assimpScene->mAnimations[animIndex]->mTicksPerSecond << "<- tps\n";
 		}
+	}
 
+	void EngineDataLoader::RegisterLoadedMaterials(RenderEngineManager& renderHandle, const MaterialLoadingData& matLoadingData)
+	{
 		for (int j = 0; j < static_cast<int>(matLoadingData.LoadedMaterials.size()); j++)
 			renderHandle.AddMaterial(matLoadingData.LoadedMaterials[j]);
 
@@ -1089,8 +1205,6 @@ namespace GEE
 			//if (matLoadingData.LoadedMaterials[i]->GetRenderShaderName().empty())
 			//	matLoadingData.LoadedMaterials[i]->SetRenderShaderName("Geometry");
 			matLoadingData.LoadedMaterials[i]->SetShaderInfo(MaterialShaderHint::Shaded);
-
-		return treePtr;
 	}
 
 	SharedPtr<Font> EngineDataLoader::LoadFont(GameManager& gameHandle, const std::string& regularPath, const std::string& boldPath, const std::string& italicPath, const std::string& boldItalicPath)
@@ -9,6 +9,10 @@ struct aiScene;
 struct aiNode;
 struct aiMesh;
 struct aiBone;
+namespace Assimp
+{
+	class Importer;
+}
 
 namespace GEE
 {
@@ -24,6 +28,10 @@ namespace GEE
 		struct CollisionShape;
 	}
 	class Font;
+	namespace Editor
+	{
+		struct GEditorSettings;
+	}
 
 	enum MeshTreeInstancingType
 	{
@@ -53,12 +61,39 @@ namespace GEE
 		static UniquePtr<Physics::CollisionObject> LoadCollisionObject(GameScene& scene, std::stringstream&);
 		static SharedPtr<Physics::CollisionShape> LoadTriangleMeshCollisionShape(Physics::PhysicsEngineManager* physicsHandle, const aiScene* scene, aiMesh&);
 		static void LoadLightProbes(GameScene&, std::stringstream&);
+		/**
+		 * @brief Starts loading all the tree files referenced by the mesh instances of a serialized project with the AsyncTreeLoader, so they are read in parallel before the actors which use them are loaded.
+		*/
+		static void PrefetchHierarchyTrees(GameScene&, const std::string& projectJson);
+		static void PrefetchHierarchyTrees(GameScene&, const std::vector<std::string>& treePaths);
+		/**
+		 * @brief Reads a project saved by SceneFile::Save() into the scene. Used for both JSON and binary archives.
+		*/
+		template <typename Archive> static void LoadSceneFromArchive(Archive&, GameScene&, Editor::GEditorSettings&);
 
 		static void LoadMeshFromAi(Mesh* meshPtr, const aiScene* scene, const aiMesh* mesh, const HTreeObjectLoc& treeObjLoc, const std::string& directory = std::string(), bool bLoadMaterial = true, MaterialLoadingData* matLoadingData = nullptr, BoneMapping* = nullptr, bool keepVertsData = false);
 
 		static void LoadTransform(std::stringstream&, Transform&);
 		static void LoadTransform(std::stringstream&, Transform&, std::string loadType);
 
+		/**
+		 * @brief Creates the Assimp logger if it does not exist yet. Must be called before any file is read with Assimp, from a single thread.
+		*/
+		static void CreateAssimpLogger();
+		/**
+		 * @brief Reads a file with Assimp, without touching OpenGL or any scene. Can be called by any thread, as long as each thread uses its own importer.
+		 * @return the imported scene, owned by the importer, or nullptr if the file could not be read.
+		*/
+		static const aiScene* ReadAssimpScene(Assimp::Importer&, const std::string& path);
+		/**
+		 * @brief Imports a tree from a scene read with ReadAssimpScene().
+		*/
+		static void ImportHierarchyTree(GameManager&, const aiScene*, const std::string& path, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData);
+		/**
+		 * @brief Adds the materials of a loaded tree to the render engine.
+		*/
+		static void RegisterLoadedMaterials(RenderEngineManager&, const MaterialLoadingData&);
+
 		static Hierarchy::Tree* LoadCustomHierarchyTree(GameScene& scene, std::stringstream& filestr, bool loadPath = false);
 
 		static void LoadCustomHierarchyNode(GameScene&, std::stringstream&, Hierarchy::NodeBase* parent = nullptr, Hierarchy::Tree* treeToEdit = nullptr);
@@ -68,6 +103,9 @@ namespace GEE
 		static void LoadComponentsFromHierarchyTree(Component& comp, const Hierarchy::Tree&, const Hierarchy::NodeBase&, SkeletonInfo& skeletonInfo, const std::vector<Hierarchy::NodeBase*>& selectedComponents = {}, Material* overrideMaterial = nullptr);
 
 		static FT_Library* FTLib;
+		static const unsigned int AssimpImportFlags;
+
+		friend class AsyncTreeLoader;
 	};
 
 	aiBone* CastAiNodeToBone(const aiScene* scene, aiNode* node, const aiMesh** ownerMesh = nullptr);
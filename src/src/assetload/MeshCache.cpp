@@ -0,0 +1,737 @@
+#include <assetload/MeshCache.h>
+#include <assetload/FileLoader.h>
+#include <rendering/Mesh.h>
+#include <rendering/Texture.h>
+#include <animation/Animation.h>
+#include <scene/hierarchy/HierarchyTree.h>
+#include <scene/hierarchy/HierarchyNode.h>
+#include <scene/BoneComponent.h>
+#include <scene/ModelComponent.h>
+#include <game/GameScene.h>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace GEE
+{
+	namespace
+	{
+		constexpr std::uint32_t CacheFileMagic = 0x4D454547;	// "GEEM"
+		constexpr std::uint32_t CacheFileVersion = 1;
+		constexpr std::size_t ArrayAlignment = 16;	// vertex and index arrays are aligned, so they can be read straight from the mapped file
+
+		struct CacheFileHeader
+		{
+			std::uint32_t Magic;
+			std::uint32_t Version;
+			std::uint32_t VertexSize;
+			std::uint32_t ImportFlags;
+			std::uint64_t SourceSize;
+			std::uint64_t SourceHash;
+		};
+
+		bool GetSourceIdentity(const String& sourcePath, std::uint64_t& size, std::uint64_t& hash)
+		{
+			MappedFile source;
+			if (!source.Open(sourcePath))
+				return false;
+
+			// FNV-1a
+			hash = 14695981039346656037ull;
+			for (std::size_t i = 0; i < source.GetSize(); i++)
+			{
+				hash ^= source.GetData()[i];
+				hash *= 1099511628211ull;
+			}
+			size = source.GetSize();
+
+			return true;
+		}
+
+		class BinaryWriter
+		{
+		public:
+			template <typename T> void Write(const T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written directly.");
+				WriteBytes(&value, sizeof(T));
+			}
+			void WriteString(const String& str)
+			{
+				Write(static_cast<std::uint32_t>(str.size()));
+				WriteBytes(str.data(), str.size());
+			}
+			void WriteIndices(const std::vector<std::uint32_t>& indices)
+			{
+				Write(static_cast<std::uint32_t>(indices.size()));
+				WriteBytes(indices.data(), indices.size() * sizeof(std::uint32_t));
+			}
+			template <typename T> void WriteAlignedArray(const T* data, std::size_t count)
+			{
+				Buffer.resize((Buffer.size() + ArrayAlignment - 1) / ArrayAlignment * ArrayAlignment, 0);
+				WriteBytes(data, count * sizeof(T));
+			}
+			void WriteBytes(const void* data, std::size_t size)
+			{
+				const char* bytes = static_cast<const char*>(data);
+				Buffer.insert(Buffer.end(), bytes, bytes + size);
+			}
+			const std::vector<char>& GetBuffer() const { return Buffer; }
+
+		private:
+			std::vector<char> Buffer;
+		};
+
+		/**
+		 * @brief Reads values from the mapped file. Every read is bounds-checked; after the first failed read all further reads fail too.
+		*/
+		class BinaryReader
+		{
+		public:
+			BinaryReader(const unsigned char* data, std::size_t size) : Data(data), Size(size), Position(0), bFailed(false) {}
+
+			bool HasFailed() const { return bFailed; }
+
+			template <typename T> bool Read(T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read directly.");
+				if (!CanRead(sizeof(T)))
+					return false;
+				std::memcpy(&value, Data + Position, sizeof(T));
+				Position += sizeof(T);
+				return true;
+			}
+			bool ReadString(String& str)
+			{
+				std::uint32_t length = 0;
+				if (!Read(length) || !CanRead(length))
+					return false;
+				str.assign(reinterpret_cast<const char*>(Data + Position), length);
+				Position += length;
+				return true;
+			}
+			bool ReadIndices(std::vector<std::uint32_t>& indices)
+			{
+				std::uint32_t count = 0;
+				if (!Read(count) || !CanRead(static_cast<std::size_t>(count) * sizeof(std::uint32_t)))
+					return false;
+				indices.resize(count);
+				std::memcpy(indices.data(), Data + Position, count * sizeof(std::uint32_t));
+				Position += count * sizeof(std::uint32_t);
+				return true;
+			}
+			template <typename T> const T* ReadAlignedArray(std::size_t count)
+			{
+				const std::size_t padding = (ArrayAlignment - Position % ArrayAlignment) % ArrayAlignment;
+				if (!CanRead(padding))
+					return nullptr;
+				Position += padding;
+				if (!CanRead(count * sizeof(T)))
+					return nullptr;
+
+				const T* arr = reinterpret_cast<const T*>(Data + Position);
+				Position += count * sizeof(T);
+				return arr;
+			}
+
+		private:
+			bool CanRead(std::size_t size)
+			{
+				if (bFailed || size > Size - Position)
+					bFailed = true;
+				return !bFailed;
+			}
+			const unsigned char* Data;
+			std::size_t Size;
+			std::size_t Position;
+			bool bFailed;
+		};
+
+		using Contents = MeshCache::Contents;
+
+		bool IsAlbedoTexture(const String& shaderName)
+		{
+			return shaderName.rfind("albedo", 0) == 0;	// diffuse textures are imported as albedo1, albedo2, ... and use an sRGB format
+		}
+
+		/**
+		 * @brief Collects the contents of an imported tree, so they can be serialized in the same form as they are parsed.
+		*/
+		class TreeContentsCollector
+		{
+		public:
+			TreeContentsCollector(Contents& contents) : CollectedContents(contents), bCacheable(true) {}
+
+			bool IsCacheable() const { return bCacheable; }
+
+			void CollectNode(Hierarchy::NodeBase& node)
+			{
+				Contents::NodeData nodeData;
+				nodeData.Type = Contents::NodeType::Component;
+				nodeData.Name = node.GetCompBaseType().GetName();
+				nodeData.NodeTransform = node.GetCompBaseType().GetTransform();
+				nodeData.BoneID = 0;
+				nodeData.BoneOffset = Mat4f(1.0f);
+				nodeData.ChildCount = node.GetChildCount();
+
+				if (auto modelNode = dynamic_cast<Hierarchy::Node<ModelComponent>*>(&node))
+				{
+					nodeData.Type = Contents::NodeType::Model;
+					const ModelComponent& model = modelNode->GetCompT();
+					for (unsigned int i = 0; i < model.GetMeshInstanceCount(); i++)
+						nodeData.MeshIndices.push_back(CollectMesh(model.GetMeshInstance(static_cast<int>(i)).GetMesh(), true));
+				}
+				else if (auto boneNode = dynamic_cast<Hierarchy::Node<BoneComponent>*>(&node))
+				{
+					nodeData.Type = Contents::NodeType::Bone;
+					nodeData.BoneID = boneNode->GetCompT().GetID();
+					nodeData.BoneOffset = boneNode->GetCompT().BoneOffset;
+				}
+
+				if (const Physics::CollisionObject* colObject = node.GetCollisionObject())
+					for (const auto& shape : colObject->Shapes)
+					{
+						if (shape->Type != Physics::CollisionShapeType::COLLISION_TRIANGLE_MESH || !shape->OptionalLocalization)
+						{
+							bCacheable = false;	// only triangle meshes are imported from files
+							continue;
+						}
+						nodeData.CollisionMeshIndices.push_back(CollectMesh(shape->OptionalLocalization->OptionalCorrespondingMesh, false));
+					}
+
+				CollectedContents.Nodes.push_back(std::move(nodeData));
+				for (unsigned int i = 0; i < node.GetChildCount(); i++)
+					CollectNode(*node.GetChild(i));
+			}
+
+		private:
+			std::uint32_t CollectMesh(const Mesh& mesh, bool withMaterial)
+			{
+				Contents::MeshData meshData;
+				const Mesh::MeshLoc loc = mesh.GetLocalization();
+				meshData.NodeName = loc.NodeName;
+				meshData.SpecificName = loc.SpecificName;
+				meshData.BoundingBoxPosition = mesh.GetBoundingBox().Position;
+				meshData.BoundingBoxSize = mesh.GetBoundingBox().Size;
+				meshData.MaterialIndex = (withMaterial && mesh.GetMaterial()) ? (CollectMaterial(*mesh.GetMaterial())) : (-1);
+
+				const std::vector<Vertex>* vertices = mesh.GetVertsData();
+				const std::vector<unsigned int>* indices = mesh.GetIndicesData();
+				if (!vertices || !indices)
+				{
+					bCacheable = false;
+					meshData.Vertices = nullptr;
+					meshData.Indices = nullptr;
+					meshData.VertexCount = meshData.IndexCount = 0;
+				}
+				else
+				{
+					meshData.Vertices = vertices->data();
+					meshData.VertexCount = static_cast<std::uint32_t>(vertices->size());
+					meshData.Indices = indices->data();
+					meshData.IndexCount = static_cast<std::uint32_t>(indices->size());
+				}
+
+				CollectedContents.Meshes.push_back(std::move(meshData));
+				return static_cast<std::uint32_t>(CollectedContents.Meshes.size() - 1);
+			}
+
+			int CollectMaterial(const Material& material)
+			{
+				auto found = MaterialIndices.find(&material);
+				if (found != MaterialIndices.end())
+					return found->second;
+
+				Contents::MaterialData materialData;
+				materialData.Name = material.GetLocalization().Name;
+				materialData.Color = material.Color;
+				materialData.Shininess = material.Shininess;
+				materialData.DepthScale = material.DepthScale;
+				materialData.RoughnessColor = material.RoughnessColor;
+				materialData.MetallicColor = material.MetallicColor;
+				materialData.AoColor = material.AoColor;
+				for (const auto& texture : material.Textures)
+				{
+					// Textures embedded in the source file are only accessible through Assimp.
+					if (texture->GetPath().find(":::") != String::npos)
+						bCacheable = false;
+					materialData.Textures.push_back(Contents::TextureData{ texture->GetPath(), texture->GetShaderName() });
+				}
+
+				CollectedContents.Materials.push_back(std::move(materialData));
+				const int index = static_cast<int>(CollectedContents.Materials.size() - 1);
+				MaterialIndices[&material] = index;
+				return index;
+			}
+
+			Contents& CollectedContents;
+			std::unordered_map<const Material*, int> MaterialIndices;
+			bool bCacheable;
+		};
+
+		void SerializeContents(BinaryWriter& writer, const Contents& contents)
+		{
+			writer.Write(static_cast<std::uint32_t>(contents.BoneNames.size()));
+			for (const String& boneName : contents.BoneNames)
+				writer.WriteString(boneName);
+
+			writer.Write(static_cast<std::uint32_t>(contents.Materials.size()));
+			for (const auto& material : contents.Materials)
+			{
+				writer.WriteString(material.Name);
+				writer.Write(material.Color);
+				writer.Write(material.Shininess);
+				writer.Write(material.DepthScale);
+				writer.Write(material.RoughnessColor);
+				writer.Write(material.MetallicColor);
+				writer.Write(material.AoColor);
+				writer.Write(static_cast<std::uint32_t>(material.Textures.size()));
+				for (const auto& texture : material.Textures)
+				{
+					writer.WriteString(texture.Path);
+					writer.WriteString(texture.ShaderName);
+				}
+			}
+
+			writer.Write(static_cast<std::uint32_t>(contents.Meshes.size()));
+			for (const auto& mesh : contents.Meshes)
+			{
+				writer.WriteString(mesh.NodeName);
+				writer.WriteString(mesh.SpecificName);
+				writer.Write(mesh.BoundingBoxPosition);
+				writer.Write(mesh.BoundingBoxSize);
+				writer.Write(static_cast<std::int32_t>(mesh.MaterialIndex));
+				writer.Write(mesh.VertexCount);
+				writer.Write(mesh.IndexCount);
+				writer.WriteAlignedArray(mesh.Vertices, mesh.VertexCount);
+				writer.WriteAlignedArray(mesh.Indices, mesh.IndexCount);
+			}
+
+			writer.Write(static_cast<std::uint32_t>(contents.Nodes.size()));
+			for (const auto& node : contents.Nodes)
+			{
+				writer.Write(node.Type);
+				writer.WriteString(node.Name);
+				writer.Write(node.NodeTransform.GetPos());
+				writer.Write(node.NodeTransform.GetRot());
+				writer.Write(node.NodeTransform.GetScale());
+				writer.Write(static_cast<std::uint32_t>(node.BoneID));
+				writer.Write(node.BoneOffset);
+				writer.WriteIndices(node.MeshIndices);
+				writer.WriteIndices(node.CollisionMeshIndices);
+				writer.Write(node.ChildCount);
+			}
+
+			writer.Write(static_cast<std::uint32_t>(contents.Animations.size()));
+			for (const auto& animation : contents.Animations)
+			{
+				writer.WriteString(animation.Name);
+				writer.Write(animation.Duration);
+				writer.Write(static_cast<std::uint32_t>(animation.Channels.size()));
+				for (const auto& channel : animation.Channels)
+				{
+					writer.WriteString(channel->Name);
+					writer.Write(static_cast<std::uint32_t>(channel->PosKeys.size()));
+					for (const auto& key : channel->PosKeys)
+					{
+						writer.Write(key->KeyTime);
+						writer.Write(key->Value);
+					}
+					writer.Write(static_cast<std::uint32_t>(channel->RotKeys.size()));
+					for (const auto& key : channel->RotKeys)
+					{
+						writer.Write(key->KeyTime);
+						writer.Write(key->Value);
+					}
+					writer.Write(static_cast<std::uint32_t>(channel->ScaleKeys.size()));
+					for (const auto& key : channel->ScaleKeys)
+					{
+						writer.Write(key->KeyTime);
+						writer.Write(key->Value);
+					}
+				}
+			}
+		}
+
+		template <typename KeyType, typename ValueType>
+		bool ParseKeys(BinaryReader& reader, std::vector<SharedPtr<KeyType>>& keys)
+		{
+			std::uint32_t keyCount = 0;
+			if (!reader.Read(keyCount))
+				return false;
+
+			keys.reserve(keyCount);
+			for (std::uint32_t i = 0; i < keyCount; i++)
+			{
+				Time keyTime = 0.0;
+				ValueType value;
+				if (!reader.Read(keyTime) || !reader.Read(value))
+					return false;
+				keys.push_back(MakeShared<KeyType>(keyTime, value));
+			}
+
+			return true;
+		}
+
+		bool ParseContents(BinaryReader& reader, Contents& contents)
+		{
+			std::uint32_t count = 0;
+
+			if (!reader.Read(count))
+				return false;
+			contents.BoneNames.resize(count);
+			for (String& boneName : contents.BoneNames)
+				reader.ReadString(boneName);
+
+			if (!reader.Read(count))
+				return false;
+			contents.Materials.resize(count);
+			for (auto& material : contents.Materials)
+			{
+				std::uint32_t textureCount = 0;
+				reader.ReadString(material.Name);
+				reader.Read(material.Color);
+				reader.Read(material.Shininess);
+				reader.Read(material.DepthScale);
+				reader.Read(material.RoughnessColor);
+				reader.Read(material.MetallicColor);
+				reader.Read(material.AoColor);
+				if (!reader.Read(textureCount))
+					return false;
+
+				material.Textures.resize(textureCount);
+				for (auto& texture : material.Textures)
+				{
+					reader.ReadString(texture.Path);
+					reader.ReadString(texture.ShaderName);
+				}
+			}
+
+			if (!reader.Read(count))
+				return false;
+			contents.Meshes.resize(count);
+			for (auto& mesh : contents.Meshes)
+			{
+				std::int32_t materialIndex = -1;
+				reader.ReadString(mesh.NodeName);
+				reader.ReadString(mesh.SpecificName);
+				reader.Read(mesh.BoundingBoxPosition);
+				reader.Read(mesh.BoundingBoxSize);
+				reader.Read(materialIndex);
+				reader.Read(mesh.VertexCount);
+				reader.Read(mesh.IndexCount);
+				mesh.Vertices = reader.ReadAlignedArray<Vertex>(mesh.VertexCount);
+				mesh.Indices = reader.ReadAlignedArray<unsigned int>(mesh.IndexCount);
+				mesh.MaterialIndex = materialIndex;
+
+				if (reader.HasFailed() || mesh.MaterialIndex < -1 || mesh.MaterialIndex >= static_cast<int>(contents.Materials.size()))
+					return false;
+				for (std::uint32_t i = 0; i < mesh.IndexCount; i++)
+					if (mesh.Indices[i] >= mesh.VertexCount)
+						return false;
+			}
+
+			if (!reader.Read(count) || count == 0)
+				return false;
+			contents.Nodes.resize(count);
+			for (auto& node : contents.Nodes)
+			{
+				Vec3f position, scale;
+				Quatf rotation;
+				std::uint32_t boneID = 0;
+				reader.Read(node.Type);
+				reader.ReadString(node.Name);
+				reader.Read(position);
+				reader.Read(rotation);
+				reader.Read(scale);
+				reader.Read(boneID);
+				reader.Read(node.BoneOffset);
+				reader.ReadIndices(node.MeshIndices);
+				reader.ReadIndices(node.CollisionMeshIndices);
+				reader.Read(node.ChildCount);
+				node.NodeTransform = Transform(position, rotation, scale);
+				node.BoneID = boneID;
+
+				if (reader.HasFailed() || node.Type > Contents::NodeType::Bone)
+					return false;
+				for (std::uint32_t meshIndex : node.MeshIndices)
+					if (meshIndex >= contents.Meshes.size())
+						return false;
+				for (std::uint32_t meshIndex : node.CollisionMeshIndices)
+					if (meshIndex >= contents.Meshes.size())
+						return false;
+			}
+
+			if (!reader.Read(count))
+				return false;
+			contents.Animations.resize(count);
+			for (auto& animation : contents.Animations)
+			{
+				std::uint32_t channelCount = 0;
+				reader.ReadString(animation.Name);
+				reader.Read(animation.Duration);
+				if (!reader.Read(channelCount))
+					return false;
+
+				animation.Channels.reserve(channelCount);
+				for (std::uint32_t i = 0; i < channelCount; i++)
+				{
+					String channelName;
+					if (!reader.ReadString(channelName))
+						return false;
+
+					SharedPtr<AnimationChannel> channel = MakeShared<AnimationChannel>(channelName);
+					if (!ParseKeys<AnimationVecKey, Vec3f>(reader, channel->PosKeys) || !ParseKeys<AnimationQuatKey, Quatf>(reader, channel->RotKeys) || !ParseKeys<AnimationVecKey, Vec3f>(reader, channel->ScaleKeys))
+						return false;
+					animation.Channels.push_back(channel);
+				}
+			}
+
+			return !reader.HasFailed();
+		}
+
+		void GenerateMesh(Mesh& mesh, const Contents::MeshData& meshData, bool keepVertsData)
+		{
+			mesh.SetBoundingBox(Boxf<Vec3f>(meshData.BoundingBoxPosition, meshData.BoundingBoxSize));
+			mesh.Generate(meshData.Vertices, meshData.VertexCount, meshData.Indices, meshData.IndexCount, keepVertsData);
+		}
+
+		/**
+		 * @return true if the child counts describe a single tree that spans all the nodes.
+		*/
+		bool ValidateNodeStructure(const std::vector<Contents::NodeData>& nodes, std::size_t nodeIndex, std::size_t& nextNodeIndex)
+		{
+			nextNodeIndex = nodeIndex + 1;
+			for (std::uint32_t i = 0; i < nodes[nodeIndex].ChildCount; i++)
+				if (nextNodeIndex >= nodes.size() || !ValidateNodeStructure(nodes, nextNodeIndex, nextNodeIndex))
+					return false;
+
+			return true;
+		}
+	}
+
+	String MeshCache::GetCachePath(const String& sourcePath)
+	{
+		return sourcePath + ".geemesh";
+	}
+
+	UniquePtr<MeshCache::Contents> MeshCache::Open(const String& sourcePath, std::uint32_t importFlags)
+	{
+		UniquePtr<Contents> contents = MakeUnique<Contents>();
+		if (!contents->File.Open(GetCachePath(sourcePath)))
+			return nullptr;
+
+		BinaryReader reader(contents->File.GetData(), contents->File.GetSize());
+		CacheFileHeader header{};
+		if (!reader.Read(header) || header.Magic != CacheFileMagic || header.Version != CacheFileVersion || header.VertexSize != sizeof(Vertex) || header.ImportFlags != importFlags)
+			return nullptr;
+
+		std::uint64_t sourceSize = 0, sourceHash = 0;
+		if (!GetSourceIdentity(sourcePath, sourceSize, sourceHash) || sourceSize != header.SourceSize || sourceHash != header.SourceHash)
+			return nullptr;	// the source file has changed since the cache file was written
+
+		std::size_t nodeCount = 0;
+		if (!ParseContents(reader, *contents) || !ValidateNodeStructure(contents->Nodes, 0, nodeCount) || nodeCount != contents->Nodes.size())
+		{
+			std::cout << "WARNING: Mesh cache file " << GetCachePath(sourcePath) << " is corrupted. " << sourcePath << " will be imported again.\n";
+			return nullptr;
+		}
+
+		return contents;
+	}
+
+	MeshCache::Instantiator::Instantiator(const Contents& contents, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData) :
+		CachedContents(contents),
+		TreeRef(tree),
+		MatLoadingData(matLoadingData),
+		bKeepVertsData(keepVertsData),
+		StepIndex(0)
+	{
+		tree.ResetBoneMapping(!contents.BoneNames.empty());
+		if (BoneMapping* boneMapping = tree.GetBoneMapping())
+			for (const String& boneName : contents.BoneNames)
+				boneMapping->GetBoneID(boneName);	// IDs are assigned in the order of registration
+
+		Materials.reserve(contents.Materials.size());
+	}
+
+	bool MeshCache::Instantiator::Step()
+	{
+		if (IsFinished())
+			return true;
+
+		const std::size_t materialCount = CachedContents.Materials.size(), nodeCount = CachedContents.Nodes.size();
+		if (StepIndex < materialCount)
+			InstantiateMaterial(CachedContents.Materials[StepIndex]);
+		else if (StepIndex < materialCount + nodeCount)
+			InstantiateNode(CachedContents.Nodes[StepIndex - materialCount]);
+		else
+			for (const auto& animationData : CachedContents.Animations)
+			{
+				Animation animation(TreeRef, animationData.Name, animationData.Duration);
+				animation.Channels = animationData.Channels;
+				TreeRef.AddAnimation(animation);
+			}
+
+		StepIndex++;
+		return IsFinished();
+	}
+
+	bool MeshCache::Instantiator::IsFinished() const
+	{
+		return StepIndex > CachedContents.Materials.size() + CachedContents.Nodes.size();
+	}
+
+	float MeshCache::Instantiator::GetProgress() const
+	{
+		return static_cast<float>(StepIndex) / static_cast<float>(CachedContents.Materials.size() + CachedContents.Nodes.size() + 1);
+	}
+
+	void MeshCache::Instantiator::InstantiateMaterial(const Contents::MaterialData& materialData)
+	{
+		SharedPtr<Material> material = MaterialUtil::MakeImportedMaterial(Material::MaterialLoc(TreeRef, materialData.Name));
+		material->Color = materialData.Color;
+		material->Shininess = materialData.Shininess;
+		material->DepthScale = materialData.DepthScale;
+		material->RoughnessColor = materialData.RoughnessColor;
+		material->MetallicColor = materialData.MetallicColor;
+		material->AoColor = materialData.AoColor;
+
+		for (const auto& textureData : materialData.Textures)
+		{
+			if (SharedPtr<NamedTexture> found = MatLoadingData.FindTexture(textureData.Path))
+			{
+				material->AddTexture(found);
+				continue;
+			}
+
+			SharedPtr<NamedTexture> texture = MakeShared<NamedTexture>(MatLoadingData.LoadTextureFile(textureData.Path, IsAlbedoTexture(textureData.ShaderName)), textureData.ShaderName);
+			texture->SetWrap(GL_REPEAT, GL_REPEAT, 0, true);
+			material->AddTexture(texture);
+			MatLoadingData.AddTexture(texture);
+		}
+
+		MatLoadingData.LoadedMaterials.push_back(material);
+		MatLoadingData.LoadedAiMaterials.push_back(nullptr);	// keep both vectors the same size
+		Materials.push_back(material);
+	}
+
+	void MeshCache::Instantiator::InstantiateNode(const Contents::NodeData& nodeData)
+	{
+		// Nodes are stored in pre-order, so the parent of this node is the last node which still waits for its children.
+		Hierarchy::NodeBase* hierarchyNode = &TreeRef.GetRoot();
+		if (!UnfinishedParents.empty())
+		{
+			Hierarchy::NodeBase& parent = *UnfinishedParents.back().first;
+			switch (nodeData.Type)
+			{
+			case Contents::NodeType::Model: hierarchyNode = &parent.CreateChild<ModelComponent>(nodeData.Name); break;
+			case Contents::NodeType::Bone: hierarchyNode = &parent.CreateChild<BoneComponent>(nodeData.Name); break;
+			default: hierarchyNode = &parent.CreateChild<Component>(nodeData.Name); break;
+			}
+
+			if (--UnfinishedParents.back().second == 0)
+				UnfinishedParents.pop_back();
+		}
+
+		hierarchyNode->GetCompBaseType().SetTransform(nodeData.NodeTransform);
+
+		if (auto modelNode = dynamic_cast<Hierarchy::Node<ModelComponent>*>(hierarchyNode))
+		{
+			for (std::uint32_t meshIndex : nodeData.MeshIndices)
+			{
+				const Contents::MeshData& meshData = CachedContents.Meshes[meshIndex];
+				Mesh* mesh = new Mesh(Mesh::MeshLoc(TreeRef, meshData.NodeName, meshData.SpecificName));
+				GenerateMesh(*mesh, meshData, bKeepVertsData);
+				if (meshData.MaterialIndex >= 0)
+					mesh->SetMaterial(Materials[meshData.MaterialIndex]);
+
+				modelNode->GetCompT().AddMeshInst(*mesh);
+			}
+		}
+		else if (auto boneNode = dynamic_cast<Hierarchy::Node<BoneComponent>*>(hierarchyNode))
+		{
+			boneNode->GetCompT().SetBoneOffset(nodeData.BoneOffset);
+			boneNode->GetCompT().SetID(nodeData.BoneID);
+		}
+
+		for (std::uint32_t meshIndex : nodeData.CollisionMeshIndices)
+		{
+			const Contents::MeshData& meshData = CachedContents.Meshes[meshIndex];
+			Mesh mesh(Mesh::MeshLoc(TreeRef, meshData.NodeName, meshData.SpecificName));
+			GenerateMesh(mesh, meshData, true);
+
+			if (SharedPtr<Physics::CollisionShape> shape = EngineDataLoader::LoadTriangleMeshCollisionShape(TreeRef.GetScene().GetGameHandle()->GetPhysicsHandle(), mesh))
+			{
+				hierarchyNode->AddCollisionShape(shape);
+				shape->GetOptionalLocalization()->OptionalCorrespondingMesh = mesh;
+			}
+		}
+
+		if (nodeData.ChildCount > 0)
+			UnfinishedParents.emplace_back(hierarchyNode, nodeData.ChildCount);
+	}
+
+	void MeshCache::Instantiate(const Contents& contents, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData)
+	{
+		Instantiator instantiator(contents, tree, matLoadingData, keepVertsData);
+		while (!instantiator.IsFinished())
+			instantiator.Step();
+	}
+
+	bool MeshCache::Write(Hierarchy::Tree& tree, const String& sourcePath, std::uint32_t importFlags)
+	{
+		CacheFileHeader header{};
+		header.Magic = CacheFileMagic;
+		header.Version = CacheFileVersion;
+		header.VertexSize = static_cast<std::uint32_t>(sizeof(Vertex));
+		header.ImportFlags = importFlags;
+		if (!GetSourceIdentity(sourcePath, header.SourceSize, header.SourceHash))
+			return false;
+
+		Contents contents;
+		if (const BoneMapping* boneMapping = tree.GetBoneMapping())
+			contents.BoneNames = boneMapping->GetBoneNames();
+
+		TreeContentsCollector collector(contents);
+		collector.CollectNode(tree.GetRoot());
+		if (!collector.IsCacheable())
+		{
+			std::cout << "INFO: " << sourcePath << " cannot be stored in the mesh cache (it uses embedded textures or its vertex data was not kept).\n";
+			return false;
+		}
+
+		for (unsigned int i = 0; i < tree.GetAnimationCount(); i++)
+		{
+			const Animation& animation = tree.GetAnimation(i);
+			contents.Animations.push_back(Contents::AnimationData{ animation.Localization.Name, animation.Duration, animation.Channels });
+		}
+
+		BinaryWriter writer;
+		writer.Write(header);
+		SerializeContents(writer, contents);
+
+		// Write to a temporary file first, so a partially written file never replaces a valid one.
+		const String cachePath = GetCachePath(sourcePath), tempPath = cachePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			file.write(writer.GetBuffer().data(), static_cast<std::streamsize>(writer.GetBuffer().size()));
+			if (!file.good())
+			{
+				std::cout << "ERROR: Cannot write mesh cache file " << tempPath << ".\n";
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+		if (error)
+		{
+			std::cout << "ERROR: Cannot write mesh cache file " << cachePath << " (" << error.message() << ").\n";
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <utility/Utility.h>
+#include <utility/MappedFile.h>
+#include <math/Transform.h>
+#include <cstdint>
+
+namespace GEE
+{
+	struct Vertex;
+	struct AnimationChannel;
+	struct MaterialLoadingData;
+	class Material;
+	namespace Hierarchy
+	{
+		class Tree;
+		class NodeBase;
+	}
+
+	/**
+	 * @brief Native binary cache of Hierarchy::Trees imported with Assimp. The cache file is stored next to the source file (see GetCachePath()) and contains the processed tree: nodes, meshes with their final vertices and indices, bone mapping, animations, bounding boxes and material references.
+	 * A cache file is only used if the size and the hash of its source file, the import flags and the format version match, so any change of the source makes the tree be imported with Assimp again.
+	 * Loading is split in two steps: Open() maps and validates the file without touching OpenGL or the scene (so it can be done by any thread), while Instantiate() (or an Instantiator) builds the tree and uploads vertex data straight from the mapped file.
+	*/
+	class MeshCache
+	{
+	public:
+		/**
+		 * @brief Parsed contents of a cache file. Vertex and index arrays point into the mapped file.
+		*/
+		struct Contents
+		{
+			enum class NodeType : std::uint8_t
+			{
+				Component,
+				Model,
+				Bone
+			};
+			struct TextureData
+			{
+				String Path;
+				String ShaderName;
+			};
+			struct MaterialData
+			{
+				String Name;
+				Vec4f Color;
+				float Shininess, DepthScale, RoughnessColor, MetallicColor, AoColor;
+				std::vector<TextureData> Textures;
+			};
+			struct MeshData
+			{
+				String NodeName, SpecificName;
+				Vec3f BoundingBoxPosition, BoundingBoxSize;
+				int MaterialIndex;	// -1 if the mesh has no material
+				const Vertex* Vertices;
+				std::uint32_t VertexCount;
+				const unsigned int* Indices;
+				std::uint32_t IndexCount;
+			};
+			struct NodeData	// stored in pre-order
+			{
+				NodeType Type;
+				String Name;
+				Transform NodeTransform;
+				unsigned int BoneID;
+				Mat4f BoneOffset;
+				std::vector<std::uint32_t> MeshIndices;
+				std::vector<std::uint32_t> CollisionMeshIndices;
+				std::uint32_t ChildCount;
+			};
+			struct AnimationData
+			{
+				String Name;
+				Time Duration;
+				std::vector<SharedPtr<AnimationChannel>> Channels;
+			};
+
+			MappedFile File;
+			std::vector<String> BoneNames;	// ordered by bone ID
+			std::vector<MaterialData> Materials;
+			std::vector<MeshData> Meshes;
+			std::vector<NodeData> Nodes;
+			std::vector<AnimationData> Animations;
+		};
+
+		static String GetCachePath(const String& sourcePath);
+
+		/**
+		 * @return the parsed cache file of the source file or nullptr if there is no valid, up-to-date cache file.
+		*/
+		static UniquePtr<Contents> Open(const String& sourcePath, std::uint32_t importFlags);
+		/**
+		 * @brief Fills an empty tree with the cached contents in small steps, so the work can be spread over multiple frames. Must be used on the thread which owns the OpenGL context.
+		 * Each step creates one material (uploading its textures) or one node (uploading its meshes). The contents, the tree and matLoadingData must outlive the Instantiator.
+		*/
+		class Instantiator
+		{
+		public:
+			/**
+			 * @param matLoadingData: the created materials are added to LoadedMaterials, so the caller can register them like materials imported with Assimp. Its DecodedImages are used instead of reading the texture files again.
+			*/
+			Instantiator(const Contents&, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData);
+
+			/**
+			 * @return true if the tree is complete. Calling Step() afterwards has no effect.
+			*/
+			bool Step();
+			bool IsFinished() const;
+			/**
+			 * @return the fraction of steps which have been done, from 0 to 1.
+			*/
+			float GetProgress() const;
+
+		private:
+			void InstantiateMaterial(const Contents::MaterialData&);
+			void InstantiateNode(const Contents::NodeData&);
+
+			const Contents& CachedContents;
+			Hierarchy::Tree& TreeRef;
+			MaterialLoadingData& MatLoadingData;
+			bool bKeepVertsData;
+
+			std::size_t StepIndex;
+			std::vector<SharedPtr<Material>> Materials;
+			std::vector<std::pair<Hierarchy::NodeBase*, std::uint32_t>> UnfinishedParents;	// the nodes whose children are still being created and their remaining child count
+		};
+
+		/**
+		 * @brief Fills an empty tree with the cached contents at once. See Instantiator.
+		*/
+		static void Instantiate(const Contents&, Hierarchy::Tree& tree, MaterialLoadingData& matLoadingData, bool keepVertsData);
+
+		/**
+		 * @brief Writes the cache file of a tree which has just been imported from sourcePath. Meshes of the tree must keep their vertex data.
+		 * @return false if the tree cannot be cached (e.g. its materials use textures embedded in the source file) or the file could not be written.
+		*/
+		static bool Write(Hierarchy::Tree& tree, const String& sourcePath, std::uint32_t importFlags);
+	};
+}
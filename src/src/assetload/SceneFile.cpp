@@ -0,0 +1,128 @@
+#include <assetload/SceneFile.h>
+#include <game/GameScene.h>
+#include <scene/hierarchy/HierarchyTree.h>
+#include <editor/GEditorSettings.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace GEE
+{
+	const std::string SceneFile::BinaryExtension = ".geebin";
+	const std::uint32_t SceneFile::BinaryMagic = 0x42454547;	// "GEEB"
+	const std::uint32_t SceneFile::BinaryVersion = 1;
+
+	namespace
+	{
+		std::ios::openmode getOpenMode(SceneFileFormat format)
+		{
+			// JSON files are written in text mode, like they always were, so they do not change between formats on any system.
+			return (format == SceneFileFormat::Binary) ? (std::ios::binary) : (std::ios::openmode());
+		}
+	}
+
+	SceneFileFormat SceneFile::GetFormat(const String& path)
+	{
+		return (getFilepathExtension(path) == BinaryExtension) ? (SceneFileFormat::Binary) : (SceneFileFormat::Json);
+	}
+
+	String SceneFile::GetPathInFormat(const String& path, SceneFileFormat format)
+	{
+		return std::filesystem::path(path).replace_extension((format == SceneFileFormat::Binary) ? (BinaryExtension) : (".json")).string();
+	}
+
+	String SceneFile::ResolveLoadPath(const String& path)
+	{
+#ifdef NDEBUG
+		if (getFilepathExtension(path) == ".json")
+		{
+			const String binaryPath = GetPathInFormat(path, SceneFileFormat::Binary);
+			std::error_code error;
+			if (std::filesystem::exists(binaryPath, error) && std::filesystem::last_write_time(binaryPath, error) >= std::filesystem::last_write_time(path, error))
+				return binaryPath;
+		}
+#endif
+		return path;
+	}
+
+	bool SceneFile::Save(GameScene& scene, const Editor::GEditorSettings& editorSettings, const String& path)
+	{
+		const SceneFileFormat format = GetFormat(path);
+		std::stringstream serializationStream(std::ios::in | std::ios::out | getOpenMode(format));
+		try
+		{
+			// Archives flush their data when they are destroyed, so they are scoped.
+			if (format == SceneFileFormat::Binary)
+			{
+				cereal::PortableBinaryOutputArchive archive(serializationStream);
+				archive(BinaryMagic, BinaryVersion, GetTreeFilePaths(scene));
+				SaveToArchive(archive, scene, editorSettings);
+			}
+			else
+			{
+				cereal::JSONOutputArchive archive(serializationStream);
+				SaveToArchive(archive, scene, editorSettings);
+			}
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: While saving scene " << scene.GetName() << " to " << path << ": " << exception.what() << '\n';
+			std::ofstream brokenFileOutput(path + "broken", std::ios::out | getOpenMode(format));	// Do not save to file if the process wasn't successful; we don't want to corrupt existing data.
+			brokenFileOutput << serializationStream.rdbuf();
+			return false;
+		}
+
+		std::ofstream file(path, std::ios::out | getOpenMode(format));
+		file << serializationStream.rdbuf();
+		if (!file.good())
+		{
+			std::cout << "ERROR: Cannot write scene file " << path << ".\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool SceneFile::ReadBinaryHeader(cereal::PortableBinaryInputArchive& archive, std::vector<String>& treePaths)
+	{
+		std::uint32_t magic = 0, version = 0;
+		archive(magic);
+		if (magic != BinaryMagic)
+		{
+			std::cout << "ERROR: Not a binary scene file.\n";
+			return false;
+		}
+
+		archive(version);
+		if (version != BinaryVersion)
+		{
+			std::cout << "ERROR: Binary scene file version " << version << " is not supported (expected " << BinaryVersion << "). Load the JSON file and save it again.\n";
+			return false;
+		}
+
+		archive(treePaths);
+		return true;
+	}
+
+	template <typename Archive>
+	void SceneFile::SaveToArchive(Archive& archive, GameScene& scene, const Editor::GEditorSettings& editorSettings)
+	{
+		// Must match the order of loading in EngineDataLoader::SetupSceneFromFile().
+		archive(cereal::make_nvp("GEditorSettings", editorSettings));
+		scene.Save(archive);
+		archive.serializeDeferments();
+	}
+
+	std::vector<String> SceneFile::GetTreeFilePaths(GameScene& scene)
+	{
+		std::vector<String> paths;
+		for (int i = 0; i < scene.GetHierarchyTreeCount(); i++)
+		{
+			const Hierarchy::Tree& tree = *scene.GetHierarchyTree(i);
+			if (!tree.GetName().IsALocalResource() && std::filesystem::exists(tree.GetName().GetPath()))
+				paths.push_back(tree.GetName().GetPath());
+		}
+
+		return paths;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <utility/Utility.h>
+#include <utility/CerealArchives.h>
+#include <cstdint>
+
+namespace GEE
+{
+	class GameScene;
+	namespace Editor
+	{
+		struct GEditorSettings;
+	}
+
+	enum class SceneFileFormat
+	{
+		Json,	// readable and diffable; the format projects are edited in
+		Binary	// cereal portable binary archive; the same data, but much faster to load
+	};
+
+	/**
+	 * @brief Saves projects (the editor settings and a GameScene) in either format. Both formats store exactly the same data in the same order, so a project can be converted losslessly by loading it and saving it in the other format.
+	 * Binary files start with a header: a magic number, the format version and the paths of the tree files used by the scene, so their loading can start before the scene is read (like EngineDataLoader does for JSON files by scanning the text).
+	 * Loading is done by EngineDataLoader::SetupSceneFromFile().
+	*/
+	class SceneFile
+	{
+	public:
+		static const std::string BinaryExtension;
+
+		/**
+		 * @return the format of the file, deduced from its extension. Files which are not binary are treated as JSON.
+		*/
+		static SceneFileFormat GetFormat(const String& path);
+		/**
+		 * @return the path of the sibling file in the given format (e.g. Projects/lambda.json -> Projects/lambda.geebin).
+		*/
+		static String GetPathInFormat(const String& path, SceneFileFormat);
+		/**
+		 * @return the path which should be loaded when path is requested. In release builds, a JSON project is loaded from its binary sibling if the sibling is not older than the JSON file.
+		*/
+		static String ResolveLoadPath(const String& path);
+
+		/**
+		 * @brief Saves the scene in the format deduced from the extension of the path. The file is written only if serialization succeeds; otherwise the partial data is written to path + "broken".
+		 * @return false if the scene could not be serialized or the file could not be written.
+		*/
+		static bool Save(GameScene&, const Editor::GEditorSettings&, const String& path);
+
+		/**
+		 * @brief Reads the header of a binary scene file.
+		 * @return false if the data is not a binary scene file of the current version.
+		*/
+		static bool ReadBinaryHeader(cereal::PortableBinaryInputArchive&, std::vector<String>& treePaths);
+
+	private:
+		template <typename Archive> static void SaveToArchive(Archive&, GameScene&, const Editor::GEditorSettings&);
+		/**
+		 * @return the paths of the tree files referenced by the scene. Local trees (saved along with the scene) and trees which do not come from files are skipped.
+		*/
+		static std::vector<String> GetTreeFilePaths(GameScene&);
+
+		static const std::uint32_t BinaryMagic;
+		static const std::uint32_t BinaryVersion;
+	};
+}
@@ -7,7 +7,6 @@ namespace GEE
 		AudioEngine::AudioEngine(GameManager* gameHandle) :
 			Device(nullptr), Context(nullptr), ListenerTransformPtr(nullptr), GameHandle(gameHandle)
 		{
-			Init();
 		}
 
 		void AudioEngine::Init()
@@ -59,7 +58,7 @@ namespace GEE
 		void AudioEngine::Update()
 		{
 			////////////////// Update listener position & orientation
-			if (!ListenerTransformPtr)
+			if (!ListenerTransformPtr || !Context)
 				return;
 
 			alListenerfv(AL_POSITION, Math::GetDataPtr(ListenerTransformPtr->GetWorldTransform().GetPos()));
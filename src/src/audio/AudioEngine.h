@@ -19,6 +19,9 @@ namespace GEE
 
 		public:
 			AudioEngine(GameManager*);
+			/**
+			 * @brief Opens the default audio device. Until it is called, the engine does not play anything.
+			*/
 			void Init();
 
 			void SetListenerTransformPtr(Transform*);
@@ -132,7 +132,7 @@ namespace GEE
 				glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 				Impl.RenderHandle.GetSimpleShader()->Use();
-				Impl.RenderHandle.GetSimpleShader()->Uniform<Vec2f>("atlasData", Vec2f(0.0f));
+				MaterialUtil::BindDefaultInstanceDataBlock();
 				Renderer(Impl.RenderHandle).StaticMeshInstances(MatrixInfoExt(), { MeshInstance(Impl.RenderHandle.GetBasicShapeMesh(EngineBasicShape::Quad), Impl.RenderHandle.FindMaterial("GEE_3D_SCENE_PREVIEW_MATERIAL")) }, editorScene->FindActor("SceneViewportActor")->GetTransform()->GetWorldTransform(), *Impl.RenderHandle.GetSimpleShader());
 			}
 			else
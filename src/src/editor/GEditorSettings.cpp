@@ -1,6 +1,6 @@
 #include "GEditorSettings.h"
 #include <utility/CerealNames.h>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
 
 namespace GEE
 {
@@ -17,5 +17,7 @@ namespace GEE
 
 		template void GEditorSettings::Serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&);
 		template void GEditorSettings::Serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+		template void GEditorSettings::Serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&);
+		template void GEditorSettings::Serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 	}
 }
\ No newline at end of file
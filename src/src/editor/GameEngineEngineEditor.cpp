@@ -34,6 +34,9 @@
 #include <editor/GraphRenderingComponent.h>
 
 #include <rendering/Renderer.h>
+#include <assetload/SceneFile.h>
+#include <utility/ScopeProfiler.h>
+#include <rendering/GpuProfiler.h>
 
 
 namespace GEE
@@ -115,7 +118,10 @@ namespace GEE
 			OpenPopups.erase(std::remove_if(OpenPopups.begin(), OpenPopups.end(), [this](EditorPopup& popup) { if (glfwWindowShouldClose(&popup.Window.get())) { glfwDestroyWindow(&popup.Window.get()); RenderEng.EraseRenderTbCollection(popup.TbCol); return true; } return false; }), OpenPopups.end());
 
 			if (Profiler.HasBeenStarted())
+			{
+				Profiler.SetCurrentUsageOfGPU(static_cast<float>(GpuProfiler::GetLatestFrameGpuTime() / 1000.0));	// GPU time of the latest measured frame, in seconds like the frame time
 				Profiler.AddTime(deltaTime);
+			}
 
 			return returnVal;
 		}
@@ -904,13 +910,12 @@ namespace GEE
 
 			for (auto& scene : Scenes)
 			{
-				while (SharedPtr<Event> polledEvent = EventHolderObj.PollEvent(*scene))
-				{
+				EventHolderObj.DrainEvents(*scene, [&](Event& polledEvent) {
 					LastRenderPopupRequest = nullptr;	// last popup request generated from this event; if it stays at nullptr, we know that no such request has been made.
 
-					if (polledEvent->GetType() == EventType::KeyPressed)
+					if (polledEvent.GetType() == EventType::KeyPressed)
 					{
-						KeyEvent& keyEventCast = dynamic_cast<KeyEvent&>(*polledEvent);
+						KeyEvent& keyEventCast = dynamic_cast<KeyEvent&>(polledEvent);
 						if (scene.get() == EditorScene)
 						{
 							switch (keyEventCast.GetKeyCode())
@@ -989,20 +994,19 @@ namespace GEE
 						}
 					}
 
-					scene->HandleEventAll(*polledEvent);
+					scene->HandleEventAll(polledEvent);
 
 					if (LastRenderPopupRequest)
 						LastRenderPopupRequest();
-				}
+				});
 			}
 
 
 			for (auto& popup : OpenPopups)
 			{
-				while (SharedPtr<Event> polledEvent = EventHolderObj.PollEvent(popup.Scene))
-				{
-					popup.Scene.get().HandleEventAll(*polledEvent);
-				}
+				EventHolderObj.DrainEvents(popup.Scene, [&popup](Event& polledEvent) {
+					popup.Scene.get().HandleEventAll(polledEvent);
+				});
 			}
 		}
 
@@ -1106,25 +1110,17 @@ namespace GEE
 
 			GetEditorLogger(*EditorScene).Log("Saving project", EditorMessageLogger::MessageType::Information);
 
-			std::stringstream serializationStream(filepath);
-			try
-			{
-				cereal::JSONOutputArchive archive(serializationStream);
-				archive(cereal::make_nvp("GEditorSettings", EditorSettings));
-				GetMainScene()->Save(archive);
-				archive.serializeDeferments();
-			}
-			catch (cereal::Exception& exception)
+			if (!SceneFile::Save(*GetMainScene(), EditorSettings, filepath))
 			{
-				std::ofstream brokenFileOutput(filepath + "broken");	// Do not save to file if the process wasn't successful; we don't want to corrupt existing data.
-				brokenFileOutput << serializationStream.rdbuf();
-				GetEditorLogger(*EditorScene).Log(exception.what(), EditorMessageLogger::MessageType::Error);
+				GetEditorLogger(*EditorScene).Log("Could not save the project. See the console for details.", EditorMessageLogger::MessageType::Error);
 				return;
 			}
 
-			std::ofstream workingFileOutput(filepath);
-			workingFileOutput << serializationStream.str();
-			workingFileOutput.close();	// serialization stream must be closed after destroying the archive
+#ifdef NDEBUG
+			// Release builds load projects from their binary form (see SceneFile::ResolveLoadPath()), so keep it up to date.
+			if (SceneFile::GetFormat(filepath) == SceneFileFormat::Json)
+				SceneFile::Save(*GetMainScene(), EditorSettings, SceneFile::GetPathInFormat(filepath, SceneFileFormat::Binary));
+#endif
 
 			UpdateRecentProjects();
 
@@ -1136,12 +1132,18 @@ namespace GEE
 		{
 			GEE_LOG("Starting the profiler...");
 			Profiler.StartProfiling(GetProgramRuntime());
+			ScopeProfiler::Clear();
+			ScopeProfiler::SetEnabled(true);
+			GpuProfiler::SetEnabled(true);
 		}
 
 		void GameEngineEngineEditor::StopProfiler()
 		{
 			GEE_LOG("Stopping the profiler...");
 			Profiler.StopAndSaveToFile(GetProgramRuntime());
+			ScopeProfiler::SetEnabled(false);
+			GpuProfiler::SetEnabled(false);
+			ScopeProfiler::ExportChromeTrace("profiling_trace.json");	// open in chrome://tracing or ui.perfetto.dev
 		}
 
 		void GameEngineEngineEditor::SetProjectFilepath(const String& filepath)
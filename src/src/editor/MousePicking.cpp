@@ -1,6 +1,7 @@
 #include "MousePicking.h"
 #include <rendering/RenderEngine.h>
 #include <rendering/Texture.h>
+#include <rendering/Material.h>
 #include <game/GameScene.h>
 #include <scene/Actor.h>
 #include <scene/RenderableComponent.h>
@@ -50,6 +51,9 @@ namespace GEE
 			std::vector<std::pair<Component*, unsigned int>> notRenderables;
 			notRenderables.reserve(components.size());	// avoid some overhead
 
+			// Shaders which read material properties from the MaterialData block get the index through this material
+			Material pickingMaterial("GEE_E_Picking_Material");
+
 			glEnable(GL_DEPTH_TEST);
 			glEnable(GL_CULL_FACE);
 
@@ -84,8 +88,16 @@ namespace GEE
 				}
 
 				shader->Use();
-				shader->Uniform<Vec4f>("material.color", Vec4f(currentComponentIndex++, 0, 0, 1));
-				shader->Uniform<bool>("material.disableColor", false);
+				if (shader->UsesMaterialDataBlock())
+				{
+					pickingMaterial.SetColor(Vec4f(currentComponentIndex++, 0, 0, 1));
+					pickingMaterial.BindDataBlock();
+				}
+				else
+				{
+					shader->Uniform<Vec4f>("material.color", Vec4f(currentComponentIndex++, 0, 0, 1));
+					shader->Uniform<bool>("material.disableColor", false);
+				}
 
 				compRenderableCast->Render(info, shader);
 			}
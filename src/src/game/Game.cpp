@@ -1,10 +1,16 @@
 #include <game/Game.h>
 #include <assetload/FileLoader.h>
+#include <assetload/SceneFile.h>
 #include <rendering/LightProbe.h>
 #include <UI/Font.h>
 #include <scene/Controller.h>
 #include <scene/Actor.h>
 #include <input/InputDevicesStateRetriever.h>
+#include <input/InputRecorder.h>
+#include <utility/AllocationCounter.h>
+#include <utility/Jobs.h>
+#include <utility/ScopeProfiler.h>
+#include <rendering/GpuProfiler.h>
 #include <thread>
 
 namespace GEE
@@ -35,22 +41,25 @@ namespace GEE
 		TotalFrameCount(0)
 	{
 		GameManager::GamePtr = this;
-		glDisable(GL_MULTISAMPLE);
-		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-
-		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_ARB);
-		glDebugMessageCallbackARB(DebugCallbacks::OpenGLDebug, nullptr);
-		glDebugMessageControlARB(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+		ScopeProfiler::SetThreadName("Main");
 
 		DebugMode = true;
 		LoopBeginTime = 0.0;
 		TimeAccumulator = 0.0;
+		HeadlessRuntime = 0.0;
 
 		GEE_FB::Framebuffer DefaultFramebuffer;
 	}
 
 	void Game::Init(SystemWindow* window, const Vec2u& windowSize)
 	{
+		glDisable(GL_MULTISAMPLE);
+		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_ARB);
+		glDebugMessageCallbackARB(DebugCallbacks::OpenGLDebug, nullptr);
+		glDebugMessageControlARB(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
 		GameWindow = window;
 		glfwSetWindowUserPointer(GameWindow, nullptr);
 		glfwSetWindowSize(GameWindow, windowSize.x, windowSize.y);
@@ -75,6 +84,8 @@ namespace GEE
 		glfwSetDropCallback(GameWindow, WindowEventProcessor::FileDropCallback);
 		glfwSetWindowCloseCallback(GameWindow, [](GLFWwindow* window) { static_cast<Game*>(glfwGetWindowUserPointer(window))->TerminateGame(); });
 
+		std::cout << "Job system started with " << JobSystem::Get().GetWorkerCount() << " worker threads.\n";
+		AudioEng.Init();
 		RenderEng.Init(Vec2u(Settings->Video.Resolution.x, Settings->Video.Resolution.y));
 		PhysicsEng.Init();
 
@@ -83,10 +94,26 @@ namespace GEE
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
+	void Game::InitHeadless(bool enableAudio)
+	{
+		// Set before anything is loaded, so no GPU resources are created.
+		GameManager::bHeadless = true;
+		GameWindow = nullptr;
+
+		std::cout << "Job system started with " << JobSystem::Get().GetWorkerCount() << " worker threads.\n";
+		std::cout << "INFO: Running headless; nothing will be rendered.\n";
+		if (enableAudio)
+			AudioEng.Init();
+		RenderEng.InitHeadless();
+		PhysicsEng.Init();
+	}
+
 	bool Game::LoadSceneFromFile(const std::string& path, const std::string& name)
 	{
-		std::cout << "Loading scene " + name + " from filepath " + path + "\n";
-		return EngineDataLoader::SetupSceneFromFile(this, path, name);
+		// In release builds, projects are loaded from their binary form if it is up to date.
+		const std::string resolvedPath = SceneFile::ResolveLoadPath(path);
+		std::cout << "Loading scene " + name + " from filepath " + resolvedPath + "\n";
+		return EngineDataLoader::SetupSceneFromFile(this, resolvedPath, name);
 	}
 
 	GameScene& Game::CreateScene(String name, bool disallowChangingNameIfTaken)
@@ -150,6 +177,9 @@ namespace GEE
 	{
 		mouseController = controller;
 
+		if (!GameWindow)
+			return;
+
 		if (!mouseController)
 			glfwSetInputMode(GameWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 		else
@@ -182,11 +212,17 @@ namespace GEE
 
 	InputDevicesStateRetriever Game::GetDefInputRetriever()
 	{
+		if (!GameWindow)
+			return InputDevicesStateRetriever();
+
 		return InputDevicesStateRetriever(*GameWindow);
 	}
 
 	double Game::GetProgramRuntime() const
 	{
+		if (GameManager::IsHeadless())
+			return HeadlessRuntime;
+
 		return glfwGetTime();
 	}
 
@@ -251,14 +287,23 @@ namespace GEE
 	void Game::SetActiveScene(GameScene* scene)
 	{
 		ActiveScene = scene;
-		glfwSetWindowUserPointer(GameWindow, scene);
+		if (GameWindow)
+			glfwSetWindowUserPointer(GameWindow, scene);
 	}
 
 	void Game::SetCursorIcon(DefaultCursorIcon icon)
 	{
+		if (!GameWindow)
+			return;
+
 		glfwSetCursor(GameWindow, glfwCreateStandardCursor(static_cast<int>(icon)));
 	}
 
+	AsyncTreeLoader& Game::GetTreeLoader()
+	{
+		return TreeLoader;
+	}
+
 	Hierarchy::Tree* Game::FindHierarchyTree(const std::string& name, Hierarchy::Tree* treeToIgnore)
 	{
 		for (auto& it : Scenes)
@@ -283,12 +328,12 @@ namespace GEE
 
 	void Game::PreGameLoop()
 	{
-		float lastUpdateTime = (float)glfwGetTime();
+		float lastUpdateTime = (float)GetProgramRuntime();
 		const float timeStep = 1.0f / 60.0f;
 		float deltaTime = 0.0f;
 		TimeAccumulator = 0.0f;
 
-		LoopBeginTime = (float)glfwGetTime();
+		LoopBeginTime = (float)GetProgramRuntime();
 
 		//AddActorToScene(MakeShared<FPSController>(FPSController(this, "MojTestowyController")));
 		//Scenes[0]->AddActorToRoot(MakeShared<UIButtonActor>(UIButtonActor(Scenes[0].get(), "MojTestowyButton")));
@@ -303,29 +348,54 @@ namespace GEE
 		if (bGameTerminated)
 			return true;
 
-		glfwPollEvents();
+		GEE_PROFILE_SCOPE("Frame");
+		if (InputRecorder& inputRecorder = InputRecorder::Get(); (inputRecorder.IsRecording() || inputRecorder.IsReplaying()) && !inputRecorder.BeginFrame(*this, EventHolderObj, timeStep, deltaTime, TotalTickCount))
+		{
+			TerminateGame();	// the replayed session has ended
+			return true;
+		}
+		if (mouseController && InputRecorder::Get().IsReplaying())
+			for (const InputRecorder::ControllerMouseMovement& movement : InputRecorder::Get().GetReplayedControllerMouseMovements())
+				mouseController->OnMouseMovement(movement.PreviousPosPx, movement.CurrentPosPx, movement.WindowSize);
+
+		const bool bHeadless = GameManager::IsHeadless();
+		if (!bHeadless)
+			glfwPollEvents();
 
 		if (deltaTime > 0.25)
 			deltaTime = 0.25;
 
-		float fraction = fmod((float)glfwGetTime(), 1.0f);
-		if (fraction < 0.1 && !wasSecondFPS)
+		if (bHeadless)
+			HeadlessRuntime += deltaTime;
+		else
 		{
-			std::cout << "******Frames per second: " << (float)ticks / (glfwGetTime() - LoopBeginTime) << "			Milliseconds per frame: " << (glfwGetTime() - LoopBeginTime) * 1000.0f / (float)ticks << '\n';
-			wasSecondFPS = true;
-			ticks = 0;
-			timeSum = 0.0;
-			LoopBeginTime = glfwGetTime();
-		}
-		else if (fraction > 0.9)
-			wasSecondFPS = false;
+			float fraction = fmod((float)glfwGetTime(), 1.0f);
+			if (fraction < 0.1 && !wasSecondFPS)
+			{
+				std::cout << "******Frames per second: " << (float)ticks / (glfwGetTime() - LoopBeginTime) << "			Milliseconds per frame: " << (glfwGetTime() - LoopBeginTime) * 1000.0f / (float)ticks << '\n';
+				if (AllocationCounter::IsEnabled())
+					std::cout << "******Heap allocations while rendering the last frame: " << AllocationCounter::GetLastSectionAllocationCount() << '\n';
+				wasSecondFPS = true;
+				ticks = 0;
+				timeSum = 0.0;
+				LoopBeginTime = glfwGetTime();
+			}
+			else if (fraction > 0.9)
+				wasSecondFPS = false;
 
-		if (GLenum error = glGetError())
-		{
-			std::cout << "OpenGL Error: " << error << ".\n";
+			if (GLenum error = glGetError())
+			{
+				std::cout << "OpenGL Error: " << error << ".\n";
+			}
 		}
 
+		// Event handlers can modify the physics scenes, so the asynchronous step which was started during the previous frame has to be finished first.
+		PhysicsEng.FetchResults();
 		HandleEvents();
+		{
+			GEE_PROFILE_SCOPE("Hierarchy tree loading");
+			TreeLoader.Update();
+		}
 
 		TimeAccumulator += deltaTime;
 
@@ -337,7 +407,24 @@ namespace GEE
 			TotalTickCount++;
 		}
 
-		Render();
+		if (PhysicsEng.IsTransformInterpolationEnabled())
+			PhysicsEng.InterpolateTransforms(static_cast<float>(TimeAccumulator / timeStep));
+
+		if (!bHeadless)
+		{
+			AllocationCounter::BeginSection();
+			{
+				GEE_PROFILE_SCOPE("Render");
+				GpuProfiler::BeginFrame();
+				Render();
+			}
+			AllocationCounter::EndSection();
+		}
+
+		{
+			GEE_PROFILE_SCOPE("Waiting for frame jobs");
+			JobSystem::Get().EndFrame();
+		}
 		ticks++;
 		TotalFrameCount++;
 
@@ -346,27 +433,39 @@ namespace GEE
 
 	void Game::HandleEvents()
 	{
+		GEE_PROFILE_SCOPE("Event handling");
 		for (auto& scene : Scenes)
 		{
-			while (SharedPtr<Event> polledEvent = EventHolderObj.PollEvent(*scene))
-			{
-				if (polledEvent->GetEventRoot() && &polledEvent->GetEventRoot()->GetScene() == scene.get())
-					polledEvent->GetEventRoot()->HandleEventAll(*polledEvent);
+			EventHolderObj.DrainEvents(*scene, [&scene](Event& polledEvent) {
+				if (polledEvent.GetEventRoot() && &polledEvent.GetEventRoot()->GetScene() == scene.get())
+					polledEvent.GetEventRoot()->HandleEventAll(polledEvent);
 				else
-					scene->RootActor->HandleEventAll(*polledEvent);
-			}
+					scene->RootActor->HandleEventAll(polledEvent);
+			});
 		}
 	}
 
 	void Game::Update(Time deltaTime)
 	{
+		GEE_PROFILE_SCOPE("Update");
 		DUPA::AnimTime += deltaTime;
-		PhysicsEng.Update(deltaTime);
+
+		// In the asynchronous mode, the step started at the end of the previous update is finished here and the next one is started at the end of this update, so it is simulated while the frame is rendered.
+		if (PhysicsEng.IsAsyncSimulationEnabled())
+			PhysicsEng.FetchResults();
+		else
+			PhysicsEng.Update(deltaTime);
 
 		for (int i = 0; i < static_cast<int>(Scenes.size()); i++)
 			Scenes[i]->Update(deltaTime);
 
-		AudioEng.Update();
+		{
+			GEE_PROFILE_SCOPE("Audio");
+			AudioEng.Update();
+		}
+
+		if (PhysicsEng.IsAsyncSimulationEnabled())
+			PhysicsEng.Simulate(deltaTime);
 
 		Interpolations.erase(std::remove_if(Interpolations.begin(), Interpolations.end(), [deltaTime](UniquePtr<Interpolation>& interp) { return interp->UpdateT(deltaTime); }), Interpolations.end());
 	}
@@ -390,6 +489,8 @@ namespace GEE
 	void Game::DeleteScene(GameScene& scene)
 	{
 		std::cout << "Deleting scene " << scene.GetName() << '\n';
+		TreeLoader.CancelScene(scene);
+		EventHolderObj.RemoveScene(scene);
 		scene.GetRootActor()->Delete();
 		Scenes.erase(std::remove_if(Scenes.begin(), Scenes.end(), [&scene](UniquePtr<GameScene>& sceneVec) { return sceneVec.get() == &scene; }), Scenes.end());
 	}
@@ -402,8 +503,24 @@ namespace GEE
 		return renderDatas;
 	}
 
+	template <typename EventClass>
+	void WindowEventProcessor::PushWindowEvent(GameScene& scene, const EventClass& windowEvent)
+	{
+		// The recorded events replace the events of the window while the input is replayed.
+		InputRecorder& recorder = InputRecorder::Get();
+		if (recorder.IsReplaying())
+			return;
+		if (recorder.IsRecording())
+			recorder.RecordEvent(scene, windowEvent);
+
+		TargetHolder->PushEvent(scene, windowEvent);
+	}
+
 	void WindowEventProcessor::CursorPosCallback(SystemWindow* window, double xpos, double ypos)
 	{
+		if (InputRecorder::Get().IsReplaying())	// the mouse controller must not be moved by the live cursor either
+			return;
+
 		Vec2i windowSize(0);
 		glfwGetWindowSize(window, &windowSize.x, &windowSize.y);
 
@@ -412,15 +529,15 @@ namespace GEE
 
 		GameScene& gameScene = *GetGameSceneFromWindow(*window);
 
-		TargetHolder->PushEvent(gameScene, CursorMoveEvent(EventType::MouseMoved, Vec2f(xpos, ypos), windowSize));
+		PushWindowEvent(gameScene, CursorMoveEvent(EventType::MouseMoved, Vec2f(xpos, ypos), windowSize));
 
 		if (!mouseController || !TargetHolder)
 			return;
 
 
-		mouseController->OnMouseMovement(
-			Vec2i(PrevCursorPositions[window].x, windowSize.y - PrevCursorPositions[window].y),
-			Vec2f(xpos, ypos), windowSize); //Implement it as an Event instead! TODO
+		const InputRecorder::ControllerMouseMovement movement{ Vec2f(PrevCursorPositions[window].x, windowSize.y - PrevCursorPositions[window].y), Vec2f(xpos, ypos), Vec2u(windowSize) };
+		InputRecorder::Get().RecordControllerMouseMovement(movement);	// it is not an event, so it is recorded separately
+		mouseController->OnMouseMovement(movement.PreviousPosPx, movement.CurrentPosPx, movement.WindowSize); //Implement it as an Event instead! TODO
 
 		if (mouseController->GetLockMouseAtCenter())
 			glfwSetCursorPos(window, PrevCursorPositions[window].x,  PrevCursorPositions[window].y);
@@ -431,19 +548,19 @@ namespace GEE
 	void WindowEventProcessor::MouseButtonCallback(SystemWindow* window, int button, int action, int mods)
 	{
 		GameScene& gameScene = *GetGameSceneFromWindow(*window);
-		TargetHolder->PushEvent(gameScene, MouseButtonEvent((action == GLFW_PRESS) ? (EventType::MousePressed) : (EventType::MouseReleased), static_cast<MouseButton>(button), mods));
+		PushWindowEvent(gameScene, MouseButtonEvent((action == GLFW_PRESS) ? (EventType::MousePressed) : (EventType::MouseReleased), static_cast<MouseButton>(button), mods));
 	}
 
 	void WindowEventProcessor::KeyPressedCallback(SystemWindow* window, int key, int scancode, int action, int mods)
 	{
 		GameScene& gameScene = *GetGameSceneFromWindow(*window);
-		TargetHolder->PushEvent(gameScene, KeyEvent((action == GLFW_PRESS) ? (EventType::KeyPressed) : ((action == GLFW_REPEAT) ? (EventType::KeyRepeated) : (EventType::KeyReleased)), static_cast<Key>(key), mods));
+		PushWindowEvent(gameScene, KeyEvent((action == GLFW_PRESS) ? (EventType::KeyPressed) : ((action == GLFW_REPEAT) ? (EventType::KeyRepeated) : (EventType::KeyReleased)), static_cast<Key>(key), mods));
 	}
 
 	void WindowEventProcessor::CharEnteredCallback(SystemWindow* window, unsigned int codepoint)
 	{
 		GameScene& gameScene = *GetGameSceneFromWindow(*window);
-		TargetHolder->PushEvent(gameScene, CharEnteredEvent(EventType::CharacterEntered, codepoint));
+		PushWindowEvent(gameScene, CharEnteredEvent(EventType::CharacterEntered, codepoint));
 	}
 
 	void WindowEventProcessor::ScrollCallback(SystemWindow* window, double offsetX, double offsetY)
@@ -455,8 +572,8 @@ namespace GEE
 		Vec2i windowSize(0);
 		glfwGetWindowSize(window, &windowSize.x, &windowSize.y);
 
-		TargetHolder->PushEvent(gameScene, MouseScrollEvent(EventType::MouseScrolled, Vec2f(static_cast<float>(-offsetX), static_cast<float>(offsetY))));
-		TargetHolder->PushEvent(gameScene, CursorMoveEvent(EventType::MouseMoved, static_cast<Vec2f>(cursorPos), windowSize));	//When we scroll (e.g. a canvas), it is possible that some buttons or other objects relying on cursor position might be scrolled (moved) as well, so we need to create a CursorMoveEvent.
+		PushWindowEvent(gameScene, MouseScrollEvent(EventType::MouseScrolled, Vec2f(static_cast<float>(-offsetX), static_cast<float>(offsetY))));
+		PushWindowEvent(gameScene, CursorMoveEvent(EventType::MouseMoved, static_cast<Vec2f>(cursorPos), windowSize));	//When we scroll (e.g. a canvas), it is possible that some buttons or other objects relying on cursor position might be scrolled (moved) as well, so we need to create a CursorMoveEvent.
 	}
 
 	void WindowEventProcessor::FileDropCallback(SystemWindow* window, int count, const char** paths)
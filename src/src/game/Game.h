@@ -5,12 +5,13 @@
 #include "GameSettings.h"
 #include "GameScene.h"
 #include <input/Event.h>
+#include <assetload/AsyncTreeLoader.h>
 
 namespace GEE
 {
 	/*
 		todo: comment explaining how to use the Game class
-		1. Call Init with the window that you created
+		1. Call Init with the window that you created (or InitHeadless to run without a window and an OpenGL context)
 		2. Call LoadSceneFromFile and load at least the Main Scene, otherwise there will be no scenes and the program will just shut down
 		3. Call PreGameLoop
 		4. Call GameLoopIteration on every iteration
@@ -21,6 +22,12 @@ namespace GEE
 	public:
 		Game(const ShadingAlgorithm&, const GameSettings&);
 		virtual void Init(SystemWindow* window, const Vec2u& windowSize);
+		/**
+		 * @brief Initializes the game without a window or an OpenGL context, e.g. to run simulations on servers with no GPU. Nothing is rendered and no input is received.
+		 * Meshes are loaded without uploading them to the GPU, so their bounds and collision data are still available, while textures, light probes and other render-only resources are not created.
+		 * @param enableAudio: pass true to open an audio device anyway
+		*/
+		virtual void InitHeadless(bool enableAudio = false);
 
 		bool LoadSceneFromFile(const String& path, const String& name = String());
 
@@ -50,7 +57,7 @@ namespace GEE
 		*/
 		InputDevicesStateRetriever GetDefInputRetriever() override;
 		/**
-		 * @return Amount of time (in seconds) which passed since the start of the program.
+		 * @return Amount of time (in seconds) which passed since the start of the program. Headless games return the time passed to GameLoopIteration instead, so they behave the same when they run faster than real time.
 		*/
 		Time GetProgramRuntime() const override;
 
@@ -71,6 +78,8 @@ namespace GEE
 
 		void SetCursorIcon(DefaultCursorIcon) override;
 
+		AsyncTreeLoader& GetTreeLoader() override;
+
 		Hierarchy::Tree* FindHierarchyTree(const std::string& name, Hierarchy::Tree* treeToIgnore = nullptr) override;
 		SharedPtr<Font> FindFont(const std::string& path) override;
 
@@ -109,12 +118,14 @@ namespace GEE
 		RenderEngine RenderEng;
 		Physics::PhysicsEngine PhysicsEng;
 		Audio::AudioEngine AudioEng;
+		AsyncTreeLoader TreeLoader;
 
 		const ShadingAlgorithm Shading;
 		bool GameStarted;
 		bool DebugMode;
 		Time LoopBeginTime;
 		Time TimeAccumulator;
+		Time HeadlessRuntime;
 
 		unsigned long long TotalTickCount, TotalFrameCount;
 	};
@@ -130,6 +141,11 @@ namespace GEE
 		static void CursorLeaveEnterCallback(SystemWindow*, int enter);
 
 		static GameScene* GetGameSceneFromWindow(SystemWindow&);
+		/**
+		 * @brief Pushes an event of the window to TargetHolder and records it if the input is being recorded (see InputRecorder).
+		*/
+		template <typename EventClass>
+		static void PushWindowEvent(GameScene&, const EventClass&);
 
 		static EventHolder* TargetHolder;
 		static std::unordered_map<SystemWindow*, Vec2i> PrevCursorPositions;
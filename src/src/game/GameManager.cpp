@@ -5,6 +5,7 @@ namespace GEE
 {
 	GameScene* GameManager::DefaultScene = nullptr;
 	GameManager* GameManager::GamePtr = nullptr;
+	bool GameManager::bHeadless = false;
 
 	bool HTreeObjectLoc::IsValidTreeElement() const
 	{
@@ -22,4 +23,9 @@ namespace GEE
 	{
 		return *GamePtr;
 	}
+
+	bool GameManager::IsHeadless()
+	{
+		return bHeadless;
+	}
 }
\ No newline at end of file
@@ -46,6 +46,7 @@ namespace GEE
 	class Event;
 	class EventPusher;
 	class GameScene;
+	class AsyncTreeLoader;
 	class GameSceneRenderData;
 
 	class Mesh;
@@ -62,6 +63,7 @@ namespace GEE
 
 	class SkeletonBatch;
 	class SkeletonInfo;
+	class RenderQueue;
 
 
 	struct GameSettings;
@@ -155,6 +157,19 @@ namespace GEE
 			virtual physx::PxController* CreateController(GameScenePhysicsData& scenePhysicsData, const Transform& t) = 0;
 			virtual physx::PxMaterial* CreateMaterial(float staticFriction, float dynamicFriction, float restitutionCoeff) = 0;
 
+			/**
+			 * @brief Waits for the simulation step which is in progress, if there is any. The physics scenes can only be modified (or their debug render buffers read) when no step is in progress.
+			*/
+			virtual void FetchResults() = 0;
+			/**
+			 * @brief Enables running each simulation step in parallel with rendering. See PhysicsEngine::SetAsyncSimulation().
+			*/
+			virtual void SetAsyncSimulation(bool enabled) = 0;
+			/**
+			 * @brief Enables rendering dynamic objects at poses interpolated between simulation steps. See PhysicsEngine::InterpolateTransforms().
+			*/
+			virtual void SetTransformInterpolation(bool enabled) = 0;
+
 			virtual ~PhysicsEngineManager() = default;
 		protected:
 			virtual void RemoveScenePhysicsDataPtr(GameScenePhysicsData& scenePhysicsData) = 0;
@@ -187,6 +202,11 @@ namespace GEE
 		virtual RenderToolboxCollection* GetCurrentTbCollection() = 0;
 		virtual Texture GetEmptyTexture() = 0;
 		virtual SkeletonBatch* GetBoundSkeletonBatch() = 0;
+		/**
+		 * @brief The queue used by Renderer::StaticMeshInstances(). Rendering happens on a single thread and this queue never contains Renderables, so it is never used recursively.
+		 * It is reused by every call, so the memory of its draws is not reallocated.
+		*/
+		virtual RenderQueue& GetMeshInstanceQueue() = 0;
 
 
 		//TODO: THIS SHOULD NOT BE HERE
@@ -238,6 +258,10 @@ namespace GEE
 	public:
 		static GameScene* DefaultScene;
 		static GameManager& Get();
+		/**
+		 * @brief Headless games have no window and no OpenGL context (see Game::InitHeadless()). Code which creates GPU resources skips it in headless games.
+		*/
+		static bool IsHeadless();
 	public:
 		virtual void AddInterpolation(const Interpolation&) = 0;
 		virtual GameScene& CreateScene(String name, bool disallowChangingNameIfTaken = true) = 0;
@@ -272,6 +296,8 @@ namespace GEE
 
 		virtual void SetCursorIcon(DefaultCursorIcon) = 0;
 
+		virtual AsyncTreeLoader& GetTreeLoader() = 0;
+
 		virtual Hierarchy::Tree* FindHierarchyTree(const String& name, Hierarchy::Tree* treeToIgnore = nullptr) = 0;
 		virtual SharedPtr<Font> FindFont(const std::string& path) = 0;
 
@@ -281,6 +307,7 @@ namespace GEE
 		virtual void DeleteScene(GameScene&) = 0;
 	private:
 		static GameManager* GamePtr;
+		static bool bHeadless;
 		friend class GameScene;
 		friend class Game;
 	};
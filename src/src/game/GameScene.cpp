@@ -9,6 +9,11 @@
 #include <physics/CollisionObject.h>
 #include <scene/hierarchy/HierarchyTree.h>
 #include <animation/SkeletonInfo.h>
+#include <rendering/RenderQueue.h>
+#include <math/TransformStore.h>
+#include <math/Simd.h>
+#include <utility/Jobs.h>
+#include <utility/ScopeProfiler.h>
 #include <UI/UICanvas.h>
 
 #include <input/InputDevicesStateRetriever.h>
@@ -22,11 +27,14 @@ namespace GEE
 		PhysicsData(MakeUnique<Physics::GameScenePhysicsData>(*this)),
 		AudioData(MakeUnique<Audio::GameSceneAudioData>(*this)),
 		UIData(nullptr),
+		SceneTransformStore(nullptr),
 		Name(name),
 		ActiveCamera(nullptr),
 		GameHandle(&gameHandle),
 		KillingProcessFrame(0),
-		bHasStarted(false)
+		bHasStarted(false),
+		bUseParallelUpdate(false),
+		bInParallelUpdate(false)
 	{
 		RootActor = MakeUnique<Actor>(*this, nullptr, "SceneRoot");
 	}
@@ -35,11 +43,14 @@ namespace GEE
 		PhysicsData(MakeUnique<Physics::GameScenePhysicsData>(*this)),
 		AudioData(MakeUnique<Audio::GameSceneAudioData>(*this)),
 		UIData(MakeUnique<GameSceneUIData>(*this, associatedWindow)),
+		SceneTransformStore(nullptr),
 		Name(name),
 		ActiveCamera(nullptr),
 		GameHandle(&gameHandle),
 		KillingProcessFrame(0),
-		bHasStarted(false)
+		bHasStarted(false),
+		bUseParallelUpdate(false),
+		bInParallelUpdate(false)
 	{
 		RootActor = MakeUnique<Actor>(*this, nullptr, "SceneRoot");
 	}
@@ -49,11 +60,14 @@ namespace GEE
 		RenderData(std::move(scene.RenderData)),
 		PhysicsData(std::move(scene.PhysicsData)),
 		AudioData(std::move(scene.AudioData)),
+		SceneTransformStore(nullptr),
 		Name(scene.Name),
 		ActiveCamera(scene.ActiveCamera),
 		GameHandle(scene.GameHandle),
 		KillingProcessFrame(scene.KillingProcessFrame),
-		bHasStarted(scene.bHasStarted)
+		bHasStarted(scene.bHasStarted),
+		bUseParallelUpdate(scene.bUseParallelUpdate),
+		bInParallelUpdate(false)
 	{
 		RootActor = MakeUnique<Actor>(*this, nullptr, "SceneRoot");
 	}
@@ -201,6 +215,7 @@ namespace GEE
 
 	void GameScene::Update(Time deltaTime)
 	{
+		GEE_PROFILE_SCOPE_STRING("Scene update: " + Name);
 		if (IsBeingKilled())
 		{
 			Delete();
@@ -209,9 +224,150 @@ namespace GEE
 		if (ActiveCamera && ActiveCamera->IsBeingKilled())
 			BindActiveCamera(nullptr);
 
+		if (bUseParallelUpdate)
+			UpdateParallelPhases(deltaTime);
+
 		RootActor->UpdateAll(deltaTime);
 		for (auto& it : RenderData->SkeletonBatches)
 			it->VerifySkeletonsLives();	//verify if any SkeletonInfos are invalid and get rid of any garbage objects
+
+		if (SceneTransformStore)
+		{
+			GEE_PROFILE_SCOPE("Transform store update");
+			SceneTransformStore->UpdateWorldTransforms();
+		}
+	}
+
+	void GameScene::SetUseTransformStore(bool use)
+	{
+		if (use && !SceneTransformStore)
+			SceneTransformStore = MakeUnique<TransformStore>(*RootActor->GetTransform());
+		else if (!use)
+			SceneTransformStore = nullptr;
+	}
+
+	TransformStore* GameScene::GetTransformStore()
+	{
+		return SceneTransformStore.get();
+	}
+
+	void GameScene::SetUseParallelUpdate(bool use)
+	{
+		GEE_CORE_ASSERT(!bInParallelUpdate);
+		bUseParallelUpdate = use;
+	}
+
+	void GameScene::DeferStructuralChange(std::function<void()> change)
+	{
+		std::lock_guard<std::recursive_mutex> lock(StructureMutex);
+		DeferredStructuralChanges.push_back(DeferredStructuralChange{ nullptr, nullptr, std::move(change) });
+	}
+
+	void GameScene::DeferAddComponent(Component& parent, UniquePtr<Component> component)
+	{
+		std::lock_guard<std::recursive_mutex> lock(StructureMutex);
+		DeferredStructuralChanges.push_back(DeferredStructuralChange{ &parent, std::move(component), nullptr });
+	}
+
+	std::unique_lock<std::recursive_mutex> GameScene::LockStructureDuringParallelUpdate()
+	{
+		if (!bInParallelUpdate)
+			return std::unique_lock<std::recursive_mutex>();
+
+		return std::unique_lock<std::recursive_mutex>(StructureMutex);
+	}
+
+	void GameScene::UpdateParallelPhases(Time deltaTime)
+	{
+		for (ComponentUpdatePhase phase : { ComponentUpdatePhase::Animation, ComponentUpdatePhase::Pose })
+		{
+			ParallelUpdateRoots.clear();
+			RootActor->CollectParallelUpdateRoots(phase, ParallelUpdateRoots);
+			if (ParallelUpdateRoots.empty())
+				continue;
+
+			SeparateConflictingParallelUpdateRoots(phase);
+
+			// Components may read the world transforms of their ancestors outside of the updated subtrees, which are shared between threads. Compute them now, so they are only read during the phase.
+			for (const auto& modifiedSubtrees : ParallelUpdateModifiedSubtrees)
+				for (Component* subtree : modifiedSubtrees)
+					if (const Transform* parentTransform = subtree->GetTransform().GetParentTransform())
+						parentTransform->GetWorldTransform();
+
+			bInParallelUpdate = true;
+			JobSystem::Get().ParallelFor(ParallelUpdateRoots.size(), 1, [this, phase, deltaTime](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i = begin; i < end; i++)
+						ParallelUpdateRoots[i]->UpdateAllInPhase(phase, deltaTime);
+				}).Wait();
+			for (Component* root : SerialUpdateRoots)
+				root->UpdateAllInPhase(phase, deltaTime);
+			bInParallelUpdate = false;
+
+			FlushDeferredStructuralChanges();
+		}
+	}
+
+	namespace
+	{
+		bool AreInSameBranch(Component* lhs, Component* rhs)
+		{
+			for (Component* ancestor = lhs; ancestor; ancestor = ancestor->GetParent())
+				if (ancestor == rhs)
+					return true;
+			for (Component* ancestor = rhs; ancestor; ancestor = ancestor->GetParent())
+				if (ancestor == lhs)
+					return true;
+
+			return false;
+		}
+	}
+
+	void GameScene::SeparateConflictingParallelUpdateRoots(ComponentUpdatePhase phase)
+	{
+		// A root modifies its own subtree and the external subtrees of the Components updated along with it (e.g. the skeletons animated by AnimationManagerComponents).
+		// If these subtrees overlap with the ones of an accepted root, updating both roots concurrently would be a data race, so the root is updated on the main thread after the parallel ones.
+		SerialUpdateRoots.clear();
+		ParallelUpdateModifiedSubtrees.clear();
+
+		std::vector<Component*> modifiedSubtrees;
+		std::size_t acceptedCount = 0;
+		for (Component* root : ParallelUpdateRoots)
+		{
+			modifiedSubtrees.clear();
+			modifiedSubtrees.push_back(root);
+			root->CollectParallelUpdateExternalSubtrees(phase, modifiedSubtrees);
+
+			bool conflicts = false;
+			for (const auto& acceptedSubtrees : ParallelUpdateModifiedSubtrees)
+				for (Component* acceptedSubtree : acceptedSubtrees)
+					for (Component* subtree : modifiedSubtrees)
+						conflicts = conflicts || AreInSameBranch(subtree, acceptedSubtree);
+
+			if (conflicts)
+			{
+				SerialUpdateRoots.push_back(root);
+				continue;
+			}
+
+			ParallelUpdateModifiedSubtrees.push_back(modifiedSubtrees);
+			ParallelUpdateRoots[acceptedCount++] = root;
+		}
+		ParallelUpdateRoots.resize(acceptedCount);
+	}
+
+	void GameScene::FlushDeferredStructuralChanges()
+	{
+		// Deferred changes are applied outside of the parallel phase, so they cannot defer further changes.
+		for (auto& change : DeferredStructuralChanges)
+		{
+			if (change.Parent)
+				change.Parent->AddComponent(std::move(change.AddedComponent));
+			else
+				change.Change();
+		}
+
+		DeferredStructuralChanges.clear();
 	}
 
 	void GameScene::BindActiveCamera(CameraComponent* cam)
@@ -226,7 +382,7 @@ namespace GEE
 
 	Actor* GameScene::FindActor(GEEID geeid)
 	{
-		return RootActor->FindActor(geeid);
+		return Registry.FindActor(geeid);
 	}
 
 	template<typename Archive>
@@ -274,6 +430,8 @@ namespace GEE
 
 	template void GameScene::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void GameScene::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void GameScene::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void GameScene::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 
 	GameScene::~GameScene()
 	{
@@ -323,9 +481,11 @@ namespace GEE
 		ProbesLoaded(false),
 		bIsAnUIScene(isAnUIScene),
 		bUIRenderableDepthsSortedDirtyFlag(false),
-		bLightProbesSortedDirtyFlag(false)
+		bLightProbesSortedDirtyFlag(false),
+		CullingStatsFrame(0),
+		SceneRenderQueue(MakeUnique<RenderQueue>())
 	{
-		if (LightProbes.empty() && RenderHandle->GetShadingModel() == ShadingAlgorithm::SHADING_PBR_COOK_TORRANCE)
+		if (LightProbes.empty() && RenderHandle->GetShadingModel() == ShadingAlgorithm::SHADING_PBR_COOK_TORRANCE && !GameManager::IsHeadless())
 		{
 			//LightProbeLoader::LoadLightProbeTextureArrays(this);
 			ProbeTexArrays->IrradianceMapArr.Bind(12);
@@ -520,6 +680,56 @@ namespace GEE
 		return SkeletonBatches[ID].get();
 	}
 
+	void GameSceneRenderData::UpdateWorldBounds() const
+	{
+		StaleBoundsRenderables.clear();
+		StaleLocalBounds.clear();
+		StaleWorldMatrices.clear();
+
+		Boxf<Vec3f> localBounds(Vec3f(0.0f), Vec3f(0.0f));
+		Mat4f worldMatrix;
+		for (const Renderable* renderable : Renderables)
+			if (renderable->GetStaleLocalBounds(localBounds, worldMatrix))
+			{
+				StaleBoundsRenderables.push_back(renderable);
+				StaleLocalBounds.push_back(localBounds);
+				StaleWorldMatrices.push_back(worldMatrix);
+			}
+
+		if (StaleBoundsRenderables.empty())
+			return;
+
+		StaleWorldBounds.assign(StaleLocalBounds.size(), localBounds);
+		Math::TransformBoxes(StaleLocalBounds.data(), StaleWorldMatrices.data(), StaleWorldBounds.data(), StaleWorldBounds.size());
+
+		for (std::size_t i = 0; i < StaleBoundsRenderables.size(); i++)
+			StaleBoundsRenderables[i]->SetWorldBoundsCache(StaleWorldBounds[i]);
+	}
+
+	void GameSceneRenderData::RecordCullingPass(const CullingPassStats& stats) const
+	{
+		unsigned long long currentFrame = GameManager::Get().GetTotalFrameCount();
+		if (currentFrame != CullingStatsFrame)
+		{
+			// Swap instead of moving so both vectors keep their capacity and no allocation happens in later frames
+			std::swap(LastFrameCullingStats, CurrentFrameCullingStats);
+			CurrentFrameCullingStats.clear();
+			CullingStatsFrame = currentFrame;
+		}
+
+		CurrentFrameCullingStats.push_back(stats);
+	}
+
+	const std::vector<CullingPassStats>& GameSceneRenderData::GetCullingStats() const
+	{
+		return LastFrameCullingStats;
+	}
+
+	RenderQueue& GameSceneRenderData::GetRenderQueue() const
+	{
+		return *SceneRenderQueue;
+	}
+
 	GameSceneRenderData::~GameSceneRenderData()
 	{
 		LightsBuffer.Dispose();
@@ -559,6 +769,7 @@ namespace GEE
 			object.ScenePhysicsData = this;
 			object.TransformPtr = &t;
 			object.TransformDirtyFlag = t.AddDirtyFlag();
+			t.SetChangeListener(&object.ChangeListener);
 
 			if (WasSetup)
 				PhysicsHandle->AddCollisionObjectToPxPipeline(*this, object);
@@ -574,10 +785,25 @@ namespace GEE
 					(*found)->ActorPtr->release();
 					(*found)->ActorPtr = nullptr;
 				}
+				if (object.TransformPtr && object.TransformPtr->GetChangeListener() == &object.ChangeListener)
+					object.TransformPtr->SetChangeListener(nullptr);
 				CollisionObjects.erase(found);
+
+				{
+					std::lock_guard<std::mutex> lock(TransformChangeQueueMutex);
+					TransformChangeQueue.erase(std::remove(TransformChangeQueue.begin(), TransformChangeQueue.end(), &object), TransformChangeQueue.end());
+					object.TransformChangeQueued = false;
+				}
+				ActiveCollisionObjects.erase(std::remove(ActiveCollisionObjects.begin(), ActiveCollisionObjects.end(), &object), ActiveCollisionObjects.end());
 			}
 		}
 
+		void GameScenePhysicsData::QueueTransformChange(CollisionObject& object)
+		{
+			std::lock_guard<std::mutex> lock(TransformChangeQueueMutex);
+			TransformChangeQueue.push_back(&object);
+		}
+
 		PhysicsEngineManager* GameScenePhysicsData::GetPhysicsHandle()
 		{
 			return PhysicsHandle;
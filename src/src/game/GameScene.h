@@ -1,13 +1,18 @@
 #pragma once
 #include <game/GameManager.h>
 #include <scene/Actor.h>
+#include <scene/ComponentRegistry.h>
 #include <utility/Utility.h>
+#include <math/Box.h>
+#include <mutex>
 
 namespace GEE
 {
 	class GameScene;
 	class Event;
 	class RenderableVolume;
+	class RenderQueue;
+	class TransformStore;
 
 	class GameSceneRenderData;
 	class GameSceneUIData;
@@ -90,11 +95,56 @@ namespace GEE
 		void HandleEventAll(const Event&);
 		void Update(Time deltaTime);
 
+		/**
+		 * @brief Enables or disables the TransformStore of this scene. When enabled, world transforms of all components are recomputed in a single linear pass at the end of every Update() instead of lazily, one by one, when they are first needed.
+		 * Recommended for scenes with many components that move every frame.
+		*/
+		void SetUseTransformStore(bool use);
+		/**
+		 * @return the TransformStore of this scene or nullptr if it is disabled.
+		*/
+		TransformStore* GetTransformStore();
+
+		/**
+		 * @brief Enables or disables the phased update of this scene. When enabled, Update() first runs the parallel phases (see ComponentUpdatePhase): every Component that declares one is updated on the worker threads of the JobSystem,
+		 * with independent subtrees (for example the skeletons of different characters) updated concurrently. The remaining Components are then updated serially, in hierarchy order, like before.
+		 * Actors and Components killed during the parallel phases are killed at the end of the phase. Components must not be added during them; queue the change with DeferStructuralChange() instead.
+		 * TransformChangeListeners of the Transforms modified in the parallel phases are notified on the worker threads.
+		*/
+		void SetUseParallelUpdate(bool use);
+		bool UsesParallelUpdate() const { return bUseParallelUpdate; }
+		/**
+		 * @return true while a parallel phase of Update() is running.
+		*/
+		bool IsInParallelUpdate() const { return bInParallelUpdate; }
+		/**
+		 * @brief Queues a structural change to be made once the current parallel phase is finished. Can be called from any thread.
+		*/
+		void DeferStructuralChange(std::function<void()> change);
+		/**
+		 * @brief Queues attaching a Component to its parent once the current parallel phase is finished. Can be called from any thread.
+		 * Only used by Component::AddComponent() when it is erroneously called during a parallel phase; the returned reference to an unattached Component is then the caller's bug.
+		*/
+		void DeferAddComponent(Component& parent, UniquePtr<Component> component);
+		/**
+		 * @brief During a parallel phase, locks the mutex that serializes structural changes of this scene (e.g. construction of Components, which may register themselves in scene-wide containers). Otherwise returns an empty lock.
+		*/
+		std::unique_lock<std::recursive_mutex> LockStructureDuringParallelUpdate();
+
 		void BindActiveCamera(CameraComponent*);
 
 		Actor* FindActor(std::string name);
+		/**
+		 * @brief O(1) - uses the ComponentRegistry of this scene.
+		*/
 		Actor* FindActor(GEEID geeid);
 
+		ComponentRegistry& GetComponentRegistry() { return Registry; }
+		/**
+		 * @return all live Components of CompClass type in this scene (see ComponentRegistry::GetComponents). Use it instead of Component::GetAllComponents when you need all Components of a type in the scene.
+		*/
+		template <typename CompClass> const std::vector<CompClass*>& GetComponents() { return Registry.GetComponents<CompClass>(); }
+
 		template <typename Archive> void Save(Archive& archive) const;
 		template <typename Archive> void Load(Archive& archive);
 
@@ -105,19 +155,39 @@ namespace GEE
 
 	private:
 		void Delete();
+		void UpdateParallelPhases(Time deltaTime);
+		/**
+		 * @brief Moves the roots in ParallelUpdateRoots, whose updates would modify the same Components as the updates of other roots, to SerialUpdateRoots.
+		*/
+		void SeparateConflictingParallelUpdateRoots(ComponentUpdatePhase phase);
+		void FlushDeferredStructuralChanges();
 
 	private:
 		std::string Name;
 		GameManager* GameHandle;
 
+		ComponentRegistry Registry;	// declared before RootActor, so Actors and Components can unregister themselves when they are destroyed
 		UniquePtr<Actor> RootActor;
 		UniquePtr<GameSceneRenderData> RenderData;
 		UniquePtr<Physics::GameScenePhysicsData> PhysicsData;
 		UniquePtr<Audio::GameSceneAudioData> AudioData;
 		UniquePtr<GameSceneUIData> UIData;
+		UniquePtr<TransformStore> SceneTransformStore;	// declared after RootActor so it is destroyed before the transforms it views
 
 		bool bHasStarted;
 
+		struct DeferredStructuralChange
+		{
+			Component* Parent;	// if not nullptr, AddedComponent is attached to it; otherwise Change is called
+			UniquePtr<Component> AddedComponent;
+			std::function<void()> Change;
+		};
+		bool bUseParallelUpdate, bInParallelUpdate;
+		std::vector<Component*> ParallelUpdateRoots, SerialUpdateRoots;
+		std::vector<std::vector<Component*>> ParallelUpdateModifiedSubtrees;	// subtrees modified by each accepted parallel update root
+		std::vector<DeferredStructuralChange> DeferredStructuralChanges;
+		std::recursive_mutex StructureMutex;	// recursive, because constructors of Components can create other Components
+
 	public:
 		std::vector<UniquePtr<Hierarchy::Tree>> HierarchyTrees;
 	private:
@@ -202,6 +272,17 @@ namespace GEE
 		SystemWindow* AssociatedWindow;
 	};
 
+	/**
+	 * @brief Frustum culling statistics of a single pass (a single call to SceneRenderer::RawRender).
+	*/
+	struct CullingPassStats
+	{
+		std::string PassName;	// name of the shader used in the pass
+		bool bShadowPass;
+		unsigned int TestedCount;	// number of renderables that were considered for rendering
+		unsigned int CulledCount;	// number of renderables skipped, because they were outside the frustum
+	};
+
 	class GameSceneRenderData : public GameSceneData
 	{
 	public:
@@ -251,6 +332,25 @@ namespace GEE
 		int GetBatchID(SkeletonBatch&) const;
 		SkeletonBatch* GetBatch(int ID);
 
+		/**
+		 * @brief Recomputes the stale world bounds of all Renderables (see Renderable::GetStaleLocalBounds()) with a single batched call. Called before the Renderables are culled.
+		*/
+		void UpdateWorldBounds() const;
+
+		/**
+		 * @brief Stores the culling statistics of a render pass. Statistics from previous frames are discarded automatically.
+		*/
+		void RecordCullingPass(const CullingPassStats&) const;
+		/**
+		 * @return the culling statistics of all passes rendered in the last complete frame.
+		*/
+		const std::vector<CullingPassStats>& GetCullingStats() const;
+
+		/**
+		 * @brief The queue is reused by every pass rendered by SceneRenderer::RawRender, so its memory is allocated only once.
+		*/
+		RenderQueue& GetRenderQueue() const;
+
 		~GameSceneRenderData();
 
 		//RenderableComponent* FindRenderable(std::string name);
@@ -296,6 +396,16 @@ namespace GEE
 		int LightBlockBindingSlot;
 		bool ProbesLoaded;
 
+	private:
+		mutable std::vector<CullingPassStats> CurrentFrameCullingStats, LastFrameCullingStats;
+		mutable unsigned long long CullingStatsFrame;
+		// Scratch arrays of UpdateWorldBounds(), kept so their memory is reused
+		mutable std::vector<const Renderable*> StaleBoundsRenderables;
+		mutable std::vector<Boxf<Vec3f>> StaleLocalBounds, StaleWorldBounds;
+		mutable std::vector<Mat4f> StaleWorldMatrices;
+		UniquePtr<RenderQueue> SceneRenderQueue;
+	public:
+
 		SharedPtr<LightProbeTextureArrays> ProbeTexArrays;
 	};
 
@@ -307,6 +417,10 @@ namespace GEE
 			GameScenePhysicsData(GameScene&);
 			void AddCollisionObject(CollisionObject&, Transform& t);
 			void EraseCollisionObject(CollisionObject&);
+			/**
+			 * @brief Queues the object, so its Transform is sent to PhysX before the next simulation step. Called by the object when its Transform changes; can be called from any thread.
+			*/
+			void QueueTransformChange(CollisionObject&);
 			Physics::PhysicsEngineManager* GetPhysicsHandle();
 			physx::PxScene* GetPxScene() { return PhysXScene; }
 
@@ -316,6 +430,9 @@ namespace GEE
 		private:
 			Physics::PhysicsEngineManager* PhysicsHandle;
 			std::vector<CollisionObject*> CollisionObjects;
+			std::vector<CollisionObject*> TransformChangeQueue;	// objects whose Transforms were changed by the engine since the last simulation step
+			std::mutex TransformChangeQueueMutex;
+			std::vector<CollisionObject*> ActiveCollisionObjects;	// objects moved by PhysX in the latest simulation step
 			physx::PxScene* PhysXScene;
 			physx::PxControllerManager* PhysXControllerManager;
 			bool WasSetup;
@@ -2,7 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <utility/CerealNames.h>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
 
 namespace GEE
 {
@@ -71,6 +71,8 @@ namespace GEE
 	}
 	template void GameSettings::Serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&);
 	template void GameSettings::Serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void GameSettings::Serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&);
+	template void GameSettings::Serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 
 	GameSettings::VideoSettings::VideoSettings():
 		Resolution(0.0f),
@@ -176,4 +178,6 @@ namespace GEE
 	}
 	template void GameSettings::VideoSettings::Serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&);
 	template void GameSettings::VideoSettings::Serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void GameSettings::VideoSettings::Serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&);
+	template void GameSettings::VideoSettings::Serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include <game/HeadlessGame.h>
+
+namespace GEE
+{
+	HeadlessGame::HeadlessGame(const GameSettings& settings, bool enableAudio) :
+		Game(settings.Video.Shading, settings)
+	{
+		Settings = MakeUnique<GameSettings>(settings);
+		InitHeadless(enableAudio);
+	}
+
+	bool HeadlessGame::LoadProject(const String& filepath)
+	{
+		if (!LoadSceneFromFile(filepath, "GEE_Main"))
+		{
+			std::cout << "ERROR: Cannot load project " << filepath << ".\n";
+			return false;
+		}
+
+		SetMainScene(GetScene("GEE_Main"));
+		SetActiveScene(GetMainScene());
+		GetMainScene()->MarkAsStarted();
+
+		return true;
+	}
+
+	unsigned long long HeadlessGame::RunFixedSteps(unsigned long long tickCount, Time timeStep)
+	{
+		// The time passed to each iteration is exactly one step, so every iteration runs exactly one update.
+		unsigned long long iterationCount = 0;
+		while ((tickCount == 0 || iterationCount < tickCount) && !GameLoopIteration(timeStep, timeStep))
+			iterationCount++;
+
+		return iterationCount;
+	}
+
+	void HeadlessGame::Render()
+	{
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <game/Game.h>
+
+namespace GEE
+{
+	/**
+	 * @brief A game without a window or an OpenGL context (see Game::InitHeadless()), for simulation-only instances like servers, AI training and load tests.
+	 * Nothing is rendered, so it can run faster than real time.
+	*/
+	class HeadlessGame : public Game
+	{
+	public:
+		HeadlessGame(const GameSettings&, bool enableAudio = false);
+
+		/**
+		 * @brief Loads a project file as the main scene.
+		 * @return false if the file could not be loaded.
+		*/
+		bool LoadProject(const String& filepath);
+
+		/**
+		 * @brief Runs game loop iterations of timeStep seconds each, as fast as possible. Call PreGameLoop() first.
+		 * @param tickCount: the number of iterations to run. Pass 0 to run until the game is terminated.
+		 * @return the number of iterations which were run
+		*/
+		unsigned long long RunFixedSteps(unsigned long long tickCount, Time timeStep = 1.0 / 60.0);
+
+		/**
+		 * @brief Does nothing; headless games never render.
+		*/
+		void Render() override;
+	};
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <input/Event.h>
+#include <algorithm>
 
 namespace GEE
 {
@@ -79,19 +80,140 @@ namespace GEE
 	{
 	}
 
+	unsigned int CharEnteredEvent::GetUnicode() const
+	{
+		return Unicode;
+	}
+
 	std::string CharEnteredEvent::GetUTF8() const
 	{
 		return std::string(1, static_cast<unsigned char>(Unicode));
 	}
 
-	SharedPtr<Event> EventHolder::PollEvent(GameScene& scene)
+	EventStorage::EventStorage() :
+		CopyFunc(nullptr),
+		BaseOffset(0)
+	{
+	}
+
+	EventStorage::EventStorage(const EventStorage& storage) :
+		EventStorage()
+	{
+		*this = storage;
+	}
+
+	EventStorage& EventStorage::operator=(const EventStorage& storage)
+	{
+		if (&storage == this)
+			return *this;
+
+		Reset();
+		if (storage.CopyFunc)
+		{
+			storage.CopyFunc(storage.Storage, Storage);
+			CopyFunc = storage.CopyFunc;
+			BaseOffset = storage.BaseOffset;
+		}
+
+		return *this;
+	}
+
+	EventStorage::~EventStorage()
+	{
+		Reset();
+	}
+
+	Event& EventStorage::Get()
+	{
+		GEE_CORE_ASSERT(CopyFunc);
+		return *std::launder(reinterpret_cast<Event*>(Storage + BaseOffset));
+	}
+
+	void EventStorage::Reset()
+	{
+		if (!CopyFunc)
+			return;
+
+		Get().~Event();
+		CopyFunc = nullptr;
+	}
+
+	EventQueue::EventQueue() :
+		Slots(64),
+		Head(0),
+		Count(0)
+	{
+	}
+
+	void EventQueue::Push(const EventStorage& _event)
+	{
+		PushSlot() = _event;
+	}
+
+	bool EventQueue::Pop(EventStorage& outEvent)
+	{
+		if (Count == 0)
+			return false;
+
+		outEvent = Slots[Head];
+		Slots[Head].Reset();
+		Head = (Head + 1) % Slots.size();
+		Count--;
+
+		return true;
+	}
+
+	void EventQueue::Clear()
+	{
+		for (; Count > 0; Count--)
+		{
+			Slots[Head].Reset();
+			Head = (Head + 1) % Slots.size();
+		}
+	}
+
+	EventStorage& EventQueue::PushSlot()
+	{
+		if (Count == Slots.size())
+		{
+			// Unwrap the events to the beginning of a twice as large buffer.
+			std::vector<EventStorage> grownSlots(Slots.size() * 2);
+			for (std::size_t i = 0; i < Count; i++)
+				grownSlots[i] = Slots[(Head + i) % Slots.size()];
+
+			Slots = std::move(grownSlots);
+			Head = 0;
+		}
+
+		return Slots[(Head + Count++) % Slots.size()];
+	}
+
+	EventHolder::EventHolder() :
+		bHasConcurrentEvents(false)
+	{
+	}
+
+	void EventHolder::RemoveScene(GameScene& scene)
+	{
+		Events.erase(&scene);
+
+		std::lock_guard<std::mutex> lock(ConcurrentEventsMutex);
+		ConcurrentEvents.erase(std::remove_if(ConcurrentEvents.begin(), ConcurrentEvents.end(), [&scene](const std::pair<GameScene*, EventStorage>& concurrentEvent) { return concurrentEvent.first == &scene; }), ConcurrentEvents.end());
+	}
+
+	void EventHolder::CollectConcurrentEvents()
 	{
-		if (Events[&scene].empty())
-			return nullptr;
+		if (!bHasConcurrentEvents.load(std::memory_order_acquire))
+			return;
 
-		auto polledEvent = Events[&scene].front();
-		Events[&scene].pop();
+		{
+			std::lock_guard<std::mutex> lock(ConcurrentEventsMutex);
+			ConcurrentEvents.swap(CollectedConcurrentEvents);
+			bHasConcurrentEvents.store(false, std::memory_order_relaxed);
+		}
 
-		return polledEvent;
+		for (auto& [scene, concurrentEvent] : CollectedConcurrentEvents)
+			Events[scene].Push(concurrentEvent);
+		CollectedConcurrentEvents.clear();
 	}
 }
@@ -1,8 +1,16 @@
 #pragma once
 #include <utility/Utility.h>
 #include <glfw/glfw3.h>
-#include <queue>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <map>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace GEE
 {
@@ -252,6 +260,7 @@ namespace GEE
 	{
 	public:
 		CharEnteredEvent(EventType, unsigned int unicode, Actor* eventRoot = nullptr);
+		unsigned int GetUnicode() const;
 		std::string GetUTF8() const;
 
 	private:
@@ -259,19 +268,103 @@ namespace GEE
 	};
 
 	/**
-	 * @brief General class for holding all events in a Game.
+	 * @brief Holds an event of any class derived from Event by value, so storing it does not allocate. The class must fit in MaxEventSize bytes.
+	*/
+	class EventStorage
+	{
+	public:
+		static constexpr std::size_t MaxEventSize = 48;
+
+		EventStorage();
+		template <typename EventClass>
+		explicit EventStorage(const EventClass&);
+		EventStorage(const EventStorage&);
+		EventStorage& operator=(const EventStorage&);
+		~EventStorage();
+
+		template <typename EventClass>
+		void Emplace(const EventClass&);
+		bool IsEmpty() const { return CopyFunc == nullptr; }
+		Event& Get();
+		void Reset();
+
+	private:
+		alignas(std::max_align_t) unsigned char Storage[MaxEventSize];
+		// Copy-constructs the stored event in another storage; the class of the event is only known when it is stored. nullptr if the storage is empty.
+		void (*CopyFunc)(const unsigned char* source, unsigned char* destination);
+		std::uint8_t BaseOffset;	// the offset of the Event base class in the stored event
+	};
+
+	/**
+	 * @brief Ring buffer of events. Its capacity only grows (twofold) when it is full, so a queue which has reached its usual size does not allocate anymore.
+	*/
+	class EventQueue
+	{
+	public:
+		EventQueue();
+
+		template <typename EventClass>
+		void Push(const EventClass&);
+		void Push(const EventStorage&);
+		/**
+		 * @brief Moves the oldest event to outEvent.
+		 * @return false if the queue is empty
+		*/
+		bool Pop(EventStorage& outEvent);
+		bool IsEmpty() const { return Count == 0; }
+		void Clear();
+
+	private:
+		/**
+		 * @return the empty slot after the newest event
+		*/
+		EventStorage& PushSlot();
+
+		std::vector<EventStorage> Slots;
+		std::size_t Head, Count;
+	};
+
+	/**
+	 * @brief General class for holding all events in a Game. Each scene has its own EventQueue.
+	 * Events are pushed and drained by the main thread; worker threads use PushEventFromAnyThread().
 	*/
 	class EventHolder
 	{
 	public:
-		SharedPtr<Event> PollEvent(GameScene&);
+		EventHolder();
+
 		template <typename EventClass>
 		void PushEvent(GameScene&, const EventClass& _event);
 		template <typename EventClass>
 		void PushEventInActiveScene(GameManager&, const EventClass& _event);
+		/**
+		 * @brief Thread-safe version of PushEvent(), for worker threads (e.g. asset loaders or physics callbacks). The event is moved to the queue of the scene when events are drained next time.
+		*/
+		template <typename EventClass>
+		void PushEventFromAnyThread(GameScene&, const EventClass& _event);
+
+		/**
+		 * @brief Calls func(Event&) for every event of the scene in the order they were pushed, including the events which func pushes to the scene. The event is only valid during the call.
+		*/
+		template <typename Func>
+		void DrainEvents(GameScene&, Func&& func);
+		/**
+		 * @brief Drops the events and the queue of a scene which is being deleted. Must not be called while the events of the scene are being drained.
+		*/
+		void RemoveScene(GameScene&);
 
 	private:
-		std::map<GameScene*, std::queue<SharedPtr<Event>>> Events;
+		/**
+		 * @brief Moves the events pushed by PushEventFromAnyThread() to the queues of their scenes.
+		*/
+		void CollectConcurrentEvents();
+
+		// Elements of an unordered_map are never moved, so a reference to a queue stays valid until its scene is removed (see RemoveScene()).
+		std::unordered_map<const GameScene*, EventQueue> Events;
+
+		std::mutex ConcurrentEventsMutex;	// guards ConcurrentEvents
+		std::vector<std::pair<GameScene*, EventStorage>> ConcurrentEvents, CollectedConcurrentEvents;	// swapped when collected, so their capacity is reused
+		std::atomic<bool> bHasConcurrentEvents;
 	};
 
 	/**
@@ -285,6 +378,14 @@ namespace GEE
 		{
 			_EventHolder.PushEvent<EventClass>(Scene, _event);
 		}
+		/**
+		 * @brief Can be called from any thread; see EventHolder::PushEventFromAnyThread().
+		*/
+		template <typename EventClass>
+		void PushEventFromAnyThread(const EventClass& _event)
+		{
+			_EventHolder.PushEventFromAnyThread<EventClass>(Scene, _event);
+		}
 	private:
 		EventPusher(GameScene& scene, EventHolder& evHolder) : Scene(scene), _EventHolder(evHolder) {}
 
@@ -294,10 +395,35 @@ namespace GEE
 		EventHolder& _EventHolder;
 	};
 
+	template <typename EventClass>
+	inline EventStorage::EventStorage(const EventClass& storedEvent) :
+		EventStorage()
+	{
+		Emplace(storedEvent);
+	}
+
+	template <typename EventClass>
+	inline void EventStorage::Emplace(const EventClass& storedEvent)
+	{
+		static_assert(std::is_base_of_v<Event, EventClass>, "Only classes derived from Event can be stored.");
+		static_assert(sizeof(EventClass) <= MaxEventSize && alignof(EventClass) <= alignof(std::max_align_t), "The event class does not fit in EventStorage; increase EventStorage::MaxEventSize.");
+
+		Reset();
+		Event* base = new (Storage) EventClass(storedEvent);
+		BaseOffset = static_cast<std::uint8_t>(reinterpret_cast<unsigned char*>(base) - Storage);
+		CopyFunc = [](const unsigned char* source, unsigned char* destination) { new (destination) EventClass(*std::launder(reinterpret_cast<const EventClass*>(source))); };
+	}
+
+	template <typename EventClass>
+	inline void EventQueue::Push(const EventClass& _event)
+	{
+		PushSlot().Emplace(_event);
+	}
+
 	template<typename EventClass>
 	inline void EventHolder::PushEvent(GameScene& scene, const EventClass& _event)
 	{
-		Events[&scene].push(MakeShared<EventClass>(_event));
+		Events[&scene].Push(_event);
 	}
 	template<typename EventClass>
 	inline void EventHolder::PushEventInActiveScene(GameManager& gameHandle, const EventClass& _event)
@@ -305,4 +431,21 @@ namespace GEE
 		GEE_CORE_ASSERT(gameHandle.GetActiveScene());
 		PushEvent<EventClass>(*gameHandle.GetActiveScene(), _event);
 	}
+	template <typename EventClass>
+	inline void EventHolder::PushEventFromAnyThread(GameScene& scene, const EventClass& _event)
+	{
+		std::lock_guard<std::mutex> lock(ConcurrentEventsMutex);
+		ConcurrentEvents.emplace_back(&scene, EventStorage(_event));
+		bHasConcurrentEvents.store(true, std::memory_order_release);
+	}
+	template <typename Func>
+	inline void EventHolder::DrainEvents(GameScene& scene, Func&& func)
+	{
+		CollectConcurrentEvents();
+
+		EventQueue& queue = Events[&scene];
+		EventStorage polledEvent;
+		while (queue.Pop(polledEvent))	// the event is moved out of the queue first, because func can push more events to it
+			func(polledEvent.Get());
+	}
 }
\ No newline at end of file
@@ -1,19 +1,45 @@
 #include <input/InputDevicesStateRetriever.h>
+#include <input/InputRecorder.h>
 
 namespace GEE
 {
 	InputDevicesStateRetriever::InputDevicesStateRetriever(SystemWindow& window) :
-		WindowRef(window)
+		WindowPtr(&window)
+	{
+	}
+
+	InputDevicesStateRetriever::InputDevicesStateRetriever() :
+		WindowPtr(nullptr)
 	{
 	}
 
 	bool InputDevicesStateRetriever::IsMouseButtonPressed(MouseButton button) const
 	{
-		return glfwGetMouseButton(&WindowRef, static_cast<int>(button));
+		InputRecorder& recorder = InputRecorder::Get();
+		if (recorder.IsReplaying())
+			return recorder.GetReplayedMouseButtonState(button);
+		if (!WindowPtr)
+			return false;
+
+		const bool bPressed = glfwGetMouseButton(WindowPtr, static_cast<int>(button)) == GLFW_PRESS;
+		if (recorder.IsRecording())
+			recorder.RecordMouseButtonState(button, bPressed);
+
+		return bPressed;
 	}
 
 	bool InputDevicesStateRetriever::IsKeyPressed(const Key k) const
 	{
-		return glfwGetKey(&WindowRef, static_cast<int>(k)) == GLFW_PRESS;
+		InputRecorder& recorder = InputRecorder::Get();
+		if (recorder.IsReplaying())
+			return recorder.GetReplayedKeyState(k);
+		if (!WindowPtr)
+			return false;
+
+		const bool bPressed = glfwGetKey(WindowPtr, static_cast<int>(k)) == GLFW_PRESS;
+		if (recorder.IsRecording())
+			recorder.RecordKeyState(k, bPressed);
+
+		return bPressed;
 	}
 }
\ No newline at end of file
@@ -7,11 +7,18 @@ namespace GEE
 	{
 	public:
 		InputDevicesStateRetriever(SystemWindow&);
+		/**
+		 * @brief Creates a retriever which is not associated with any window (e.g. in headless games). No key or button is ever pressed then.
+		*/
+		InputDevicesStateRetriever();
+		/**
+		 * @brief While the input is replayed (see InputRecorder), the recorded states are returned instead of the states of the window.
+		*/
 		bool IsKeyPressed(const Key) const;
 		bool IsMouseButtonPressed(MouseButton) const;
 
 		friend class Game;
 	private:
-		SystemWindow& WindowRef;
+		SystemWindow* WindowPtr;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,388 @@
+#include <input/InputRecorder.h>
+#include <game/GameManager.h>
+#include <game/GameScene.h>
+#include <utility/CerealArchives.h>
+#include <cereal/types/string.hpp>
+
+namespace GEE
+{
+	namespace
+	{
+		const std::uint32_t InputLogMagic = 0x49454547;	// "GEEI"
+		const std::uint32_t InputLogVersion = 1;
+		const unsigned long long FramesPerFlush = 60;	// a log of a session which crashes loses at most this many frames
+
+		enum class InputRecordType : std::uint8_t
+		{
+			Frame,
+			SceneName,
+			Event,
+			KeyState,
+			MouseButtonState,
+			ControllerMouseMovement
+		};
+
+		template <typename Archive>
+		void SerializeVec2f(Archive& archive, Vec2f& vec)
+		{
+			archive(vec.x, vec.y);
+		}
+
+		template <typename Archive>
+		void SerializeVec2u(Archive& archive, Vec2u& vec)
+		{
+			std::uint32_t x = vec.x, y = vec.y;
+			archive(x, y);
+			vec = Vec2u(x, y);
+		}
+	}
+
+	InputRecorder& InputRecorder::Get()
+	{
+		static InputRecorder engineInputRecorder;
+		return engineInputRecorder;
+	}
+
+	InputRecorder::InputRecorder() :
+		FrameIndex(0),
+		bDesyncReported(false)
+	{
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		Stop();
+	}
+
+	bool InputRecorder::StartRecording(const String& filepath)
+	{
+		Stop();
+		OutputFile.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!OutputFile.good())
+		{
+			std::cout << "ERROR: Cannot open " << filepath << " to record the input.\n";
+			OutputFile.close();
+			return false;
+		}
+
+		Output = MakeUnique<cereal::PortableBinaryOutputArchive>(OutputFile);
+		(*Output)(InputLogMagic, InputLogVersion);
+		ResetStates();
+
+		std::cout << "INFO: Recording the input to " << filepath << ".\n";
+		return true;
+	}
+
+	bool InputRecorder::StartReplay(const String& filepath)
+	{
+		Stop();
+		InputFile.open(filepath, std::ios::in | std::ios::binary);
+		if (!InputFile.good())
+		{
+			std::cout << "ERROR: Cannot open input log " << filepath << ".\n";
+			InputFile.close();
+			return false;
+		}
+
+		std::uint32_t magic = 0, version = 0;
+		try
+		{
+			Input = MakeUnique<cereal::PortableBinaryInputArchive>(InputFile);	// reads the endianness of the file
+			(*Input)(magic, version);
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: Cannot read the header of input log " << filepath << " (" << exception.what() << ").\n";
+		}
+
+		if (magic != InputLogMagic || version != InputLogVersion)
+		{
+			std::cout << "ERROR: " << filepath << " is not an input log of version " << InputLogVersion << ".\n";
+			Stop();
+			return false;
+		}
+
+		ResetStates();
+		std::cout << "INFO: Replaying the input from " << filepath << ".\n";
+		return true;
+	}
+
+	void InputRecorder::Stop()
+	{
+		// Archives flush their data when they are destroyed, so they are destroyed before the files are closed (which flushes the rest of the log).
+		Output.reset();
+		Input.reset();
+		if (OutputFile.is_open())
+			OutputFile.close();
+		if (InputFile.is_open())
+			InputFile.close();
+	}
+
+	bool InputRecorder::BeginFrame(GameManager& gameHandle, EventHolder& eventHolder, Time& timeStep, Time& deltaTime, unsigned long long tickCount)
+	{
+		if (Output)
+		{
+			if (FrameIndex % FramesPerFlush == 0)
+				OutputFile.flush();
+			(*Output)(InputRecordType::Frame, timeStep, deltaTime, static_cast<std::uint64_t>(tickCount));
+			FrameIndex++;
+			return true;
+		}
+
+		if (!Input)
+			return true;
+
+		auto isNextRecord = [this](bool frame) {
+			const auto nextByte = InputFile.peek();
+			return nextByte != std::ifstream::traits_type::eof() && (static_cast<InputRecordType>(nextByte) == InputRecordType::Frame) == frame;
+		};
+
+		try
+		{
+			if (!isNextRecord(true))
+			{
+				std::cout << "INFO: Input replay finished after " << FrameIndex << " frames.\n";
+				Stop();
+				return false;
+			}
+
+			InputRecordType recordType;
+			std::uint64_t recordedTickCount = 0;
+			(*Input)(recordType, timeStep, deltaTime, recordedTickCount);
+			if (recordedTickCount != tickCount && !bDesyncReported)
+			{
+				std::cout << "WARNING: Input replay desynchronized at frame " << FrameIndex << ": " << tickCount << " ticks were run instead of " << recordedTickCount << ".\n";
+				bDesyncReported = true;
+			}
+			FrameIndex++;
+			ControllerMouseMovements.clear();
+
+			// The records of the frame are all the records up to the next frame.
+			while (isNextRecord(false))
+			{
+				(*Input)(recordType);
+				switch (recordType)
+				{
+				case InputRecordType::SceneName:
+				{
+					String sceneName;
+					(*Input)(sceneName);
+					SceneNames.push_back(sceneName);
+					break;
+				}
+				case InputRecordType::Event:
+				{
+					std::uint8_t eventType = 0;
+					std::uint16_t sceneIndex = 0;
+					(*Input)(eventType, sceneIndex);
+					GameScene* scene = (sceneIndex < SceneNames.size()) ? (gameHandle.GetScene(SceneNames[sceneIndex])) : (nullptr);
+					if (!scene && !bDesyncReported)
+					{
+						std::cout << "WARNING: Input replay desynchronized at frame " << FrameIndex << ": the scene of a recorded event does not exist.\n";
+						bDesyncReported = true;
+					}
+
+					// The payload is read even if the scene does not exist, so the next records can be read.
+					switch (const EventType type = static_cast<EventType>(eventType))
+					{
+					case EventType::MouseMoved:
+					{
+						Vec2f positionNDC(0.0f);
+						SerializeVec2f(*Input, positionNDC);
+						if (scene) eventHolder.PushEvent(*scene, CursorMoveEvent(type, positionNDC));
+						break;
+					}
+					case EventType::MousePressed:
+					case EventType::MouseReleased:
+					{
+						std::int32_t button = 0, modifierBits = 0;
+						(*Input)(button, modifierBits);
+						if (scene) eventHolder.PushEvent(*scene, MouseButtonEvent(type, static_cast<MouseButton>(button), modifierBits));
+						break;
+					}
+					case EventType::KeyPressed:
+					case EventType::KeyRepeated:
+					case EventType::KeyReleased:
+					{
+						std::int32_t key = 0, modifierBits = 0;
+						(*Input)(key, modifierBits);
+						if (scene) eventHolder.PushEvent(*scene, KeyEvent(type, static_cast<Key>(key), modifierBits));
+						break;
+					}
+					case EventType::CharacterEntered:
+					{
+						std::uint32_t unicode = 0;
+						(*Input)(unicode);
+						if (scene) eventHolder.PushEvent(*scene, CharEnteredEvent(type, unicode));
+						break;
+					}
+					case EventType::MouseScrolled:
+					{
+						Vec2f offset(0.0f);
+						SerializeVec2f(*Input, offset);
+						if (scene) eventHolder.PushEvent(*scene, MouseScrollEvent(type, offset));
+						break;
+					}
+					default:
+						if (scene) eventHolder.PushEvent(*scene, Event(type));
+						break;
+					}
+					break;
+				}
+				case InputRecordType::KeyState:
+				{
+					std::int32_t key = 0;
+					bool bPressed = false;
+					(*Input)(key, bPressed);
+					if (key >= 0 && key < static_cast<std::int32_t>(KeyStates.size()))
+						KeyStates[key] = static_cast<std::int8_t>(bPressed);
+					break;
+				}
+				case InputRecordType::MouseButtonState:
+				{
+					std::int32_t button = 0;
+					bool bPressed = false;
+					(*Input)(button, bPressed);
+					if (button >= 0 && button < static_cast<std::int32_t>(MouseButtonStates.size()))
+						MouseButtonStates[button] = static_cast<std::int8_t>(bPressed);
+					break;
+				}
+				case InputRecordType::ControllerMouseMovement:
+				{
+					ControllerMouseMovement movement{ Vec2f(0.0f), Vec2f(0.0f), Vec2u(0) };
+					SerializeVec2f(*Input, movement.PreviousPosPx);
+					SerializeVec2f(*Input, movement.CurrentPosPx);
+					SerializeVec2u(*Input, movement.WindowSize);
+					ControllerMouseMovements.push_back(movement);
+					break;
+				}
+				default:
+					std::cout << "ERROR: Unknown record in the input log at frame " << FrameIndex << ". Stopping the replay.\n";
+					Stop();
+					return false;
+				}
+			}
+		}
+		catch (cereal::Exception& exception)
+		{
+			std::cout << "ERROR: The input log is truncated at frame " << FrameIndex << " (" << exception.what() << "). Stopping the replay.\n";
+			Stop();
+			return false;
+		}
+
+		return true;
+	}
+
+	void InputRecorder::RecordEvent(const GameScene& scene, const Event& recordedEvent)
+	{
+		if (!Output || FrameIndex == 0)	// input which arrives before the first frame would not belong to any frame of the log
+			return;
+
+		const std::uint16_t sceneIndex = GetSceneIndex(scene.GetName());
+		(*Output)(InputRecordType::Event, static_cast<std::uint8_t>(recordedEvent.GetType()), sceneIndex);
+
+		// The class of each event pushed by the window is determined by its type.
+		switch (recordedEvent.GetType())
+		{
+		case EventType::MouseMoved:
+		{
+			Vec2f positionNDC = static_cast<const CursorMoveEvent&>(recordedEvent).GetNewPositionNDC();
+			SerializeVec2f(*Output, positionNDC);
+			break;
+		}
+		case EventType::MousePressed:
+		case EventType::MouseReleased:
+		{
+			const MouseButtonEvent& buttonEvent = static_cast<const MouseButtonEvent&>(recordedEvent);
+			(*Output)(static_cast<std::int32_t>(buttonEvent.GetButton()), static_cast<std::int32_t>(buttonEvent.GetModifierBits()));
+			break;
+		}
+		case EventType::KeyPressed:
+		case EventType::KeyRepeated:
+		case EventType::KeyReleased:
+		{
+			const KeyEvent& keyEvent = static_cast<const KeyEvent&>(recordedEvent);
+			(*Output)(static_cast<std::int32_t>(keyEvent.GetKeyCode()), static_cast<std::int32_t>(keyEvent.GetModifierBits()));
+			break;
+		}
+		case EventType::CharacterEntered:
+			(*Output)(static_cast<std::uint32_t>(static_cast<const CharEnteredEvent&>(recordedEvent).GetUnicode()));
+			break;
+		case EventType::MouseScrolled:
+		{
+			Vec2f offset = static_cast<const MouseScrollEvent&>(recordedEvent).GetOffset();
+			SerializeVec2f(*Output, offset);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void InputRecorder::RecordKeyState(Key key, bool pressed)
+	{
+		const int keyIndex = static_cast<int>(key);
+		if (!Output || FrameIndex == 0 || keyIndex < 0 || keyIndex >= static_cast<int>(KeyStates.size()) || KeyStates[keyIndex] == static_cast<std::int8_t>(pressed))
+			return;
+
+		KeyStates[keyIndex] = static_cast<std::int8_t>(pressed);
+		(*Output)(InputRecordType::KeyState, static_cast<std::int32_t>(keyIndex), pressed);
+	}
+
+	void InputRecorder::RecordMouseButtonState(MouseButton button, bool pressed)
+	{
+		const int buttonIndex = static_cast<int>(button);
+		if (!Output || FrameIndex == 0 || buttonIndex < 0 || buttonIndex >= static_cast<int>(MouseButtonStates.size()) || MouseButtonStates[buttonIndex] == static_cast<std::int8_t>(pressed))
+			return;
+
+		MouseButtonStates[buttonIndex] = static_cast<std::int8_t>(pressed);
+		(*Output)(InputRecordType::MouseButtonState, static_cast<std::int32_t>(buttonIndex), pressed);
+	}
+
+	void InputRecorder::RecordControllerMouseMovement(const ControllerMouseMovement& movement)
+	{
+		if (!Output || FrameIndex == 0)
+			return;
+
+		ControllerMouseMovement recordedMovement = movement;
+		(*Output)(InputRecordType::ControllerMouseMovement);
+		SerializeVec2f(*Output, recordedMovement.PreviousPosPx);
+		SerializeVec2f(*Output, recordedMovement.CurrentPosPx);
+		SerializeVec2u(*Output, recordedMovement.WindowSize);
+	}
+
+	bool InputRecorder::GetReplayedKeyState(Key key) const
+	{
+		const int keyIndex = static_cast<int>(key);
+		return keyIndex >= 0 && keyIndex < static_cast<int>(KeyStates.size()) && KeyStates[keyIndex] == 1;
+	}
+
+	bool InputRecorder::GetReplayedMouseButtonState(MouseButton button) const
+	{
+		const int buttonIndex = static_cast<int>(button);
+		return buttonIndex >= 0 && buttonIndex < static_cast<int>(MouseButtonStates.size()) && MouseButtonStates[buttonIndex] == 1;
+	}
+
+	void InputRecorder::ResetStates()
+	{
+		SceneIndices.clear();
+		SceneNames.clear();
+		KeyStates.assign(static_cast<std::size_t>(Key::Last) + 1, -1);
+		MouseButtonStates.assign(static_cast<std::size_t>(MouseButton::Last) + 1, -1);
+		ControllerMouseMovements.clear();
+		FrameIndex = 0;
+		bDesyncReported = false;
+	}
+
+	std::uint16_t InputRecorder::GetSceneIndex(const String& sceneName)
+	{
+		auto found = SceneIndices.find(sceneName);
+		if (found != SceneIndices.end())
+			return found->second;
+
+		const std::uint16_t sceneIndex = static_cast<std::uint16_t>(SceneIndices.size());
+		SceneIndices.emplace(sceneName, sceneIndex);
+		(*Output)(InputRecordType::SceneName, sceneName);
+		return sceneIndex;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <input/Event.h>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace cereal
+{
+	class PortableBinaryOutputArchive;
+	class PortableBinaryInputArchive;
+}
+
+namespace GEE
+{
+	class GameManager;
+
+	/**
+	 * @brief Records the input of a session to a binary log and replays it, so the exact frames of a slow session can be reproduced (and profiled).
+	 * The log contains, for every game loop iteration: its time step and delta time, the number of ticks run before it, the events pushed by the window and the states of the keys and mouse buttons polled through InputDevicesStateRetriever (only when they change).
+	 * The movements of the cursor passed directly to the mouse controller (see Controller::OnMouseMovement()) are recorded as well, because they do not go through events.
+	 * While replaying, the input of the window is ignored and the recorded frames are fed back in the same order. Loading trees asynchronously depends on the real time, so it can still make a replay diverge; a divergence is reported once, when the tick numbers stop matching.
+	 * Used by the thread which runs the game loop.
+	*/
+	class InputRecorder
+	{
+	public:
+		/**
+		 * @brief The arguments of a Controller::OnMouseMovement() call.
+		*/
+		struct ControllerMouseMovement
+		{
+			Vec2f PreviousPosPx, CurrentPosPx;
+			Vec2u WindowSize;
+		};
+
+		static InputRecorder& Get();
+
+		~InputRecorder();
+
+		/**
+		 * @brief Starts writing the input to the file. Stops the current recording or replay first.
+		 * @return false if the file could not be opened.
+		*/
+		bool StartRecording(const String& filepath);
+		/**
+		 * @brief Starts feeding the input recorded in the file to the game, from its next game loop iteration. Stops the current recording or replay first.
+		 * @return false if the file could not be opened or is not an input log.
+		*/
+		bool StartReplay(const String& filepath);
+		void Stop();
+
+		bool IsRecording() const { return Output != nullptr; }
+		bool IsReplaying() const { return Input != nullptr; }
+
+		/**
+		 * @brief Called by Game::GameLoopIteration() before the window events are polled.
+		 * Recording: writes the beginning of the frame. Replaying: replaces timeStep and deltaTime with the recorded ones, pushes the recorded events of the frame to the holder, applies the recorded input states and collects the recorded movements of the mouse controller (see GetReplayedControllerMouseMovements()).
+		 * @return false if the replay has ended (the replay is stopped then)
+		*/
+		bool BeginFrame(GameManager&, EventHolder&, Time& timeStep, Time& deltaTime, unsigned long long tickCount);
+
+		/**
+		 * @brief Records an event pushed by the window (see WindowEventProcessor). Events pushed by the engine itself are not recorded, because replaying the input pushes them again.
+		*/
+		void RecordEvent(const GameScene&, const Event&);
+		void RecordKeyState(Key, bool pressed);
+		void RecordMouseButtonState(MouseButton, bool pressed);
+		void RecordControllerMouseMovement(const ControllerMouseMovement&);
+
+		bool GetReplayedKeyState(Key) const;
+		bool GetReplayedMouseButtonState(MouseButton) const;
+		/**
+		 * @return the movements of the mouse controller recorded in the frame replayed by the last BeginFrame() call, in the recorded order. Game::GameLoopIteration() passes them to the current mouse controller.
+		*/
+		const std::vector<ControllerMouseMovement>& GetReplayedControllerMouseMovements() const { return ControllerMouseMovements; }
+
+	private:
+		InputRecorder();
+		void ResetStates();
+		/**
+		 * @brief Writes the scene name the first time an event of the scene is recorded, so events only refer to its index.
+		*/
+		std::uint16_t GetSceneIndex(const String& sceneName);
+
+		std::ofstream OutputFile;
+		std::ifstream InputFile;
+		UniquePtr<cereal::PortableBinaryOutputArchive> Output;
+		UniquePtr<cereal::PortableBinaryInputArchive> Input;
+
+		std::unordered_map<String, std::uint16_t> SceneIndices;	// recording
+		std::vector<String> SceneNames;	// replaying
+
+		// The last recorded or replayed state of each key and mouse button; -1 if it was never polled.
+		std::vector<std::int8_t> KeyStates, MouseButtonStates;
+		std::vector<ControllerMouseMovement> ControllerMouseMovements;	// replaying; of the current frame
+		unsigned long long FrameIndex;
+		bool bDesyncReported;
+	};
+}
\ No newline at end of file
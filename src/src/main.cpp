@@ -1,11 +1,15 @@
 #define STB_IMAGE_IMPLEMENTATION
 
 #include <editor/GameEngineEngineEditor.h>
+#include <game/HeadlessGame.h>
 #include <scene/LightProbeComponent.h>
 #include <UI/UICanvasField.h>
 #include <scene/GunActor.h>
 #include <scene/Controller.h>
 #include <editor/EditorActions.h>
+#include <input/InputRecorder.h>
+#include <utility/CommandLine.h>
+#include <chrono>
 
 
 using namespace GEE;
@@ -24,19 +28,65 @@ extern "C"
 
 Editor::EditorManager* Editor::EditorEventProcessor::EditorHandle = nullptr;
 
+const char* HeadlessUsage = "Usage: --headless <project filepath> [tick count (0 or none: until the process is stopped)]";
+
+/**
+ * @brief Simulates a project without a window or an OpenGL context, as fast as possible. See HeadlessUsage.
+*/
+int RunHeadless(const std::string& projectFilepath, unsigned long long tickCount)
+{
+	GameSettings settings;
+	HeadlessGame game(settings);
+	if (!game.LoadProject(projectFilepath))
+		return -1;
+
+	game.PreGameLoop();
+
+	const auto begin = std::chrono::steady_clock::now();
+	const unsigned long long iterationCount = game.RunFixedSteps(tickCount, 1.0 / 60.0);
+	const double realTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	std::cout << "INFO: Simulated " << game.GetProgramRuntime() << " s (" << iterationCount << " ticks) in " << realTime << " s.\n";
+	return 0;
+}
+
 
 int main(int argc, char** argv)
 {
 	std::string programFilepath;	//do not rely on this; if called from cmd, for example, it may not actually contain the program filepath
 	std::string projectFilepathArgument;
+	std::vector<std::string> arguments;
 	for (int i = 0; i < argc; i++)
 	{
 		std::cout << argv[i] << '\n';
-		switch (i)
+
+		// The input of any session can be recorded or replayed: --record-input <log filepath> or --replay-input <log filepath>
+		const std::string argument = argv[i];
+		if ((argument == "--record-input" || argument == "--replay-input") && i + 1 < argc)
 		{
-		case 0: programFilepath = argv[i]; break;
-		case 1: projectFilepathArgument = argv[i]; break;
+			if (!((argument == "--record-input") ? (InputRecorder::Get().StartRecording(argv[++i])) : (InputRecorder::Get().StartReplay(argv[++i]))))
+				return -1;
+			continue;
 		}
+
+		arguments.push_back(argument);
+	}
+
+	if (arguments.size() > 0)
+		programFilepath = arguments[0];
+	if (arguments.size() > 1)
+		projectFilepathArgument = arguments[1];
+
+	if (arguments.size() >= 2 && arguments[1] == "--headless")
+	{
+		unsigned long long tickCount = 0;
+		if (arguments.size() < 3 || (arguments.size() >= 4 && !CommandLine::ParseUnsigned(arguments[3], tickCount)))
+		{
+			std::cerr << HeadlessUsage << '\n';
+			return -1;
+		}
+
+		return RunHeadless(arguments[2], tickCount);
 	}
 
 	glfwInit();
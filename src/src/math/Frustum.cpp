@@ -0,0 +1,66 @@
+#include <math/Frustum.h>
+#include <math/Simd.h>
+
+namespace GEE
+{
+	Frustum::Frustum(const Mat4f& viewProjection)
+	{
+		// Gribb-Hartmann plane extraction. glm matrices are column-major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+		auto row = [&viewProjection](int i) { return Vec4f(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+		const Vec4f row0 = row(0), row1 = row(1), row2 = row(2), row3 = row(3);
+
+		Planes[static_cast<int>(Plane::Left)] = row3 + row0;
+		Planes[static_cast<int>(Plane::Right)] = row3 - row0;
+		Planes[static_cast<int>(Plane::Bottom)] = row3 + row1;
+		Planes[static_cast<int>(Plane::Top)] = row3 - row1;
+		Planes[static_cast<int>(Plane::Near)] = row3 + row2;	// OpenGL clip space depth range is [-w, w]
+		Planes[static_cast<int>(Plane::Far)] = row3 - row2;
+
+		for (auto& plane : Planes)
+		{
+			float length = glm::length(Vec3f(plane));
+			if (length > 0.0f)
+				plane /= length;
+		}
+	}
+
+	const Vec4f& Frustum::GetPlane(Plane plane) const
+	{
+		return Planes[static_cast<int>(plane)];
+	}
+
+	bool Frustum::Contains(const Vec3f& point) const
+	{
+		for (const auto& plane : Planes)
+			if (glm::dot(Vec3f(plane), point) + plane.w < 0.0f)
+				return false;
+
+		return true;
+	}
+
+	bool Frustum::Intersects(const Boxf<Vec3f>& worldBox) const
+	{
+		for (const auto& plane : Planes)
+		{
+			Vec3f normal(plane);
+			float projectedRadius = glm::dot(glm::abs(normal), worldBox.Size);
+			if (glm::dot(normal, worldBox.Position) + plane.w + projectedRadius < 0.0f)	// the box lies entirely behind this plane
+				return false;
+		}
+
+		return true;
+	}
+
+	Boxf<Vec3f> Math::TransformBox(const Boxf<Vec3f>& box, const Mat4f& matrix)
+	{
+		// Arvo's method: transform the center and project the half-extent onto each world axis using the absolute values of the matrix.
+		Boxf<Vec3f> transformed = box;
+		TransformBoxes(&box, &matrix, &transformed, 1);
+		return transformed;
+	}
+
+	Boxf<Vec3f> Math::BoxUnion(const Boxf<Vec3f>& lhs, const Boxf<Vec3f>& rhs)
+	{
+		return Boxf<Vec3f>::FromMinMaxCorners(glm::min(lhs.Position - lhs.Size, rhs.Position - rhs.Size), glm::max(lhs.Position + lhs.Size, rhs.Position + rhs.Size));
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <math/Box.h>
+
+namespace GEE
+{
+	/**
+	 * @brief A convex volume bounded by six planes, used for visibility tests (frustum culling).
+	 * The planes are extracted directly from a view-projection matrix, so the class works for both perspective and orthographic projections (e.g. shadow maps of directional lights).
+	 * Each plane is stored as (normal, distance), with the normal pointing towards the inside of the frustum.
+	*/
+	class Frustum
+	{
+	public:
+		enum class Plane
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far
+		};
+
+		/**
+		 * @param viewProjection: the matrix that transforms world space to clip space (Projection * View).
+		*/
+		Frustum(const Mat4f& viewProjection);
+
+		const Vec4f& GetPlane(Plane) const;
+
+		bool Contains(const Vec3f& point) const;
+		/**
+		 * @brief Conservative test - it might return true for some boxes that are near the corners of the frustum, but never returns false for a box that is actually visible.
+		 * @param worldBox: an axis-aligned box in world space (Position is the center, Size is the half-extent).
+		 * @return a boolean indicating whether the box is at least partially inside the frustum
+		*/
+		bool Intersects(const Boxf<Vec3f>& worldBox) const;
+
+	private:
+		Vec4f Planes[6];
+	};
+
+	namespace Math
+	{
+		/**
+		 * @brief Computes the axis-aligned box enclosing the passed box after it was transformed by the matrix.
+		 * @param box: the box (Position is the center, Size is the half-extent).
+		 * @param matrix: an affine transformation matrix (e.g. a world transform matrix of a component)
+		 * @return the transformed, axis-aligned box
+		*/
+		Boxf<Vec3f> TransformBox(const Boxf<Vec3f>& box, const Mat4f& matrix);
+		/**
+		 * @return the smallest axis-aligned box containing both passed boxes.
+		*/
+		Boxf<Vec3f> BoxUnion(const Boxf<Vec3f>& lhs, const Boxf<Vec3f>& rhs);
+	}
+}
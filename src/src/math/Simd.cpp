@@ -0,0 +1,276 @@
+#include <math/Simd.h>
+#include <math/Box.h>
+
+#ifdef GEE_SIMD_LEVEL_SSE4
+#include <immintrin.h>
+#endif
+
+#ifdef GLM_FORCE_QUAT_DATA_WXYZ
+#error "SIMD kernels expect quaternions stored as (x, y, z, w)."
+#endif
+
+namespace GEE
+{
+	static_assert(sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Quatf) == 4 * sizeof(float) && sizeof(Mat4f) == 16 * sizeof(float), "SIMD kernels expect tightly packed glm types.");
+	static_assert(sizeof(Boxf<Vec3f>) == 2 * sizeof(Vec3f), "SIMD kernels expect Boxf<Vec3f> to contain only its position and size.");
+
+#ifdef GEE_SIMD_LEVEL_AVX2
+	#ifdef __FMA__
+		#define GEE_SIMD_FMADD256(a, b, c) _mm256_fmadd_ps(a, b, c)
+	#else
+		#define GEE_SIMD_FMADD256(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+	#endif
+#endif
+
+	const char* Math::GetSimdInstructionSetName()
+	{
+	#if defined(GEE_SIMD_LEVEL_AVX2)
+		return "AVX2";
+	#elif defined(GEE_SIMD_LEVEL_SSE4)
+		return "SSE4.1";
+	#else
+		return "Scalar";
+	#endif
+	}
+
+	void Math::TRSToMatrices(const Vec3f* positions, const Quatf* rotations, const Vec3f* scales, Mat4f* outMatrices, std::size_t count)
+	{
+		std::size_t i = 0;
+
+	#ifdef GEE_SIMD_LEVEL_SSE4
+		// Four transforms at a time: transpose them to SoA, so every lane computes the same matrix element of a different transform. AVX2 builds use this path too - 8-wide transposes of 12-byte vectors do not pay off.
+		const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 qx = _mm_loadu_ps(&rotations[i].x), qy = _mm_loadu_ps(&rotations[i + 1].x), qz = _mm_loadu_ps(&rotations[i + 2].x), qw = _mm_loadu_ps(&rotations[i + 3].x);
+			_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+			const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+			const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+			const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+			const __m128 sx = _mm_set_ps(scales[i + 3].x, scales[i + 2].x, scales[i + 1].x, scales[i].x);
+			const __m128 sy = _mm_set_ps(scales[i + 3].y, scales[i + 2].y, scales[i + 1].y, scales[i].y);
+			const __m128 sz = _mm_set_ps(scales[i + 3].z, scales[i + 2].z, scales[i + 1].z, scales[i].z);
+
+			// Same elements as glm::mat4_cast, each column multiplied by the scale along its axis
+			__m128 c00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+			__m128 c01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+			__m128 c02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+			__m128 c03 = zero;
+
+			__m128 c10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+			__m128 c11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+			__m128 c12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+			__m128 c13 = zero;
+
+			__m128 c20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+			__m128 c21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+			__m128 c22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+			__m128 c23 = zero;
+
+			__m128 c30 = _mm_set_ps(positions[i + 3].x, positions[i + 2].x, positions[i + 1].x, positions[i].x);
+			__m128 c31 = _mm_set_ps(positions[i + 3].y, positions[i + 2].y, positions[i + 1].y, positions[i].y);
+			__m128 c32 = _mm_set_ps(positions[i + 3].z, positions[i + 2].z, positions[i + 1].z, positions[i].z);
+			__m128 c33 = one;
+
+			// Transpose back: after each transpose, the k-th register holds the column of the k-th transform
+			_MM_TRANSPOSE4_PS(c00, c01, c02, c03);
+			_MM_TRANSPOSE4_PS(c10, c11, c12, c13);
+			_MM_TRANSPOSE4_PS(c20, c21, c22, c23);
+			_MM_TRANSPOSE4_PS(c30, c31, c32, c33);
+
+			const __m128 columns[4][4] = { { c00, c10, c20, c30 }, { c01, c11, c21, c31 }, { c02, c12, c22, c32 }, { c03, c13, c23, c33 } };
+			for (int k = 0; k < 4; k++)
+				for (int column = 0; column < 4; column++)
+					_mm_storeu_ps(&outMatrices[i + k][column][0], columns[k][column]);
+		}
+	#endif
+
+		for (; i < count; i++)
+		{
+			Mat4f& mat = outMatrices[i];
+			mat = glm::mat4_cast(rotations[i]);
+			mat[0] *= scales[i].x;
+			mat[1] *= scales[i].y;
+			mat[2] *= scales[i].z;
+			mat[3] = Vec4f(positions[i], 1.0f);
+		}
+	}
+
+	Mat4f Math::TRSToMatrix(const Vec3f& position, const Quatf& rotation, const Vec3f& scale)
+	{
+		Mat4f mat;
+		TRSToMatrices(&position, &rotation, &scale, &mat, 1);
+		return mat;
+	}
+
+	namespace
+	{
+		/**
+		 * @brief Computes lhs[i * lhsStride] * rhs[i] for every element; a stride of 0 multiplies every element by the same matrix.
+		*/
+		void MultiplyMatricesStrided(const Mat4f* lhs, std::size_t lhsStride, const Mat4f* rhs, Mat4f* outMatrices, std::size_t count)
+		{
+		#if defined(GEE_SIMD_LEVEL_AVX2)
+			// Two result columns at a time: the lower lane computes column j, the upper lane column j + 1
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const float* l = &lhs[i * lhsStride][0][0];
+				const float* r = &rhs[i][0][0];
+				float* out = &outMatrices[i][0][0];
+
+				const __m256 l0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l)), l1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 4));
+				const __m256 l2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 8)), l3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 12));
+
+				const __m256 r01 = _mm256_loadu_ps(r), r23 = _mm256_loadu_ps(r + 8);
+				for (int half = 0; half < 2; half++)
+				{
+					const __m256 rCols = (half == 0) ? (r01) : (r23);
+					__m256 result = _mm256_mul_ps(l0, _mm256_shuffle_ps(rCols, rCols, 0x00));
+					result = GEE_SIMD_FMADD256(l1, _mm256_shuffle_ps(rCols, rCols, 0x55), result);
+					result = GEE_SIMD_FMADD256(l2, _mm256_shuffle_ps(rCols, rCols, 0xAA), result);
+					result = GEE_SIMD_FMADD256(l3, _mm256_shuffle_ps(rCols, rCols, 0xFF), result);
+					_mm256_storeu_ps(out + 8 * half, result);
+				}
+			}
+		#elif defined(GEE_SIMD_LEVEL_SSE4)
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const float* l = &lhs[i * lhsStride][0][0];
+				const float* r = &rhs[i][0][0];
+				float* out = &outMatrices[i][0][0];
+
+				const __m128 l0 = _mm_loadu_ps(l), l1 = _mm_loadu_ps(l + 4), l2 = _mm_loadu_ps(l + 8), l3 = _mm_loadu_ps(l + 12);
+				const __m128 rCols[4] = { _mm_loadu_ps(r), _mm_loadu_ps(r + 4), _mm_loadu_ps(r + 8), _mm_loadu_ps(r + 12) };
+				for (int column = 0; column < 4; column++)
+				{
+					const __m128 rCol = rCols[column];
+					__m128 result = _mm_mul_ps(l0, _mm_shuffle_ps(rCol, rCol, 0x00));
+					result = _mm_add_ps(result, _mm_mul_ps(l1, _mm_shuffle_ps(rCol, rCol, 0x55)));
+					result = _mm_add_ps(result, _mm_mul_ps(l2, _mm_shuffle_ps(rCol, rCol, 0xAA)));
+					result = _mm_add_ps(result, _mm_mul_ps(l3, _mm_shuffle_ps(rCol, rCol, 0xFF)));
+					_mm_storeu_ps(out + 4 * column, result);
+				}
+			}
+		#else
+			for (std::size_t i = 0; i < count; i++)
+				outMatrices[i] = lhs[i * lhsStride] * rhs[i];
+		#endif
+		}
+	}
+
+	void Math::MultiplyMatrices(const Mat4f* lhs, const Mat4f* rhs, Mat4f* outMatrices, std::size_t count)
+	{
+		MultiplyMatricesStrided(lhs, 1, rhs, outMatrices, count);
+	}
+
+	void Math::MultiplyMatrices(const Mat4f& lhs, const Mat4f* rhs, Mat4f* outMatrices, std::size_t count)
+	{
+		MultiplyMatricesStrided(&lhs, 0, rhs, outMatrices, count);
+	}
+
+	Mat4f Math::MultiplyMatrix(const Mat4f& lhs, const Mat4f& rhs)
+	{
+		Mat4f result;
+		MultiplyMatrices(&lhs, &rhs, &result, 1);
+		return result;
+	}
+
+	void Math::MultiplyQuaternions(const Quatf* lhs, const Quatf* rhs, Quatf* outQuats, std::size_t count)
+	{
+		std::size_t i = 0;
+
+	#ifdef GEE_SIMD_LEVEL_SSE4
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 px = _mm_loadu_ps(&lhs[i].x), py = _mm_loadu_ps(&lhs[i + 1].x), pz = _mm_loadu_ps(&lhs[i + 2].x), pw = _mm_loadu_ps(&lhs[i + 3].x);
+			__m128 qx = _mm_loadu_ps(&rhs[i].x), qy = _mm_loadu_ps(&rhs[i + 1].x), qz = _mm_loadu_ps(&rhs[i + 2].x), qw = _mm_loadu_ps(&rhs[i + 3].x);
+			_MM_TRANSPOSE4_PS(px, py, pz, pw);
+			_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+			__m128 x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pw, qx), _mm_mul_ps(px, qw)), _mm_mul_ps(py, qz)), _mm_mul_ps(pz, qy));
+			__m128 y = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pw, qy), _mm_mul_ps(py, qw)), _mm_mul_ps(pz, qx)), _mm_mul_ps(px, qz));
+			__m128 z = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pw, qz), _mm_mul_ps(pz, qw)), _mm_mul_ps(px, qy)), _mm_mul_ps(py, qx));
+			__m128 w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(pw, qw), _mm_mul_ps(px, qx)), _mm_mul_ps(py, qy)), _mm_mul_ps(pz, qz));
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(&outQuats[i].x, x);
+			_mm_storeu_ps(&outQuats[i + 1].x, y);
+			_mm_storeu_ps(&outQuats[i + 2].x, z);
+			_mm_storeu_ps(&outQuats[i + 3].x, w);
+		}
+	#endif
+
+		for (; i < count; i++)
+			outQuats[i] = lhs[i] * rhs[i];
+	}
+
+	void Math::NormalizeQuaternions(Quatf* quats, std::size_t count)
+	{
+		std::size_t i = 0;
+
+	#ifdef GEE_SIMD_LEVEL_SSE4
+		const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(&quats[i].x), y = _mm_loadu_ps(&quats[i + 1].x), z = _mm_loadu_ps(&quats[i + 2].x), w = _mm_loadu_ps(&quats[i + 3].x);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+			const __m128 nonZero = _mm_cmpgt_ps(length, zero);
+			const __m128 invLength = _mm_div_ps(one, length);
+
+			// Zero-length quaternions become (0, 0, 0, 1)
+			x = _mm_blendv_ps(zero, _mm_mul_ps(x, invLength), nonZero);
+			y = _mm_blendv_ps(zero, _mm_mul_ps(y, invLength), nonZero);
+			z = _mm_blendv_ps(zero, _mm_mul_ps(z, invLength), nonZero);
+			w = _mm_blendv_ps(one, _mm_mul_ps(w, invLength), nonZero);
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(&quats[i].x, x);
+			_mm_storeu_ps(&quats[i + 1].x, y);
+			_mm_storeu_ps(&quats[i + 2].x, z);
+			_mm_storeu_ps(&quats[i + 3].x, w);
+		}
+	#endif
+
+		for (; i < count; i++)
+			quats[i] = glm::normalize(quats[i]);
+	}
+
+	void Math::TransformBoxes(const Boxf<Vec3f>* boxes, const Mat4f* matrices, Boxf<Vec3f>* outBoxes, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			// Copy the input first, so outBoxes can alias boxes
+			const Vec3f center = boxes[i].Position, extent = boxes[i].Size;
+			const Mat4f& mat = matrices[i];
+
+		#ifdef GEE_SIMD_LEVEL_SSE4
+			// Arvo's method: the new extent is the absolute value of the 3x3 part times the old extent
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			const __m128 c0 = _mm_loadu_ps(&mat[0][0]), c1 = _mm_loadu_ps(&mat[1][0]), c2 = _mm_loadu_ps(&mat[2][0]), c3 = _mm_loadu_ps(&mat[3][0]);
+
+			__m128 newCenter = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(center.x)));
+			newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c1, _mm_set1_ps(center.y)));
+			newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c2, _mm_set1_ps(center.z)));
+
+			__m128 newExtent = _mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_set1_ps(extent.x));
+			newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_set1_ps(extent.y)));
+			newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_set1_ps(extent.z)));
+
+			float centerOut[4], extentOut[4];
+			_mm_storeu_ps(centerOut, newCenter);
+			_mm_storeu_ps(extentOut, newExtent);
+			outBoxes[i] = Boxf<Vec3f>(Vec3f(centerOut[0], centerOut[1], centerOut[2]), Vec3f(extentOut[0], extentOut[1], extentOut[2]));
+		#else
+			Mat3f absMatrix(mat);
+			for (int axis = 0; axis < 3; axis++)
+				absMatrix[axis] = glm::abs(absMatrix[axis]);
+
+			outBoxes[i] = Boxf<Vec3f>(Vec3f(mat * Vec4f(center, 1.0f)), absMatrix * extent);
+		#endif
+		}
+	}
+}
\ No newline at end of file
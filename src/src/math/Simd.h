@@ -0,0 +1,58 @@
+#pragma once
+#include <math/Vec.h>
+#include <cstddef>
+
+// The instruction set is chosen at build time (see the GEE_SIMD option in CMakeLists.txt). Without any of the macros below, the kernels fall back to scalar glm code.
+#if defined(GEE_SIMD_AVX2) || (!defined(GEE_SIMD_DISABLE) && defined(__AVX2__))
+	#define GEE_SIMD_LEVEL_AVX2
+	#define GEE_SIMD_LEVEL_SSE4
+#elif defined(GEE_SIMD_SSE4) || (!defined(GEE_SIMD_DISABLE) && (defined(__SSE4_1__) || defined(__AVX__)))
+	#define GEE_SIMD_LEVEL_SSE4
+#endif
+
+namespace GEE
+{
+	template <typename VecType> class Boxf;
+
+	/**
+	 * @brief Batched math kernels. Every function processes count elements stored in contiguous arrays (AoS, in glm's memory layout) and produces the same results as the equivalent glm code, up to floating point rounding.
+	 * Output arrays may alias input arrays only if they are exactly the same array.
+	*/
+	namespace Math
+	{
+		/**
+		 * @return the name of the instruction set the kernels were compiled for ("AVX2", "SSE4.1" or "Scalar").
+		*/
+		const char* GetSimdInstructionSetName();
+
+		/**
+		 * @brief Computes translate(position) * mat4_cast(rotation) * scale(scale) for every element - the matrix returned by Transform::GetMatrix().
+		*/
+		void TRSToMatrices(const Vec3f* positions, const Quatf* rotations, const Vec3f* scales, Mat4f* outMatrices, std::size_t count);
+		Mat4f TRSToMatrix(const Vec3f& position, const Quatf& rotation, const Vec3f& scale);
+
+		/**
+		 * @brief Computes lhs[i] * rhs[i] for every element.
+		*/
+		void MultiplyMatrices(const Mat4f* lhs, const Mat4f* rhs, Mat4f* outMatrices, std::size_t count);
+		/**
+		 * @brief Computes lhs * rhs[i] for every element.
+		*/
+		void MultiplyMatrices(const Mat4f& lhs, const Mat4f* rhs, Mat4f* outMatrices, std::size_t count);
+		Mat4f MultiplyMatrix(const Mat4f& lhs, const Mat4f& rhs);
+
+		/**
+		 * @brief Computes lhs[i] * rhs[i] (Hamilton product, like glm's operator*) for every element.
+		*/
+		void MultiplyQuaternions(const Quatf* lhs, const Quatf* rhs, Quatf* outQuats, std::size_t count);
+		/**
+		 * @brief Normalizes every quaternion in place. Quaternions of zero length become the identity quaternion, like in glm::normalize.
+		*/
+		void NormalizeQuaternions(Quatf* quats, std::size_t count);
+
+		/**
+		 * @brief Computes the axis-aligned box enclosing boxes[i] transformed by matrices[i] for every element (see Math::TransformBox).
+		*/
+		void TransformBoxes(const Boxf<Vec3f>* boxes, const Mat4f* matrices, Boxf<Vec3f>* outBoxes, std::size_t count);
+	}
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include <math/Transform.h>
+#include <math/TransformStore.h>
+#include <math/Simd.h>
 #include <glm/gtx/matrix_decompose.hpp>
+#include <algorithm>
 #include <UI/UICanvasActor.h> // for EditorDescriptionBuilder
 #include <UI/UICanvasField.h> // for EditorDescriptionBuilder
 
@@ -7,20 +10,51 @@ namespace GEE
 {
 	float beginning;
 
+	// Generation 0 is never assigned, so a dirty flag set to 0 is always dirty. New Transforms use generation 1; they do not need a unique one, because nothing could have seen them yet.
+	std::atomic<std::uint64_t> Transform::GlobalGeneration(1);
+
+	std::uint64_t Transform::NextGeneration()
+	{
+		return GlobalGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
 	void Transform::FlagMyDirtiness() const
 	{
 		Empty = false;
-		DirtyFlags[0] = true;
-		FlagWorldDirtiness();
+		LocalGeneration.store(NextGeneration(), std::memory_order_release);
+		NotifyChangeListeners();
 	}
 
 	void Transform::FlagWorldDirtiness() const
 	{
-		for (int i = 1; i < static_cast<int>(DirtyFlags.size()); i++)
-			DirtyFlags[i] = true;
+		HierarchyGeneration.store(NextGeneration(), std::memory_order_release);
+		NotifyChangeListeners();
+	}
 
-		for (auto child : Children)
-			child->FlagWorldDirtiness();
+	void Transform::NotifyChangeListeners() const
+	{
+		if (ListenedSubtreeCount == 0)
+			return;
+
+		if (ChangeListener)
+			ChangeListener->OnTransformChanged(*this);
+		for (Transform* child : Children)
+			child->NotifyChangeListeners();
+	}
+
+	void Transform::AddToListenedSubtreeCount(int delta)
+	{
+		for (Transform* transform = this; transform; transform = transform->ParentTransform)
+			transform->ListenedSubtreeCount = static_cast<unsigned int>(static_cast<int>(transform->ListenedSubtreeCount) + delta);
+	}
+
+	std::uint64_t Transform::GetWorldGeneration() const
+	{
+		std::uint64_t worldGeneration = 0;
+		for (const Transform* transform = this; transform; transform = transform->ParentTransform)
+			worldGeneration = std::max({ worldGeneration, transform->GetLocalGeneration(), transform->HierarchyGeneration.load(std::memory_order_acquire) });
+
+		return worldGeneration;
 	}
 
 	Transform::Transform() :
@@ -41,8 +75,14 @@ namespace GEE
 		Position(pos),
 		Rotation(rot),
 		Scale(scale),
-		DirtyFlags(3, true),
-		Empty(false)
+		LocalGeneration(1),
+		HierarchyGeneration(0),
+		DirtyFlags(3, 0),
+		Empty(false),
+		Store(nullptr),
+		StoreIndex(0),
+		ChangeListener(nullptr),
+		ListenedSubtreeCount(0)
 	{
 		if (pos == Vec3f(0.0f) && rot == Quatf(Vec3f(0.0f)) && scale == Vec3f(1.0f))
 			Empty = true;
@@ -66,6 +106,12 @@ namespace GEE
 		}  */
 	}
 
+	Transform::~Transform()
+	{
+		if (Store)
+			Store->OnTransformDestroyed(*this);
+	}
+
 	Vec3f Transform::GetFrontVec() const
 	{
 		return Rotation * Vec3f(0.0f, 0.0f, -1.0f);
@@ -86,16 +132,15 @@ namespace GEE
 
 	Mat4f Transform::GetMatrix() const
 	{
-		if (!DirtyFlags[0])
+		const std::uint64_t localGeneration = GetLocalGeneration();
+		if (DirtyFlags[0] == localGeneration)
 			return MatrixCache;
 		if (Empty)
 			return Mat4f(1.0f);
 
-		MatrixCache = glm::translate(Mat4f(1.0f), Position);
-		MatrixCache *= glm::mat4_cast(Rotation);
-		MatrixCache = glm::scale(MatrixCache, Scale);
+		MatrixCache = Math::TRSToMatrix(Position, Rotation, Scale);
 
-		DirtyFlags[0] = false;
+		DirtyFlags[0] = localGeneration;
 
 		return MatrixCache;
 	}
@@ -107,31 +152,43 @@ namespace GEE
 
 	const Transform& Transform::GetWorldTransform() const
 	{
-		if (!DirtyFlags[1])
+		const std::uint64_t worldGeneration = GetWorldGeneration();
+		if (DirtyFlags[1] == worldGeneration)
 			return *WorldTransformCache;
 
-		if (!ParentTransform)
-		{
-			WorldTransformCache.reset(new Transform(Position, Rotation, Scale));
-			DirtyFlags[1] = false;
-			return *WorldTransformCache;
-		}
-		else if (Empty)
+		if (ParentTransform && Empty)
 			return ParentTransform->GetWorldTransform();
 
-		WorldTransformCache.reset(new Transform(ParentTransform->GetWorldTransform() * (*this)));
-		DirtyFlags[1] = false;
+		// Reuse the cache object instead of allocating a new one on every recalculation
+		if (!WorldTransformCache)
+			WorldTransformCache = MakeUnique<Transform>();
+
+		if (Store && Store->IsWorldTransformCurrent(*this, worldGeneration))	// computed by the last pass of the store
+			Store->GetWorldTransform(*this, *WorldTransformCache);
+		else if (!ParentTransform)
+			WorldTransformCache->SetCachedValues(Position, Rotation, Scale);
+		else
+		{
+			// Same as ParentTransform->GetWorldTransform() * (*this), but without creating a temporary Transform (changing it would assign a new generation)
+			const Transform& parentWorld = ParentTransform->GetWorldTransform();
+			WorldTransformCache->SetCachedValues(parentWorld.Position + parentWorld.Rotation * (parentWorld.Scale * Position), parentWorld.Rotation * Rotation, parentWorld.Scale * Scale);
+		}
+		DirtyFlags[1] = worldGeneration;
 
 		return *WorldTransformCache;
 	}
 
 	const Mat4f& Transform::GetWorldTransformMatrix() const
 	{
-		if (!DirtyFlags[2])
+		const std::uint64_t worldGeneration = GetWorldGeneration();
+		if (DirtyFlags[2] == worldGeneration)
 			return WorldTransformMatrixCache;
 
-		WorldTransformMatrixCache = GetWorldTransform().GetMatrix();
-		DirtyFlags[2] = false;
+		if (Store && Store->IsWorldTransformCurrent(*this, worldGeneration))
+			WorldTransformMatrixCache = Store->GetWorldMatrix(*this);
+		else
+			WorldTransformMatrixCache = GetWorldTransform().GetMatrix();
+		DirtyFlags[2] = worldGeneration;
 
 		return WorldTransformMatrixCache;
 	}
@@ -141,6 +198,16 @@ namespace GEE
 		return ParentTransform;
 	}
 
+	void Transform::SetCachedValues(const Vec3f& pos, const Quatf& rot, const Vec3f& scale) const
+	{
+		Transform& cache = *const_cast<Transform*>(this);
+		cache.Position = pos;
+		cache.Rotation = rot;
+		cache.Scale = scale;
+		cache.Empty = false;
+		DirtyFlags[0] = DirtyFlags[1] = DirtyFlags[2] = 0;	// invalidate the caches of the cache Transform, but not any user flags
+	}
+
 	void Transform::SetPosition(const Vec2f& pos)
 	{
 		SetPosition(Vec3f(pos, 0.0f));
@@ -258,10 +325,15 @@ namespace GEE
 	void Transform::SetParentTransform(Transform* parent, bool relocate)
 	{
 		if (ParentTransform)
+		{
 			ParentTransform->RemoveChild(this);
+			if (ListenedSubtreeCount > 0)
+				ParentTransform->AddToListenedSubtreeCount(-static_cast<int>(ListenedSubtreeCount));
+		}
 		if (!parent)
 		{
 			ParentTransform = nullptr;
+			FlagWorldDirtiness();
 			return;
 		}
 
@@ -284,6 +356,8 @@ namespace GEE
 
 		ParentTransform = parent;
 		ParentTransform->AddChild(this);
+		if (ListenedSubtreeCount > 0)
+			ParentTransform->AddToListenedSubtreeCount(static_cast<int>(ListenedSubtreeCount));
 
 		FlagWorldDirtiness();
 	}
@@ -291,10 +365,15 @@ namespace GEE
 	void Transform::AddChild(Transform* t)
 	{
 		Children.push_back(t);
+		if (Store || t->Store)
+			((Store) ? (Store) : (t->Store))->MarkStructureDirty();
 	}
 
 	void Transform::RemoveChild(Transform* t)
 	{
+		if (Store)
+			Store->MarkStructureDirty();
+
 		for (unsigned int i = 0; i < Children.size(); i++)
 		{
 			if (Children[i] == t)
@@ -310,30 +389,43 @@ namespace GEE
 		if (index == std::numeric_limits<unsigned int>::max())
 			return true;
 
-		bool flag = DirtyFlags[index];
+		const std::uint64_t currentGeneration = (index == 0) ? (GetLocalGeneration()) : (GetWorldGeneration());
+		bool flag = DirtyFlags[index] != currentGeneration;
 		if (reset)
-			SetDirtyFlag(index, false);
+			DirtyFlags[index] = currentGeneration;
 
 		return flag;
 	}
 
 	void Transform::SetDirtyFlag(unsigned int index, bool val) const
 	{
-		DirtyFlags[index] = val;
+		if (val)
+			DirtyFlags[index] = 0;
+		else
+			DirtyFlags[index] = (index == 0) ? (GetLocalGeneration()) : (GetWorldGeneration());
 	}
 
 	void Transform::SetDirtyFlags(bool val) const
 	{
-		for (int i = 0; i < DirtyFlags.size(); i++)
-			DirtyFlags[i] = val;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(DirtyFlags.size()); i++)
+			SetDirtyFlag(i, val);
 	}
 
 	unsigned int Transform::AddDirtyFlag() const
 	{
-		DirtyFlags.push_back(true);
+		DirtyFlags.push_back(0);
 		return static_cast<unsigned int>(DirtyFlags.size()) - 1;
 	}
 
+	void Transform::SetChangeListener(TransformChangeListener* listener)
+	{
+		GEE_CORE_ASSERT(!listener || !ChangeListener || ChangeListener == listener, "A Transform can only have a single change listener; remove the previous one first.");
+		if ((ChangeListener != nullptr) != (listener != nullptr))
+			AddToListenedSubtreeCount((listener) ? (1) : (-1));
+
+		ChangeListener = listener;
+	}
+
 	void Transform::AddInterpolator(const String& fieldName, SharedPtr<InterpolatorBase> interpolator, bool animateFromCurrent)
 	{
 		Interpolators.push_back(interpolator);
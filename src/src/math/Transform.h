@@ -4,7 +4,9 @@
 #include <glm/gtx/euler_angles.hpp>
 #include <string>
 #include <utility/CerealNames.h>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
+#include <atomic>
+#include <cstdint>
 #include "Vec.h"
 
 namespace GEE
@@ -23,6 +25,25 @@ namespace GEE
 	};
 
 
+	class TransformStore;
+	class Transform;
+
+	/**
+	 * @brief Notified whenever the world transform of the Transform it listens to may have changed. See Transform::SetChangeListener().
+	 * Notifications come from the thread which changes the Transform, so they can come from the worker threads of a parallel update phase.
+	*/
+	class TransformChangeListener
+	{
+	public:
+		virtual void OnTransformChanged(const Transform&) = 0;
+		virtual ~TransformChangeListener() = default;
+	};
+
+	/**
+	 * Change tracking: instead of setting dirty flags in the whole subtree on every change, each Transform stores generation numbers.
+	 * Every change of a Transform assigns it a new, globally increasing generation, which is O(1). The world generation of a Transform is the highest generation in its chain of ancestors; it is computed on read by walking up that chain, so changes of unrelated Transforms do not invalidate anything.
+	 * A dirty flag (including the ones added with AddDirtyFlag()) stores the generation its consumer has last seen - the flag is dirty if it differs from the current one.
+	*/
 	class Transform
 	{
 		Transform* ParentTransform;
@@ -36,13 +57,51 @@ namespace GEE
 		Quatf Rotation;
 		Vec3f Scale;
 
-		mutable std::vector <bool> DirtyFlags;
+		// Atomic, because threads of a parallel update phase may read the generations of a shared ancestor while it is changed
+		mutable std::atomic<std::uint64_t> LocalGeneration;	// changed when Position, Rotation or Scale changes
+		mutable std::atomic<std::uint64_t> HierarchyGeneration;	// changed when the parent changes
+
+		mutable std::vector <std::uint64_t> DirtyFlags;	// the generation last seen by each flag. Flag 0 tracks the local generation (local matrix cache), flags 1 and 2 track the world generation (world transform and world matrix caches), others are added by users.
 		mutable bool Empty;	//true if the Transform object has never been changed. Allows for a simple optimization - we skip it during world transform calculation
+
+		TransformStore* Store;	// the store this Transform is registered in (nullptr if it is not a part of any TransformStore)
+		unsigned int StoreIndex;
+
+		TransformChangeListener* ChangeListener;
+		unsigned int ListenedSubtreeCount;	// number of Transforms with a ChangeListener in the subtree of this Transform (including itself). Changes only walk the subtree if it is not 0
+
+		/**
+		 * @brief Overwrites the values of a cache Transform without assigning it a new generation (which would make everything that depends on the generation of the cache dirty).
+		*/
+		void SetCachedValues(const Vec3f& pos, const Quatf& rot, const Vec3f& scale) const;
+		static std::uint64_t NextGeneration();
+		std::uint64_t GetLocalGeneration() const { return LocalGeneration.load(std::memory_order_acquire); }
+		/**
+		 * @brief Notifies the listeners in the subtree of this Transform, whose world transforms have changed along with this one.
+		*/
+		void NotifyChangeListeners() const;
+		/**
+		 * @brief Adds delta to ListenedSubtreeCount of this Transform and all its ancestors.
+		*/
+		void AddToListenedSubtreeCount(int delta);
+		friend class TransformStore;
+
+		static std::atomic<std::uint64_t> GlobalGeneration;
 	public:
 		std::vector <SharedPtr<InterpolatorBase>> Interpolators;
 
+		/**
+		 * @brief Marks the local transform (and therefore the world transforms of this Transform and all its descendants) as changed. O(1) - descendants detect the change when they are read.
+		*/
 		void FlagMyDirtiness() const;
+		/**
+		 * @brief Marks the world transform of this Transform and all its descendants as changed. O(1).
+		*/
 		void FlagWorldDirtiness() const;
+		/**
+		 * @return the highest generation in the chain from this Transform to the root. It changes whenever the world transform of this Transform could have changed.
+		*/
+		std::uint64_t GetWorldGeneration() const;
 
 	public:
 		explicit Transform();
@@ -115,6 +174,13 @@ namespace GEE
 		void SetDirtyFlag(unsigned int index = 0, bool val = true) const;
 		void SetDirtyFlags(bool val = true) const;
 		unsigned int AddDirtyFlag() const;
+		/**
+		 * @brief Sets the listener notified whenever this Transform or any of its ancestors changes or is reparented. Pass nullptr to remove the listener; it must be removed before this Transform is destroyed.
+		 * A Transform has a single listener slot: setting a listener while a different one is set is an error, so the previous listener has to be removed first.
+		 * Unlike dirty flags, which have to be polled, listeners let systems that track many Transforms only visit the ones which have changed.
+		*/
+		void SetChangeListener(TransformChangeListener*);
+		TransformChangeListener* GetChangeListener() const { return ChangeListener; }
 
 		void AddInterpolator(const String& fieldName, SharedPtr<InterpolatorBase>, bool animateFromCurrent = true);	//if animateFromCurrent is true, the method automatically changes the minimum value of the interpolator to be the current value of the interpolated variable.
 		template <class T> void AddInterpolator(const String& fieldName, Time begin, Time end, T min, T max, InterpolationType interpType = InterpolationType::Linear, bool fadeAway = false, AnimBehaviour before = AnimBehaviour::STOP, AnimBehaviour after = AnimBehaviour::STOP);
@@ -131,7 +197,7 @@ namespace GEE
 
 		void Print(std::string name = "unnamed") const;
 
-		~Transform() = default;
+		~Transform();
 
 		Transform operator*(const Transform&) const;
 
@@ -0,0 +1,195 @@
+#include <math/TransformStore.h>
+#include <math/Simd.h>
+#include <algorithm>
+
+namespace GEE
+{
+	TransformStore::TransformStore(Transform& root) :
+		Root(&root),
+		bStructureDirty(true),
+		LastUpdatedCount(0)
+	{
+	}
+
+	TransformStore::~TransformStore()
+	{
+		UnbindAll();
+	}
+
+	void TransformStore::MarkStructureDirty()
+	{
+		bStructureDirty = true;
+	}
+
+	template <typename Func>
+	void TransformStore::ForEachChangedRange(unsigned int begin, unsigned int end, Func&& func) const
+	{
+		for (unsigned int i = begin; i < end;)
+		{
+			if (!ChangedThisPass[i])
+			{
+				i++;
+				continue;
+			}
+
+			unsigned int rangeEnd = i + 1;
+			while (rangeEnd < end && ChangedThisPass[rangeEnd])
+				rangeEnd++;
+
+			func(i, rangeEnd - i);
+			i = rangeEnd;
+		}
+	}
+
+	void TransformStore::UpdateWorldTransforms()
+	{
+		const bool bFullUpdate = bStructureDirty;
+		if (bStructureDirty)
+			Rebuild();
+
+		// Levels are processed in order; all parents of a level are final before it is processed, so every level can be computed in batches.
+		for (std::size_t level = 0; level + 1 < LevelOffsets.size(); level++)
+		{
+			const unsigned int levelBegin = LevelOffsets[level], levelEnd = LevelOffsets[level + 1];
+			for (unsigned int i = levelBegin; i < levelEnd; i++)
+			{
+				const Transform& transform = *Owners[i];
+				const int parentIndex = ParentIndices[i];
+
+				// The world generation is the highest generation in the chain to the root, so it is built from the parent's entry instead of walking up the chain.
+				// Generations only grow, so it differs from the stored one exactly when this transform or any ancestor has changed.
+				std::uint64_t worldGeneration = std::max(transform.GetLocalGeneration(), transform.HierarchyGeneration.load(std::memory_order_acquire));
+				if (parentIndex >= 0)
+					worldGeneration = std::max(worldGeneration, WorldGenerations[parentIndex]);
+				else if (const Transform* externalParent = transform.GetParentTransform())	// only the root can have a parent outside the store
+					worldGeneration = std::max(worldGeneration, externalParent->GetWorldGeneration());
+
+				const bool changed = bFullUpdate || worldGeneration != WorldGenerations[i];
+				ChangedThisPass[i] = changed;
+				if (!changed)
+					continue;
+
+				WorldGenerations[i] = worldGeneration;
+
+				LocalPositions[i] = transform.Position;
+				LocalRotations[i] = transform.Rotation;
+				LocalScales[i] = transform.Scale;
+
+				Vec3f parentPosition(0.0f), parentScale(1.0f);
+				Quatf parentRotation(Vec3f(0.0f));
+				if (parentIndex >= 0)
+				{
+					parentPosition = WorldPositions[parentIndex];
+					parentRotation = WorldRotations[parentIndex];
+					parentScale = WorldScales[parentIndex];
+				}
+				else if (const Transform* externalParent = transform.GetParentTransform())	// only the root can have a parent outside the store
+				{
+					const Transform& parentWorld = externalParent->GetWorldTransform();
+					parentPosition = parentWorld.Position;
+					parentRotation = parentWorld.Rotation;
+					parentScale = parentWorld.Scale;
+				}
+
+				// Same composition as Transform::operator*. Rotations are composed below, in batches.
+				WorldPositions[i] = parentPosition + parentRotation * (parentScale * LocalPositions[i]);
+				WorldScales[i] = parentScale * LocalScales[i];
+				ParentRotations[i] = parentRotation;
+			}
+
+			ForEachChangedRange(levelBegin, levelEnd, [this](unsigned int begin, unsigned int rangeCount) { Math::MultiplyQuaternions(&ParentRotations[begin], &LocalRotations[begin], &WorldRotations[begin], rangeCount); });
+		}
+
+		const unsigned int count = static_cast<unsigned int>(Owners.size());
+		ForEachChangedRange(0, count, [this](unsigned int begin, unsigned int rangeCount) { Math::TRSToMatrices(&WorldPositions[begin], &WorldRotations[begin], &WorldScales[begin], &WorldMatrices[begin], rangeCount); });
+
+		LastUpdatedCount = static_cast<unsigned int>(std::count(ChangedThisPass.begin(), ChangedThisPass.end(), 1));
+	}
+
+	unsigned int TransformStore::GetTransformCount() const
+	{
+		return static_cast<unsigned int>(Owners.size());
+	}
+
+	unsigned int TransformStore::GetLastUpdatedCount() const
+	{
+		return LastUpdatedCount;
+	}
+
+	const Mat4f& TransformStore::GetWorldMatrix(const Transform& transform) const
+	{
+		GEE_CORE_ASSERT(transform.Store == this);
+		return WorldMatrices[transform.StoreIndex];
+	}
+
+	bool TransformStore::IsWorldTransformCurrent(const Transform& transform, std::uint64_t worldGeneration) const
+	{
+		return !bStructureDirty && WorldGenerations[transform.StoreIndex] == worldGeneration;
+	}
+
+	void TransformStore::GetWorldTransform(const Transform& transform, const Transform& worldTransformCache) const
+	{
+		const unsigned int index = transform.StoreIndex;
+		worldTransformCache.SetCachedValues(WorldPositions[index], WorldRotations[index], WorldScales[index]);
+	}
+
+	void TransformStore::OnTransformDestroyed(const Transform& transform)
+	{
+		if (&transform == Root)
+			Root = nullptr;
+
+		Owners[transform.StoreIndex] = nullptr;
+		bStructureDirty = true;
+	}
+
+	void TransformStore::Rebuild()
+	{
+		UnbindAll();
+		Owners.clear();
+		ParentIndices.clear();
+		Depths.clear();
+		LevelOffsets.clear();
+
+		// Breadth-first traversal; every level is stored after the previous one, so parents are always updated before their children.
+		if (Root)
+			Register(*Root, -1);
+		for (unsigned int i = 0; i < Owners.size(); i++)
+			for (Transform* child : Owners[i]->Children)
+				Register(*child, static_cast<int>(i));
+
+		const std::size_t count = Owners.size();
+		for (unsigned int i = 0; i < count; i++)
+			if (i == 0 || Depths[i] != Depths[i - 1])
+				LevelOffsets.push_back(i);
+		LevelOffsets.push_back(static_cast<unsigned int>(count));
+
+		LocalPositions.resize(count);
+		LocalRotations.resize(count);
+		LocalScales.resize(count);
+		WorldPositions.resize(count);
+		WorldRotations.resize(count);
+		WorldScales.resize(count);
+		WorldMatrices.resize(count);
+		ParentRotations.resize(count);
+		WorldGenerations.assign(count, 0);
+		ChangedThisPass.resize(count);
+
+		bStructureDirty = false;
+	}
+
+	void TransformStore::Register(Transform& transform, int parentIndex)
+	{
+		transform.Store = this;
+		transform.StoreIndex = static_cast<unsigned int>(Owners.size());
+		Owners.push_back(&transform);
+		ParentIndices.push_back(parentIndex);
+		Depths.push_back((parentIndex >= 0) ? (Depths[parentIndex] + 1) : (0));
+	}
+
+	void TransformStore::UnbindAll()
+	{
+		for (Transform* transform : Owners)
+			if (transform && transform->Store == this)
+				transform->Store = nullptr;
+	}
+}
\ No newline at end of file
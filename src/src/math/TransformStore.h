@@ -0,0 +1,79 @@
+#pragma once
+#include <math/Transform.h>
+
+namespace GEE
+{
+	/**
+	 * @brief An optional, scene-level store of world transforms, kept in contiguous structure-of-arrays storage.
+	 * The store registers the whole hierarchy below its root transform in level order (every parent precedes its children), so all world transforms can be updated in a single linear pass instead of by recursive pointer chasing. Rotations and matrices are computed with the batched kernels from math/Simd.h.
+	 * Transforms remain the interface: they still own their local position, rotation and scale, and a Transform registered in the store acts as a handle.
+	 * The pass only gathers the entries whose generation (or any ancestor's) changed, and writes nothing back - a Transform reads its world transform and matrix from the store when its caches are stale and the store computed them for its current world generation.
+	 * Transforms changed after the pass are recalculated lazily, as usual, so the store never makes a world transform stale.
+	 * Reparenting, adding or removing a transform only marks the store's structure as dirty; the order is rebuilt before the next pass.
+	*/
+	class TransformStore
+	{
+	public:
+		TransformStore(Transform& root);
+		TransformStore(const TransformStore&) = delete;
+		TransformStore& operator=(const TransformStore&) = delete;
+		~TransformStore();
+
+		void MarkStructureDirty();
+		/**
+		 * @brief Recomputes world transforms of all registered transforms whose local transform (or any ancestor's) changed since the last call. Rebuilds the level order first if the hierarchy changed.
+		*/
+		void UpdateWorldTransforms();
+
+		unsigned int GetTransformCount() const;
+		/**
+		 * @return the number of world transforms recomputed by the last UpdateWorldTransforms() call.
+		*/
+		unsigned int GetLastUpdatedCount() const;
+		/**
+		 * @return the world matrix of a registered transform, as of the last UpdateWorldTransforms() call.
+		*/
+		const Mat4f& GetWorldMatrix(const Transform&) const;
+
+	private:
+		/**
+		 * @brief Called from the destructor of a registered Transform.
+		*/
+		void OnTransformDestroyed(const Transform&);
+		/**
+		 * @return true if the last pass computed the world transform of the registered transform for the given world generation, so it can be read from the store.
+		*/
+		bool IsWorldTransformCurrent(const Transform&, std::uint64_t worldGeneration) const;
+		/**
+		 * @brief Copies the world transform computed by the last pass to the cache Transform of a registered transform.
+		*/
+		void GetWorldTransform(const Transform&, const Transform& worldTransformCache) const;
+		void Rebuild();
+		void Register(Transform&, int parentIndex);
+		void UnbindAll();
+		/**
+		 * @brief Calls func(first, count) for every maximal range of consecutive entries in [begin, end) that changed during the current pass.
+		*/
+		template <typename Func> void ForEachChangedRange(unsigned int begin, unsigned int end, Func&& func) const;
+		friend class Transform;
+
+		Transform* Root;
+
+		// Hierarchy, in level order
+		std::vector<Transform*> Owners;
+		std::vector<int> ParentIndices;	// -1 for the root
+		std::vector<unsigned int> Depths;
+		std::vector<unsigned int> LevelOffsets;	// index of the first entry of each level, followed by the total count
+
+		// Transform data, indexed like Owners
+		std::vector<Vec3f> LocalPositions, LocalScales, WorldPositions, WorldScales;
+		std::vector<Quatf> LocalRotations, WorldRotations;
+		std::vector<Mat4f> WorldMatrices;
+		std::vector<Quatf> ParentRotations;	// world rotations of the parents, gathered to compose rotations in batches
+		std::vector<std::uint64_t> WorldGenerations;	// the world generation each entry was computed for
+		std::vector<unsigned char> ChangedThisPass;
+
+		bool bStructureDirty;
+		unsigned int LastUpdatedCount;
+	};
+}
\ No newline at end of file
@@ -68,7 +68,7 @@ namespace cereal
 	template <int length, typename T, glm::qualifier Q, typename Archive>
 	void Serialize(Archive& archive, GEE::Vec<length, T, Q>& vec)
 	{
-		const std::string axisNames[] = { "x", "y", "z", "w" };
+		static const char* const axisNames[] = { "x", "y", "z", "w" };	// no allocations, since vectors are the bulk of serialized data
 		for (int i = 0; i < length; i++)
 			archive(cereal::make_nvp(axisNames[i], vec[i]));
 	}
@@ -81,8 +81,9 @@ namespace cereal
 	template <GEE::MathContainerUnit C, GEE::MathContainerUnit R, typename T, glm::qualifier Q, typename Archive>
 	void Serialize(Archive& archive, GEE::Mat<C, R, T, Q>& mat)
 	{
+		static const char* const rowNames[] = { "row0", "row1", "row2", "row3" };
 		for (int i = 0; i < static_cast<int>(R); i++)
-			archive(cereal::make_nvp("row" + std::to_string(i), mat[i]));
+			archive(cereal::make_nvp(rowNames[i], mat[i]));
 	}
 }
 
@@ -128,6 +128,8 @@ namespace GEE
 
 		template void CollisionShape::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 		template void CollisionShape::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+		template void CollisionShape::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+		template void CollisionShape::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 
 		CollisionObject::CollisionObject(bool isStatic) :
 			ScenePhysicsData(nullptr),
@@ -135,7 +137,11 @@ namespace GEE
 			TransformPtr(nullptr),
 			IsStatic(isStatic),
 			IgnoreRotation(false),
-			TransformDirtyFlag(std::numeric_limits<unsigned int>::max())
+			TransformDirtyFlag(std::numeric_limits<unsigned int>::max()),
+			PreviousPose(physx::PxIdentity),
+			LatestPose(physx::PxIdentity),
+			TransformChangeQueued(false),
+			ChangeListener(*this)
 		{
 		}
 
@@ -152,7 +158,11 @@ namespace GEE
 			TransformPtr(obj.TransformPtr),
 			TransformDirtyFlag(std::numeric_limits<unsigned int>::max()),
 			IgnoreRotation(obj.IgnoreRotation),
-			IsStatic(obj.IsStatic)
+			IsStatic(obj.IsStatic),
+			PreviousPose(obj.PreviousPose),
+			LatestPose(obj.LatestPose),
+			TransformChangeQueued(false),
+			ChangeListener(*this)
 		{
 
 		}
@@ -185,6 +195,12 @@ namespace GEE
 			}), Shapes.end());
 		}
 
+		void CollisionObject::TransformListener::OnTransformChanged(const Transform&)
+		{
+			if (Object.ScenePhysicsData && !Object.TransformChangeQueued.exchange(true))
+				Object.ScenePhysicsData->QueueTransformChange(Object);
+		}
+
 		CollisionShape* CollisionObject::FindTriangleMeshCollisionShape(const std::string& meshNodeName, const std::string& meshSpecificName)
 		{
 			if (meshNodeName.empty() && meshSpecificName.empty())
@@ -6,10 +6,11 @@
 #include <math/Transform.h>
 #include <game/GameManager.h>
 #include <utility/CerealNames.h>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
 
 #include <assetload/FileLoader.h>
 
+#include <atomic>
 #include <vector>
 
 namespace physx
@@ -69,6 +70,21 @@ namespace GEE
 
 			bool IsStatic;
 
+			physx::PxTransform PreviousPose, LatestPose;	// poses after the two latest simulation steps, used to interpolate transforms of dynamic objects between steps
+			std::atomic<bool> TransformChangeQueued;	// true if the object is in the transform change queue of its GameScenePhysicsData
+
+			/**
+			 * @brief Listens to changes of the Transform and queues the object, so only the objects moved by the engine are sent to PhysX before a simulation step.
+			 * A member rather than a base class, because cereal serializes pointers to polymorphic types differently.
+			*/
+			struct TransformListener : public TransformChangeListener
+			{
+				TransformListener(CollisionObject& object) : Object(object) {}
+				void OnTransformChanged(const Transform&) override;
+
+				CollisionObject& Object;
+			} ChangeListener;
+
 			CollisionObject(bool isStatic = true);
 			CollisionObject(bool isStatic, CollisionShapeType type);
 			CollisionObject(const CollisionObject& obj);
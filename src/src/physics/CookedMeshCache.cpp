@@ -0,0 +1,258 @@
+#include <physics/CookedMeshCache.h>
+#include <PhysX/PxPhysicsAPI.h>
+#include <utility/MappedFile.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <type_traits>
+
+using namespace physx;
+
+namespace GEE
+{
+	namespace Physics
+	{
+		namespace
+		{
+			constexpr std::uint32_t CachedMeshFileMagic = 0x50454547;	// "GEEP"
+			constexpr std::uint32_t CachedMeshFileVersion = 1;
+
+			struct CachedMeshFileHeader
+			{
+				std::uint32_t Magic;
+				std::uint32_t Version;
+				std::uint64_t Key;
+				std::uint32_t VertexCount;
+				std::uint32_t IndexCount;
+				std::uint64_t StreamSize;
+			};
+
+			std::uint64_t HashFNV1a(const void* data, std::size_t size, std::uint64_t hash)
+			{
+				const unsigned char* bytes = static_cast<const unsigned char*>(data);
+				for (std::size_t i = 0; i < size; i++)
+				{
+					hash ^= bytes[i];
+					hash *= 1099511628211ull;
+				}
+
+				return hash;
+			}
+
+			template <typename T> std::uint64_t HashValue(const T& value, std::uint64_t hash)
+			{
+				static_assert(std::is_arithmetic_v<T>, "Only hash values without padding.");
+				return HashFNV1a(&value, sizeof(T), hash);
+			}
+
+			Time GetElapsedTime(std::chrono::steady_clock::time_point begin)
+			{
+				return std::chrono::duration<Time>(std::chrono::steady_clock::now() - begin).count();
+			}
+		}
+
+		CookedMeshCache::CookedMeshCache() :
+			Physics(nullptr),
+			Cooking(nullptr),
+			CookingParamsHash(0),
+			bDiskCacheEnabled(false)
+		{
+		}
+
+		void CookedMeshCache::Init(PxPhysics& physics, PxCooking& cooking, const String& directory)
+		{
+			Physics = &physics;
+			Cooking = &cooking;
+			Directory = directory;
+
+			// Every parameter which affects the cooked data; the fields are hashed one by one, so padding bytes never change the key.
+			const PxCookingParams& params = cooking.getParams();
+			std::uint64_t hash = 14695981039346656037ull;
+			hash = HashValue(CachedMeshFileVersion, hash);
+			hash = HashValue(static_cast<std::uint32_t>(PX_PHYSICS_VERSION), hash);
+			hash = HashValue(static_cast<std::uint32_t>(sizeof(void*)), hash);
+			hash = HashValue(params.areaTestEpsilon, hash);
+			hash = HashValue(params.planeTolerance, hash);
+			hash = HashValue(static_cast<std::uint32_t>(params.convexMeshCookingType), hash);
+			hash = HashValue(params.suppressTriangleMeshRemapTable, hash);
+			hash = HashValue(params.buildTriangleAdjacencies, hash);
+			hash = HashValue(params.buildGPUData, hash);
+			hash = HashValue(params.scale.length, hash);
+			hash = HashValue(params.scale.speed, hash);
+			hash = HashValue(static_cast<std::uint32_t>(params.meshPreprocessParams), hash);
+			hash = HashValue(params.meshWeldTolerance, hash);
+			hash = HashValue(static_cast<std::uint32_t>(params.midphaseDesc.getType()), hash);
+			hash = HashValue(params.gaussMapLimit, hash);
+			CookingParamsHash = hash;
+
+			std::error_code error;
+			std::filesystem::create_directories(Directory, error);
+			bDiskCacheEnabled = !error;
+			if (error)
+				std::cout << "ERROR: Cannot create the cooked mesh cache directory " << Directory << " (" << error.message() << "). Triangle meshes will be cooked on every launch.\n";
+		}
+
+		PxTriangleMesh* CookedMeshCache::GetTriangleMesh(const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices)
+		{
+			if (vertices.empty() || indices.size() < 3)
+				return nullptr;
+
+			const std::uint64_t key = ComputeKey(vertices, indices);
+			const std::uint32_t vertexCount = static_cast<std::uint32_t>(vertices.size()), indexCount = static_cast<std::uint32_t>(indices.size());
+
+			auto found = Meshes.find(key);
+			if (found != Meshes.end() && found->second.VertexCount == vertexCount && found->second.IndexCount == indexCount)
+			{
+				CurrentStats.Reused++;
+				return found->second.Mesh;
+			}
+
+			PxTriangleMesh* mesh = nullptr;
+			if (bDiskCacheEnabled)
+			{
+				const auto loadingBegin = std::chrono::steady_clock::now();
+				if ((mesh = LoadFromDisk(key, vertexCount, indexCount)))
+				{
+					CurrentStats.LoadedFromDisk++;
+					CurrentStats.LoadingTime += GetElapsedTime(loadingBegin);
+				}
+			}
+
+			if (!mesh)
+			{
+				const auto cookingBegin = std::chrono::steady_clock::now();
+				if (!(mesh = Cook(key, vertices, indices)))
+					return nullptr;
+
+				CurrentStats.Cooked++;
+				CurrentStats.CookingTime += GetElapsedTime(cookingBegin);
+			}
+
+			if (found != Meshes.end())	// a different mesh with the same key; practically never happens
+				found->second.Mesh->release();
+			Meshes[key] = CachedMesh{ mesh, vertexCount, indexCount };
+
+			return mesh;
+		}
+
+		void CookedMeshCache::Clear()
+		{
+			for (auto& it : Meshes)
+				it.second.Mesh->release();
+
+			Meshes.clear();
+		}
+
+		void CookedMeshCache::PrintStats() const
+		{
+			std::cout << "INFO: Triangle meshes: " << CurrentStats.Reused << " reused, " << CurrentStats.LoadedFromDisk << " loaded from the cache in " << CurrentStats.LoadingTime * 1000.0 << " ms, " << CurrentStats.Cooked << " cooked in " << CurrentStats.CookingTime * 1000.0 << " ms.\n";
+		}
+
+		std::uint64_t CookedMeshCache::ComputeKey(const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices) const
+		{
+			std::uint64_t hash = CookingParamsHash;
+			hash = HashValue(static_cast<std::uint64_t>(vertices.size()), hash);
+			hash = HashFNV1a(vertices.data(), vertices.size() * sizeof(Vec3f), hash);	// Vec3f is three tightly packed floats
+			hash = HashValue(static_cast<std::uint64_t>(indices.size()), hash);
+			hash = HashFNV1a(indices.data(), indices.size() * sizeof(unsigned int), hash);
+
+			return hash;
+		}
+
+		String CookedMeshCache::GetCachedMeshPath(std::uint64_t key) const
+		{
+			std::stringstream path;
+			path << Directory << std::hex << std::setw(16) << std::setfill('0') << key << ".pxmesh";
+			return path.str();
+		}
+
+		PxTriangleMesh* CookedMeshCache::LoadFromDisk(std::uint64_t key, std::uint32_t vertexCount, std::uint32_t indexCount)
+		{
+			const String path = GetCachedMeshPath(key);
+			MappedFile file;
+			if (!file.Open(path))
+				return nullptr;
+
+			CachedMeshFileHeader header;
+			bool bValid = file.GetSize() >= sizeof(CachedMeshFileHeader);
+			if (bValid)
+			{
+				std::memcpy(&header, file.GetData(), sizeof(CachedMeshFileHeader));
+				bValid = header.Magic == CachedMeshFileMagic && header.Version == CachedMeshFileVersion && header.Key == key && header.VertexCount == vertexCount && header.IndexCount == indexCount
+					&& header.StreamSize == file.GetSize() - sizeof(CachedMeshFileHeader);
+			}
+
+			PxTriangleMesh* mesh = nullptr;
+			if (bValid)
+			{
+				// The stream is only read by PhysX, so it can point straight into the mapped file.
+				PxDefaultMemoryInputData stream(const_cast<PxU8*>(file.GetData() + sizeof(CachedMeshFileHeader)), static_cast<PxU32>(header.StreamSize));
+				mesh = Physics->createTriangleMesh(stream);
+			}
+
+			if (!mesh)
+			{
+				std::cout << "WARNING: Cooked mesh cache file " << path << " is invalid. The mesh will be cooked again.\n";
+				file.Close();
+				std::error_code error;
+				std::filesystem::remove(path, error);
+			}
+
+			return mesh;
+		}
+
+		PxTriangleMesh* CookedMeshCache::Cook(std::uint64_t key, const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices)
+		{
+			PxTriangleMeshDesc desc;
+			desc.points.count = static_cast<PxU32>(vertices.size());
+			desc.points.stride = static_cast<PxU32>(sizeof(Vec3f));
+			desc.points.data = vertices.data();
+
+			desc.triangles.count = static_cast<PxU32>(indices.size() / 3);
+			desc.triangles.stride = sizeof(unsigned int) * 3;
+			desc.triangles.data = indices.data();
+
+			PxDefaultMemoryOutputStream writeBuffer;
+			PxTriangleMeshCookingResult::Enum result;
+			if (!Cooking->cookTriangleMesh(desc, writeBuffer, &result) || result == PxTriangleMeshCookingResult::Enum::eFAILURE)
+			{
+				std::cerr << "ERROR! Can't cook mesh with " << desc.points.count << " vertices.\n";
+				return nullptr;
+			}
+			if (result == PxTriangleMeshCookingResult::Enum::eLARGE_TRIANGLE)
+				std::cout << "INFO: Triangles are too large in a cooked mesh with " << desc.points.count << " vertices!\n";
+
+			PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+			PxTriangleMesh* mesh = Physics->createTriangleMesh(readBuffer);
+			if (!mesh || !bDiskCacheEnabled)
+				return mesh;
+
+			// Write to a temporary file first, so a partially written file never replaces a valid one.
+			const CachedMeshFileHeader header{ CachedMeshFileMagic, CachedMeshFileVersion, key, static_cast<std::uint32_t>(vertices.size()), static_cast<std::uint32_t>(indices.size()), writeBuffer.getSize() };
+			const String path = GetCachedMeshPath(key), tempPath = path + ".tmp";
+			{
+				std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(reinterpret_cast<const char*>(writeBuffer.getData()), static_cast<std::streamsize>(writeBuffer.getSize()));
+				if (!file.good())
+				{
+					std::cout << "ERROR: Cannot write cooked mesh cache file " << tempPath << ".\n";
+					return mesh;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tempPath, path, error);
+			if (error)
+			{
+				std::cout << "ERROR: Cannot write cooked mesh cache file " << path << " (" << error.message() << ").\n";
+				std::filesystem::remove(tempPath, error);
+			}
+
+			return mesh;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <utility/Utility.h>
+#include <math/Vec.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace physx
+{
+	class PxPhysics;
+	class PxCooking;
+	class PxTriangleMesh;
+}
+
+namespace GEE
+{
+	namespace Physics
+	{
+		/**
+		 * @brief Cache of cooked triangle meshes, in memory and on the disk.
+		 * A mesh is keyed by a hash of its vertices, its indices, the cooking parameters and the PhysX version, so any change of them makes the mesh be cooked again.
+		 * Identical meshes are cooked and created only once; shapes of different sizes share the same PxTriangleMesh and only differ by their PxMeshScale.
+		 * Must be used by a single thread.
+		*/
+		class CookedMeshCache
+		{
+		public:
+			/**
+			 * @brief Counters of the meshes requested since the cache was initialized.
+			*/
+			struct Stats
+			{
+				unsigned int Reused = 0;	// already created in this run
+				unsigned int LoadedFromDisk = 0;
+				unsigned int Cooked = 0;
+				Time LoadingTime = 0.0;
+				Time CookingTime = 0.0;
+			};
+
+			CookedMeshCache();
+
+			void Init(physx::PxPhysics&, physx::PxCooking&, const String& directory = "PhysXCache/");
+			/**
+			 * @brief Allows to force cooking every mesh (e.g. while comparing the results). Meshes which are already created are still reused.
+			*/
+			void SetDiskCacheEnabled(bool enabled) { bDiskCacheEnabled = enabled; }
+
+			/**
+			 * @return the triangle mesh with the given vertices and indices (3 per triangle) or nullptr if it cannot be cooked. The mesh is owned by the cache; shapes which use it acquire their own references.
+			*/
+			physx::PxTriangleMesh* GetTriangleMesh(const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices);
+
+			/**
+			 * @brief Releases all the meshes. Must be called before PxPhysics is released.
+			*/
+			void Clear();
+
+			[[nodiscard]] const Stats& GetStats() const { return CurrentStats; }
+			void PrintStats() const;
+
+		private:
+			struct CachedMesh
+			{
+				physx::PxTriangleMesh* Mesh;
+				std::uint32_t VertexCount, IndexCount;
+			};
+
+			std::uint64_t ComputeKey(const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices) const;
+			String GetCachedMeshPath(std::uint64_t key) const;
+			physx::PxTriangleMesh* LoadFromDisk(std::uint64_t key, std::uint32_t vertexCount, std::uint32_t indexCount);
+			physx::PxTriangleMesh* Cook(std::uint64_t key, const std::vector<Vec3f>& vertices, const std::vector<unsigned int>& indices);
+
+			physx::PxPhysics* Physics;
+			physx::PxCooking* Cooking;
+			std::uint64_t CookingParamsHash;
+			String Directory;
+			bool bDiskCacheEnabled;
+
+			std::unordered_map<std::uint64_t, CachedMesh> Meshes;
+			Stats CurrentStats;
+		};
+	}
+}
@@ -0,0 +1,32 @@
+#include <physics/JobCpuDispatcher.h>
+#include <utility/Jobs.h>
+#include <PhysX/task/PxTask.h>
+
+namespace GEE
+{
+	namespace Physics
+	{
+		JobCpuDispatcher::JobCpuDispatcher(JobSystem& jobs) :
+			Jobs(jobs)
+		{
+		}
+
+		void JobCpuDispatcher::submitTask(physx::PxBaseTask& task)
+		{
+			// PhysX waits for its tasks without executing jobs itself (e.g. in fetchResults), so without workers the task has to be run immediately - like PxDefaultCpuDispatcher with 0 threads does.
+			if (Jobs.GetWorkerCount() == 0)
+			{
+				task.run();
+				task.release();
+				return;
+			}
+
+			Jobs.Schedule([&task]() { task.run(); task.release(); });
+		}
+
+		uint32_t JobCpuDispatcher::getWorkerCount() const
+		{
+			return Jobs.GetWorkerCount();
+		}
+	}
+}
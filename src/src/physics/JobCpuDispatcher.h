@@ -0,0 +1,25 @@
+#pragma once
+#include <PhysX/task/PxCpuDispatcher.h>
+
+namespace GEE
+{
+	class JobSystem;
+
+	namespace Physics
+	{
+		/**
+		 * @brief Runs PhysX tasks on the workers of a JobSystem, so the physics simulation does not need a thread pool of its own (which would compete with the engine's workers for the cores).
+		*/
+		class JobCpuDispatcher : public physx::PxCpuDispatcher
+		{
+		public:
+			JobCpuDispatcher(JobSystem& jobs);
+
+			void submitTask(physx::PxBaseTask& task) override;
+			uint32_t getWorkerCount() const override;
+
+		private:
+			JobSystem& Jobs;
+		};
+	}
+}
@@ -6,6 +6,8 @@
 #include <physics/CollisionObject.h>
 #include <rendering/Mesh.h>
 #include <math/Transform.h>
+#include <utility/Jobs.h>
+#include <utility/ScopeProfiler.h>
 
 using namespace physx;
 
@@ -22,24 +24,32 @@ namespace GEE
 			Dispatcher(nullptr),
 			DefaultMaterial(nullptr),
 			Pvd(nullptr),
-			WasSetup(false)
+			WasSetup(false),
+			bAsyncSimulation(false),
+			bInterpolateTransforms(false),
+			bSimulating(false)
 		{
-			glGenVertexArrays(1, &VAO);
-			glGenBuffers(1, &VBO);
-
-			glBindVertexArray(VAO);
-			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(nullptr));
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(sizeof(float) * 3));
-			glEnableVertexAttribArray(0);
-			glEnableVertexAttribArray(1);
-
+			VAO = VBO = 0;
 			DebugModePtr = debugmode;
 		}
 
 		void PhysicsEngine::Init()
 		{
+			// The debug rendering buffers are not needed if there is no OpenGL context.
+			if (!GameManager::IsHeadless())
+			{
+				glGenVertexArrays(1, &VAO);
+				glGenBuffers(1, &VBO);
+
+				glBindVertexArray(VAO);
+				glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+				glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(nullptr));
+				glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(sizeof(float) * 3));
+				glEnableVertexAttribArray(0);
+				glEnableVertexAttribArray(1);
+			}
+
 			if (!Foundation)
 				Foundation = PxCreateFoundation(PX_PHYSICS_VERSION, Allocator, ErrorCallback);
 
@@ -55,6 +65,8 @@ namespace GEE
 			Cooking = PxCreateCooking(PX_PHYSICS_VERSION, *Foundation, PxCookingParams(PxTolerancesScale()));
 			if (!Cooking)
 				std::cerr << "ERROR! Can't initialize cooking.\n";
+			else
+				CookedMeshes.Init(*Physics, *Cooking);
 
 			DefaultMaterial = Physics->createMaterial(1.0f, 0.5f, 1.0f);
 		}
@@ -67,33 +79,11 @@ namespace GEE
 				return nullptr;
 			}
 
-			PxTriangleMeshDesc desc;
-			desc.points.count = static_cast<physx::PxU32>(colShape->VertData.size());
-			desc.points.stride = static_cast<physx::PxU32>(sizeof(Vec3f));
-			desc.points.data = &colShape->VertData[0];
-
-			desc.triangles.count = static_cast<physx::PxU32>(colShape->IndicesData.size() / 3);
-			desc.triangles.stride = sizeof(unsigned int) * 3;
-			desc.triangles.data = &colShape->IndicesData[0];
-
-			PxDefaultMemoryOutputStream writeBuffer;
-			PxTriangleMeshCookingResult::Enum result;
-			bool status = Cooking->cookTriangleMesh(desc, writeBuffer, &result);
-			if (!status)
-			{
-				std::cerr << "ERROR! Can't cook mesh with " << desc.points.count << " vertices.\n";
+			// Identical meshes share a single PxTriangleMesh; only the scale differs between their shapes.
+			PxTriangleMesh* mesh = CookedMeshes.GetTriangleMesh(colShape->VertData, colShape->IndicesData);
+			if (!mesh)
 				return nullptr;
-			}
 
-			switch (result)
-			{
-			case PxTriangleMeshCookingResult::Enum::eSUCCESS: std::cout << "INFO: Succesfully cooked a mesh with " << desc.points.count << " vertices.\n"; break;
-			case PxTriangleMeshCookingResult::Enum::eLARGE_TRIANGLE: std::cout << "INFO: Triangles are too large in a cooked mesh!\n"; break;
-			case PxTriangleMeshCookingResult::Enum::eFAILURE: std::cout << "ERROR! Can't cook a mesh\n"; return nullptr;
-			}
-
-			PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-			PxTriangleMesh* mesh = Physics->createTriangleMesh(readBuffer);
 			PxMeshScale meshScale(toPx(scale));
 
 			return Physics->createShape(PxTriangleMeshGeometry(mesh, meshScale, PxMeshGeometryFlag::eDOUBLE_SIDED), *DefaultMaterial);
@@ -104,6 +94,8 @@ namespace GEE
 			if (object.ActorPtr)
 			{
 				std::cout << "INFO: The given CollisionObject is already associated with a PxActor object. No PxActor will be created.\n";
+				if (!object.ActorPtr->userData)	// e.g. the actor of a PxController
+					object.ActorPtr->userData = &object;
 				return;
 			}
 			if (!object.TransformPtr)
@@ -133,6 +125,7 @@ namespace GEE
 
 		void PhysicsEngine::RemoveScenePhysicsDataPtr(GameScenePhysicsData& scenePhysicsData)
 		{
+			FetchResults();	// the scene will be released
 			ScenesPhysicsData.erase(std::remove_if(ScenesPhysicsData.begin(), ScenesPhysicsData.end(), [&scenePhysicsData](GameScenePhysicsData* scenePhysicsDataVec) { return scenePhysicsDataVec == &scenePhysicsData; }), ScenesPhysicsData.end());
 		}
 
@@ -170,7 +163,9 @@ namespace GEE
 				object.ActorPtr = (object.IsStatic) ?
 					(static_cast<PxRigidActor*>(PxCreateStatic(*Physics, toPx(*object.TransformPtr), *shape.ShapePtr))) :
 					(static_cast<PxRigidActor*>(PxCreateDynamic(*Physics, toPx(*object.TransformPtr), *shape.ShapePtr, 10.0f)));
+				object.ActorPtr->userData = &object;	// used to find the objects of active actors
 				object.TransformDirtyFlag = object.TransformPtr->AddDirtyFlag();
+				object.PreviousPose = object.LatestPose = object.ActorPtr->getGlobalPose();
 			}
 			else
 				object.ActorPtr->attachShape(*shape.ShapePtr);
@@ -219,13 +214,15 @@ namespace GEE
 			if (!Physics)
 				return;
 			PxSceneDesc sceneDesc(Physics->getTolerancesScale());
-			Dispatcher = PxDefaultCpuDispatcherCreate(2);
+			if (!Dispatcher)
+				Dispatcher = MakeUnique<JobCpuDispatcher>(JobSystem::Get());
 
 			sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
-			sceneDesc.cpuDispatcher = Dispatcher;
+			sceneDesc.cpuDispatcher = Dispatcher.get();
 			sceneDesc.filterShader = testCCDFilterShader;
 			//sceneDesc.filterShader = testCCD;
 			sceneDesc.flags |= PxSceneFlag::eENABLE_CCD;
+			sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;	// only the actors moved by a step are written back to their Transforms
 			sceneDesc.bounceThresholdVelocity = 0.5f;
 			scenePhysicsData.PhysXScene = Physics->createScene(sceneDesc);
 
@@ -262,17 +259,70 @@ namespace GEE
 
 		void PhysicsEngine::Update(Time deltaTime)
 		{
+			Simulate(deltaTime);
+			FetchResults();
+		}
+
+		void PhysicsEngine::Simulate(Time deltaTime)
+		{
+			FetchResults();
+			GEE_PROFILE_SCOPE("Physics simulate");
 			UpdatePxTransforms();
 
 			for (int i = 0; i < static_cast<int>(ScenesPhysicsData.size()); i++)
-			{
 				ScenesPhysicsData[i]->PhysXScene->simulate(static_cast<physx::PxReal>(deltaTime));
+
+			bSimulating = true;
+		}
+
+		void PhysicsEngine::FetchResults()
+		{
+			if (!bSimulating)
+				return;
+
+			GEE_PROFILE_SCOPE("Physics fetch results");
+			for (int i = 0; i < static_cast<int>(ScenesPhysicsData.size()); i++)
 				ScenesPhysicsData[i]->PhysXScene->fetchResults(true);
-			}
 
+			bSimulating = false;
 			UpdateTransforms();
 		}
 
+		void PhysicsEngine::SetAsyncSimulation(bool enabled)
+		{
+			if (!enabled)
+				FetchResults();
+			bAsyncSimulation = enabled;
+		}
+
+		void PhysicsEngine::InterpolateTransforms(float alpha)
+		{
+			GEE_PROFILE_SCOPE("Physics interpolation");
+			for (auto scenePhysicsData : ScenesPhysicsData)
+				for (CollisionObject* obj : scenePhysicsData->ActiveCollisionObjects)
+				{
+					const Vec3f position = glm::mix(toGlm(obj->PreviousPose.p), toGlm(obj->LatestPose.p), alpha);
+					const Quatf rotation = glm::slerp(toGlm(obj->PreviousPose.q), toGlm(obj->LatestPose.q), alpha);
+					WritePoseToTransform(*obj, PxTransform(toPx(position), toPx(rotation)));
+				}
+		}
+
+		void PhysicsEngine::WritePoseToTransform(CollisionObject& obj, const PxTransform& pose)
+		{
+			// Make sure that we do not change the flag which corresponds to updating px transforms, nor queue the object to be sent back to PhysX
+			bool flagBefore = obj.TransformPtr->GetDirtyFlag(obj.TransformDirtyFlag, false);
+			const bool queuedBefore = obj.TransformChangeQueued.exchange(true);
+
+			obj.TransformPtr->SetPositionWorld(toGlm(pose.p));
+			if (!obj.IgnoreRotation)
+				obj.TransformPtr->SetRotationWorld(toGlm(pose.q));
+
+			if (!flagBefore)
+				obj.TransformPtr->SetDirtyFlag(obj.TransformDirtyFlag, false);
+			if (!queuedBefore)
+				obj.TransformChangeQueued = false;
+		}
+
 		void PhysicsEngine::UpdateTransforms()
 		{
 			/*physx::PxRaycastBuffer castBuffer;
@@ -281,24 +331,29 @@ namespace GEE
 
 			bool hit = ScenesPhysicsData[0]->GetPxScene()->raycast()*/
 
-			for (int sceneIndex = 0; sceneIndex < static_cast<int>(ScenesPhysicsData.size()); sceneIndex++)
+			for (auto scenePhysicsData : ScenesPhysicsData)
 			{
-				for (int i = 0; i < static_cast<int>(ScenesPhysicsData[sceneIndex]->CollisionObjects.size()); i++)
+				// Objects which stopped moving (e.g. fell asleep) are no longer interpolated, so they are put back at their latest pose.
+				for (CollisionObject* obj : scenePhysicsData->ActiveCollisionObjects)
 				{
-					CollisionObject* obj = ScenesPhysicsData[sceneIndex]->CollisionObjects[i];
-					if (!obj->ActorPtr || !obj->TransformPtr)
-						continue;
-
-					// Make sure that we do not change the flag which corresponds to updating px transforms
-					bool flagBefore = obj->TransformPtr->GetDirtyFlag(obj->TransformDirtyFlag, false);
+					obj->PreviousPose = obj->LatestPose;
+					if (bInterpolateTransforms)
+						WritePoseToTransform(*obj, obj->LatestPose);
+				}
+				scenePhysicsData->ActiveCollisionObjects.clear();
 
-					PxTransform pxTransform = obj->ActorPtr->getGlobalPose();
-					obj->TransformPtr->SetPositionWorld(toGlm(pxTransform.p));
-					if (!obj->IgnoreRotation)
-						obj->TransformPtr->SetRotationWorld(toGlm(pxTransform.q));
+				// Sleeping and static actors are not reported, so the cost depends on how many objects move, not on the size of the world.
+				PxU32 activeActorCount = 0;
+				PxActor** activeActors = scenePhysicsData->PhysXScene->getActiveActors(activeActorCount);
+				for (PxU32 i = 0; i < activeActorCount; i++)
+				{
+					CollisionObject* obj = static_cast<CollisionObject*>(activeActors[i]->userData);
+					if (!obj || !obj->ActorPtr || !obj->TransformPtr)
+						continue;
 
-					if (!flagBefore)
-						obj->TransformPtr->SetDirtyFlag(obj->TransformDirtyFlag, false);
+					obj->LatestPose = obj->ActorPtr->getGlobalPose();
+					WritePoseToTransform(*obj, obj->LatestPose);
+					scenePhysicsData->ActiveCollisionObjects.push_back(obj);
 
 					//obj->TransformPtr->SetMatrix(t.Matrix);
 				}
@@ -307,11 +362,17 @@ namespace GEE
 
 		void PhysicsEngine::UpdatePxTransforms()
 		{
-			for (int sceneIndex = 0; sceneIndex < static_cast<int>(ScenesPhysicsData.size()); sceneIndex++)
+			for (auto scenePhysicsData : ScenesPhysicsData)
 			{
-				for (int i = 0; i < static_cast<int>(ScenesPhysicsData[sceneIndex]->CollisionObjects.size()); i++)
+				// Only the objects whose Transforms were changed since the last step are queued (see CollisionObject::TransformListener).
+				{
+					std::lock_guard<std::mutex> lock(scenePhysicsData->TransformChangeQueueMutex);
+					ChangedObjects.swap(scenePhysicsData->TransformChangeQueue);
+				}
+
+				for (CollisionObject* obj : ChangedObjects)
 				{
-					CollisionObject* obj = ScenesPhysicsData[sceneIndex]->CollisionObjects[i];
+					obj->TransformChangeQueued = false;
 					if (!obj->ActorPtr || !obj->TransformPtr || !obj->TransformPtr->GetDirtyFlag(obj->TransformDirtyFlag))
 						continue;
 
@@ -381,9 +442,11 @@ namespace GEE
 					}
 
 					obj->ActorPtr->setGlobalPose(pxTransform);
+					obj->PreviousPose = obj->LatestPose = pxTransform;	// do not interpolate from the pose before the object was moved by the engine
 
 					//delete[] shapes;
 				}
+				ChangedObjects.clear();
 			}
 		}
 
@@ -396,10 +459,13 @@ namespace GEE
 
 		PhysicsEngine::~PhysicsEngine()
 		{
+			FetchResults();
 			for (int i = 0; i < static_cast<int>(ScenesPhysicsData.size()); i++)
 				ScenesPhysicsData[i]->PhysXScene->release();
 
-			Dispatcher->release();
+			Dispatcher = nullptr;
+			CookedMeshes.PrintStats();
+			CookedMeshes.Clear();
 			Physics->release();
 			Cooking->release();
 
@@ -1,5 +1,7 @@
 #pragma once
 #include <PhysX/PxPhysicsAPI.h>
+#include <physics/JobCpuDispatcher.h>
+#include <physics/CookedMeshCache.h>
 
 #include <math/Vec.h>
 
@@ -24,6 +26,11 @@ namespace GEE
 			physx::PxShape* CreateTriangleMeshShape(CollisionShape*, Vec3f scale);
 			void AddCollisionObjectToPxPipeline(GameScenePhysicsData& scenePhysicsData, CollisionObject&) override;
 
+			/**
+			 * @brief Writes a pose into the Transform of the object without marking the Transform as changed by the engine, so the pose is not sent back to PhysX.
+			*/
+			static void WritePoseToTransform(CollisionObject&, const physx::PxTransform&);
+
 			void AddScenePhysicsDataPtr(GameScenePhysicsData& scenePhysicsData);
 			void RemoveScenePhysicsDataPtr(GameScenePhysicsData& scenePhysicsData) override;
 
@@ -35,8 +42,43 @@ namespace GEE
 
 			void SetupScene(GameScenePhysicsData& scenePhysicsData);
 
+			/**
+			 * @brief Performs a whole simulation step and waits for it; the same as Simulate() followed by FetchResults().
+			*/
 			void Update(Time deltaTime);
+			/**
+			 * @brief Sends the transforms changed by the engine to PhysX and starts a simulation step of every scene, without waiting for it.
+			 * Until FetchResults() is called, the physics scenes must not be modified and the Transforms of collision objects keep the poses of the previous step.
+			*/
+			void Simulate(Time deltaTime);
+			/**
+			 * @brief Waits for the step started by Simulate() and writes the new poses into the Transforms of collision objects. Does nothing if no step is in progress.
+			*/
+			void FetchResults() override;
+			bool IsSimulating() const { return bSimulating; }
+
+			/**
+			 * @brief In the asynchronous mode, Game starts each step at the end of its fixed update and fetches its results at the start of the next one, so PhysX worker threads simulate while the main thread renders.
+			 * Rendering uses the poses of the previous step (or poses interpolated between the two previous steps, see SetTransformInterpolation()).
+			*/
+			void SetAsyncSimulation(bool enabled) override;
+			bool IsAsyncSimulationEnabled() const { return bAsyncSimulation; }
+			void SetTransformInterpolation(bool enabled) override { bInterpolateTransforms = enabled; }
+			bool IsTransformInterpolationEnabled() const { return bInterpolateTransforms; }
+			/**
+			 * @brief Moves dynamic collision objects to poses interpolated between the two latest steps, so their movement is smooth when the frame rate differs from the simulation rate. Called before rendering.
+			 * The interpolated poses are not sent back to PhysX and are overwritten by the next step.
+			 * @param alpha: the fraction of the time step which has passed since the latest step, from 0 to 1.
+			*/
+			void InterpolateTransforms(float alpha);
+
+			/**
+			 * @brief Writes the poses of the actors moved by the latest step (reported by PhysX as active) into the Transforms of their collision objects.
+			*/
 			void UpdateTransforms();
+			/**
+			 * @brief Sends the Transforms of the collision objects queued since the latest step (changed by the engine) to PhysX.
+			*/
 			void UpdatePxTransforms();
 
 			void ConnectToPVD();
@@ -50,8 +92,9 @@ namespace GEE
 			static physx::PxFoundation* Foundation;
 			physx::PxPhysics* Physics;
 
-			physx::PxDefaultCpuDispatcher* Dispatcher;
+			UniquePtr<JobCpuDispatcher> Dispatcher;	// shared by all scenes
 			physx::PxCooking* Cooking;
+			CookedMeshCache CookedMeshes;
 
 			physx::PxMaterial* DefaultMaterial;
 			physx::PxPvd* Pvd;
@@ -59,6 +102,8 @@ namespace GEE
 			std::vector <GameScenePhysicsData*> ScenesPhysicsData;
 			unsigned int VAO, VBO;
 			bool WasSetup;
+			bool bAsyncSimulation, bInterpolateTransforms, bSimulating;
+			std::vector<CollisionObject*> ChangedObjects;	// the transform change queue of the scene being updated, swapped out to keep its capacity
 			bool* DebugModePtr;
 		};
 
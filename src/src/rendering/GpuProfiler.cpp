@@ -0,0 +1,175 @@
+#include <rendering/GpuProfiler.h>
+#include <glad/glad.h>
+#include <array>
+
+namespace GEE
+{
+	bool GpuProfiler::bEnabled = false;
+	RenderPassStats GpuProfiler::TotalStats;
+
+	RenderPassStats RenderPassStats::operator-(const RenderPassStats& stats) const
+	{
+		RenderPassStats difference;
+		difference.DrawCalls = DrawCalls - stats.DrawCalls;
+		difference.Triangles = Triangles - stats.Triangles;
+		difference.TextureBinds = TextureBinds - stats.TextureBinds;
+		difference.ShaderBinds = ShaderBinds - stats.ShaderBinds;
+		return difference;
+	}
+
+	namespace
+	{
+		struct RecordedPass
+		{
+			const char* Name;
+			unsigned int Depth;
+			RenderPassStats StatsBegin, StatsEnd;
+			bool bEnded;
+		};
+
+		struct BufferedFrame
+		{
+			std::vector<RecordedPass> Passes;	// pass i uses queries 2i (begin) and 2i + 1 (end) of the frame
+			std::int64_t GpuToCpuOffset = 0;	// added to GPU timestamps to convert them to ScopeProfiler timestamps
+			GLuint LastQuery = 0;	// queries finish in the order they were issued, so the frame is available if its last query is
+		};
+
+		std::vector<GLuint> Queries;	// BufferedFrameCount * MaxPassesPerFrame * 2, generated when the profiler is first enabled
+		std::array<BufferedFrame, GpuProfiler::BufferedFrameCount> Frames;
+		unsigned int CurrentFrame = 0;
+		bool bFrameBegun = false;
+		std::vector<unsigned int> OpenPasses;	// indices of the passes which have begun, but have not ended yet
+		std::vector<GpuPassResult> LatestResults;
+		unsigned int DroppedFrameCount = 0;
+		ScopeTrack* GpuTrack = nullptr;
+
+		GLuint GetQuery(unsigned int frameIndex, unsigned int passIndex, bool end)
+		{
+			return Queries[(frameIndex * GpuProfiler::MaxPassesPerFrame + passIndex) * 2 + ((end) ? (1) : (0))];
+		}
+
+		void ReadResults(unsigned int frameIndex)
+		{
+			BufferedFrame& frame = Frames[frameIndex];
+			if (frame.Passes.empty() || frame.LastQuery == 0)	// nothing was measured or no pass has ended
+				return;
+
+			GLint available = 0;
+			glGetQueryObjectiv(frame.LastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				DroppedFrameCount++;
+				return;
+			}
+
+			if (ScopeProfiler::IsEnabled() && !GpuTrack)
+				GpuTrack = &ScopeProfiler::AddTrack("GPU");
+
+			LatestResults.clear();
+			for (unsigned int i = 0; i < static_cast<unsigned int>(frame.Passes.size()); i++)
+			{
+				const RecordedPass& pass = frame.Passes[i];
+				if (!pass.bEnded)
+					continue;
+
+				GLuint64 beginTimestamp = 0, endTimestamp = 0;
+				glGetQueryObjectui64v(GetQuery(frameIndex, i, false), GL_QUERY_RESULT, &beginTimestamp);
+				glGetQueryObjectui64v(GetQuery(frameIndex, i, true), GL_QUERY_RESULT, &endTimestamp);
+				LatestResults.push_back(GpuPassResult{ pass.Name, pass.Depth, static_cast<double>(endTimestamp - beginTimestamp) / 1000000.0, pass.StatsEnd - pass.StatsBegin });
+
+				if (ScopeProfiler::IsEnabled())
+					ScopeProfiler::RecordScope(*GpuTrack, pass.Name, static_cast<std::uint64_t>(static_cast<std::int64_t>(beginTimestamp) + frame.GpuToCpuOffset), static_cast<std::uint64_t>(static_cast<std::int64_t>(endTimestamp) + frame.GpuToCpuOffset));
+			}
+		}
+	}
+
+	void GpuProfiler::SetEnabled(bool enabled)
+	{
+		if (enabled && Queries.empty())
+		{
+			Queries.resize(BufferedFrameCount * MaxPassesPerFrame * 2);
+			glGenQueries(static_cast<GLsizei>(Queries.size()), Queries.data());
+		}
+
+		if (!enabled)
+		{
+			for (auto& frame : Frames)
+				frame.Passes.clear();
+			OpenPasses.clear();
+			bFrameBegun = false;
+		}
+
+		bEnabled = enabled;
+	}
+
+	void GpuProfiler::BeginFrame()
+	{
+		if (!bEnabled)
+			return;
+
+		OpenPasses.clear();	// in case a pass was not ended
+		CurrentFrame = (CurrentFrame + 1) % BufferedFrameCount;
+		ReadResults(CurrentFrame);	// the oldest frame, issued BufferedFrameCount - 1 frames ago
+
+		BufferedFrame& frame = Frames[CurrentFrame];
+		frame.Passes.clear();
+		frame.LastQuery = 0;
+
+		// The GPU time of the moment commands issued now reach the GPU; it does not wait for them.
+		GLint64 gpuTimestamp = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuTimestamp);
+		frame.GpuToCpuOffset = static_cast<std::int64_t>(ScopeProfiler::GetTimestamp()) - static_cast<std::int64_t>(gpuTimestamp);
+
+		bFrameBegun = true;
+	}
+
+	bool GpuProfiler::BeginPass(const char* name)
+	{
+		BufferedFrame& frame = Frames[CurrentFrame];
+		if (!bEnabled || !bFrameBegun || frame.Passes.size() >= MaxPassesPerFrame)
+			return false;
+
+		const unsigned int passIndex = static_cast<unsigned int>(frame.Passes.size());
+		glQueryCounter(GetQuery(CurrentFrame, passIndex, false), GL_TIMESTAMP);
+		frame.Passes.push_back(RecordedPass{ name, static_cast<unsigned int>(OpenPasses.size()), TotalStats, TotalStats, false });
+		OpenPasses.push_back(passIndex);
+
+		return true;
+	}
+
+	void GpuProfiler::EndPass()
+	{
+		if (OpenPasses.empty())
+			return;
+
+		const unsigned int passIndex = OpenPasses.back();
+		OpenPasses.pop_back();
+
+		BufferedFrame& frame = Frames[CurrentFrame];
+		const GLuint query = GetQuery(CurrentFrame, passIndex, true);
+		glQueryCounter(query, GL_TIMESTAMP);
+		frame.Passes[passIndex].StatsEnd = TotalStats;
+		frame.Passes[passIndex].bEnded = true;
+		frame.LastQuery = query;
+	}
+
+	const std::vector<GpuPassResult>& GpuProfiler::GetLatestResults()
+	{
+		return LatestResults;
+	}
+
+	double GpuProfiler::GetLatestFrameGpuTime()
+	{
+		double gpuTime = 0.0;
+		for (const GpuPassResult& result : LatestResults)
+			if (result.Depth == 0)
+				gpuTime += result.GpuTime;
+
+		return gpuTime;
+	}
+
+	unsigned int GpuProfiler::GetDroppedFrameCount()
+	{
+		return DroppedFrameCount;
+	}
+}
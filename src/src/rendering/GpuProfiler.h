@@ -0,0 +1,103 @@
+#pragma once
+#include <utility/ScopeProfiler.h>
+#include <cstdint>
+#include <vector>
+
+#ifndef GEE_DISABLE_SCOPE_PROFILER
+	/**
+	 * @brief Profiles the enclosing scope as a render pass: records its CPU time (like GEE_PROFILE_SCOPE), its GPU time and its RenderPassStats. The name must be a string with static storage duration.
+	*/
+	#define GEE_PROFILE_RENDER_PASS(name) GEE_PROFILE_SCOPE(name); ::GEE::GpuPassScope GEE_PROFILE_CONCAT(geeGpuPassScope, __LINE__)(name)
+#else
+	#define GEE_PROFILE_RENDER_PASS(name)
+#endif
+
+namespace GEE
+{
+	/**
+	 * @brief Work submitted to OpenGL. Counted all the time; the counting is a few increments per draw call.
+	*/
+	struct RenderPassStats
+	{
+		unsigned int DrawCalls = 0;
+		std::uint64_t Triangles = 0;
+		unsigned int TextureBinds = 0;
+		unsigned int ShaderBinds = 0;
+
+		RenderPassStats operator-(const RenderPassStats&) const;
+	};
+
+	struct GpuPassResult
+	{
+		const char* Name;
+		unsigned int Depth;	// the number of passes this pass is nested in
+		double GpuTime;	// in milliseconds, including nested passes
+		RenderPassStats Stats;	// including nested passes
+	};
+
+	/**
+	 * @brief Measures the GPU time of render passes with pairs of GL_TIMESTAMP queries (which, unlike GL_TIME_ELAPSED queries, can be nested).
+	 * The queries of a frame are read BufferedFrameCount - 1 frames later, only if they are already available, so reading them never stalls the CPU; results which are not available by then are dropped.
+	 * When the ScopeProfiler is enabled, the GPU times are also recorded to its "GPU" track, converted to the CPU clock.
+	 * Must be used by the thread which owns the OpenGL context.
+	*/
+	class GpuProfiler
+	{
+	public:
+		static constexpr unsigned int BufferedFrameCount = 3;
+		static constexpr unsigned int MaxPassesPerFrame = 256;	// further passes of a frame are not measured
+
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled() { return bEnabled; }
+
+		/**
+		 * @brief Reads the results of the oldest buffered frame and starts measuring a new one. Called by the game loop before rendering.
+		*/
+		static void BeginFrame();
+		/**
+		 * @return true if the pass is measured; EndPass() must be called then.
+		*/
+		static bool BeginPass(const char* name);
+		static void EndPass();
+
+		/**
+		 * @return the passes of the latest frame whose results were read, in the order they began.
+		*/
+		static const std::vector<GpuPassResult>& GetLatestResults();
+		/**
+		 * @return the GPU time of the passes which are not nested in other passes of the latest read frame, in milliseconds.
+		*/
+		static double GetLatestFrameGpuTime();
+		/**
+		 * @return the number of frames whose results were dropped, because they were not available in time.
+		*/
+		static unsigned int GetDroppedFrameCount();
+
+		/**
+		 * @return the stats counted since the program started.
+		*/
+		static const RenderPassStats& GetTotalStats() { return TotalStats; }
+		static void CountDrawCall(std::uint64_t triangleCount) { TotalStats.DrawCalls++; TotalStats.Triangles += triangleCount; }
+		static void CountTextureBind() { TotalStats.TextureBinds++; }
+		static void CountShaderBind() { TotalStats.ShaderBinds++; }
+
+	private:
+		static bool bEnabled;
+		static RenderPassStats TotalStats;
+	};
+
+	/**
+	 * @brief Created by GEE_PROFILE_RENDER_PASS.
+	*/
+	class GpuPassScope
+	{
+	public:
+		explicit GpuPassScope(const char* name) : bMeasured(GpuProfiler::IsEnabled() && GpuProfiler::BeginPass(name)) {}
+		GpuPassScope(const GpuPassScope&) = delete;
+		GpuPassScope& operator=(const GpuPassScope&) = delete;
+		~GpuPassScope() { if (bMeasured) GpuProfiler::EndPass(); }
+
+	private:
+		bool bMeasured;
+	};
+}
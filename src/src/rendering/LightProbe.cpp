@@ -14,6 +14,13 @@ namespace GEE
 		RenderEngineManager* renderHandle = probe.GetScene().GetGameHandle()->GetRenderEngineHandle();
 		probe.Shape = EngineBasicShape::Quad;
 
+		// Probes of headless games have no textures, but the path is kept so the probe is still saved.
+		if (GameManager::IsHeadless())
+		{
+			probe.OptionalFilepath = filepath;
+			return;
+		}
+
 		Texture erTexture = Texture::Loader<float>::FromFile2D(filepath, Texture::Format::Float16::RGBA(), true, Texture::MinFilter::Bilinear(), Texture::MagFilter::Bilinear());	//load equirectangular hdr texture
 		int layer = probe.GetProbeIndex() * 6;
 
@@ -29,6 +36,9 @@ namespace GEE
 
 	void LightProbeLoader::ConvoluteLightProbe(const LightProbeComponent& probe, const Texture& envMap)
 	{
+		if (GameManager::IsHeadless())
+			return;
+
 		RenderEngineManager* renderHandle = probe.GetScene().GetGameHandle()->GetRenderEngineHandle();
 		LightProbeTextureArrays* probeTexArrays = probe.GetScene().GetRenderData()->GetProbeTexArrays();
 
@@ -45,13 +55,15 @@ namespace GEE
 
 		if (PrimitiveDebugger::bDebugProbeLoading)
 			std::cout << "Prefiltering\n";
-		renderHandle->FindShader("CubemapToPrefilter")->Use();
-		renderHandle->FindShader("CubemapToPrefilter")->Uniform<float>("cubemapNr", static_cast<float>(probe.GetProbeIndex()));
+		Shader* prefilterShader = renderHandle->FindShader("CubemapToPrefilter");
+		const UniformHandle<float> roughnessHandle = prefilterShader->GetHandle<float>("roughness");
+		prefilterShader->Use();
+		prefilterShader->GetHandle<float>("cubemapNr").Set(static_cast<float>(probe.GetProbeIndex()));
 		for (int mipmap = 0; mipmap < 5; mipmap++)
 		{
 			layer = probe.GetProbeIndex() * 6;
-			renderHandle->FindShader("CubemapToPrefilter")->Uniform<float>("roughness", static_cast<float>(mipmap) / 5.0f);
-			CubemapRenderer(*renderHandle).FromTexture(probeTexArrays->PrefilterMapArr, envMap, Vec2f(256.0f) / std::pow(2.0f, static_cast<float>(mipmap)), *renderHandle->FindShader("CubemapToPrefilter"), &layer, mipmap);
+			roughnessHandle.Set(static_cast<float>(mipmap) / 5.0f);
+			CubemapRenderer(*renderHandle).FromTexture(probeTexArrays->PrefilterMapArr, envMap, Vec2f(256.0f) / std::pow(2.0f, static_cast<float>(mipmap)), *prefilterShader, &layer, mipmap);
 		}
 		if (PrimitiveDebugger::bDebugProbeLoading)
 			std::cout << "Ending\n";
@@ -59,6 +71,9 @@ namespace GEE
 
 	void LightProbeLoader::LoadLightProbeTextureArrays(GameSceneRenderData* sceneRenderData)
 	{
+		if (GameManager::IsHeadless())
+			return;
+
 		RenderEngineManager* renderHandle = sceneRenderData->GetRenderHandle();
 		LightProbeTextureArrays* probeTexArrays = sceneRenderData->GetProbeTexArrays();
 		probeTexArrays->IrradianceMapArr = NamedTexture(Texture::Loader<float>::ReserveEmptyCubemapArray(Vec3u(16, 16, 8), Texture::Format::Float16::RGB()), "Irradiance cubemap array");
@@ -117,7 +132,7 @@ namespace GEE
 
 	void LightProbeVolume::SetupRenderUniforms(const Shader& shader) const
 	{
-		shader.Uniform<float>("lightProbeNr", static_cast<float>(ProbePtr->GetProbeIndex()));
+		shader.GetLightProbeNrHandle().Set(static_cast<float>(ProbePtr->GetProbeIndex()));
 	}
 
 	LightProbeTextureArrays::LightProbeTextureArrays() :
@@ -244,7 +244,8 @@ namespace GEE
 				}
 
 
-			SharedPtr<NamedTexture> tex = MakeShared<NamedTexture>(Texture::Loader<unsigned char>::FromFile2D(pathStr, (sRGB) ? (Texture::Format::SRGBA()) : (Texture::Format::RGBA()), false, Texture::MinFilter::Trilinear(), Texture::MagFilter::Bilinear()), shaderName + std::to_string(i + 1));	//create a new Texture and pass the file path, the shader name (for example albedo1, roughness1, ...) and the sRGB info
+			const Texture loadedTex = (matLoadingData) ? (matLoadingData->LoadTextureFile(pathStr, sRGB)) : (Texture::Loader<unsigned char>::FromFile2D(pathStr, (sRGB) ? (Texture::Format::SRGBA()) : (Texture::Format::RGBA()), false, Texture::MinFilter::Trilinear(), Texture::MagFilter::Bilinear()));
+			SharedPtr<NamedTexture> tex = MakeShared<NamedTexture>(loadedTex, shaderName + std::to_string(i + 1));	//create a new Texture and pass the file path, the shader name (for example albedo1, roughness1, ...) and the sRGB info
 			tex->SetWrap(GL_REPEAT, GL_REPEAT, 0, true);
 			AddTexture(tex);
 			if (matLoadingData)
@@ -252,17 +253,26 @@ namespace GEE
 		}
 	}
 
-	void Material::UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault) const
+	void Material::UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault, CachedUniformBuffer<InstanceDataBlock>* instanceBuffer) const
 	{
-		shader->Uniform<Vec2f>("atlasData", Vec2f(0.0f));
+		if (shader->UsesMaterialInstanceDataBlock())
+			MaterialUtil::BindInstanceDataBlock(GetInstanceDataBlock(), (instanceBuffer) ? (*instanceBuffer) : (InstanceDataBuffer));
+		else
+			shader->GetMaterialUniformHandles().AtlasData.Set(Vec2f(0.0f));
 	}
 
 	void Material::UpdateWholeUBOData(Shader* shader, const Texture& emptyTexture) const
 	{
-		shader->Uniform<float>("material.shininess", Shininess);
-		shader->Uniform<float>("material.depthScale", DepthScale);
-		shader->Uniform<Vec4f>("material.color", Color);
-		shader->Uniform<Vec3f>("material.roughnessMetallicAoColor", Vec3f(RoughnessColor, MetallicColor, AoColor));
+		if (shader->UsesMaterialDataBlock())
+			BindDataBlock();
+		else
+		{
+			const Shader::MaterialUniformHandles& handles = shader->GetMaterialUniformHandles();
+			handles.Shininess.Set(Shininess);
+			handles.DepthScale.Set(DepthScale);
+			handles.Color.Set(Color);
+			handles.RoughnessMetallicAoColor.Set(Vec3f(RoughnessColor, MetallicColor, AoColor));
+		}
 
 
 		std::vector<std::pair<unsigned int, std::string>>* textureUnits = shader->GetMaterialTextureUnits();
@@ -289,6 +299,29 @@ namespace GEE
 		shader->CallOnMaterialWholeDataUpdateFunc(*this);
 	}
 
+	void Material::BindDataBlock() const
+	{
+		DataBuffer.Bind(GetDataBlock(), EngineUniformBlockSlot::MaterialData);
+	}
+
+	Material::MaterialDataBlock Material::GetDataBlock() const
+	{
+		// Value-initialize, so the padding is zeroed and the block can be compared bytewise with the uploaded one.
+		MaterialDataBlock block{};
+		block.Color = Color;
+		block.RoughnessMetallicAoColor = Vec3f(RoughnessColor, MetallicColor, AoColor);
+		block.Shininess = Shininess;
+		block.DepthScale = DepthScale;
+		block.bDisableColor = std::any_of(Textures.begin(), Textures.end(), [](const SharedPtr<NamedTexture>& tex) { return tex->GetShaderName() == "albedo1"; });
+
+		return block;
+	}
+
+	Material::InstanceDataBlock Material::GetInstanceDataBlock() const
+	{
+		return InstanceDataBlock{};
+	}
+
 	void Material::GetEditorDescription(EditorDescriptionBuilder descBuilder)
 	{
 		auto getShaderName = [this]() -> String
@@ -434,19 +467,36 @@ namespace GEE
 		return AtlasSize.x * AtlasSize.y - 1.0f;
 	}
 
-	void AtlasMaterial::UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault) const
+	void AtlasMaterial::UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault, CachedUniformBuffer<InstanceDataBlock>* instanceBuffer) const
 	{
 		if (setValuesToDefault)
 			TextureID = 0.0f;
-		shader->Uniform<Vec2f>("atlasData", Vec2f(TextureID, AtlasSize.x));
+
+		if (shader->UsesMaterialInstanceDataBlock())
+			Material::UpdateInstanceUBOData(shader, setValuesToDefault, instanceBuffer);
+		else
+			shader->GetMaterialUniformHandles().AtlasData.Set(Vec2f(TextureID, AtlasSize.x));
 	}
 
 	void AtlasMaterial::UpdateWholeUBOData(Shader* shader, const Texture& emptyTexture) const
 	{
-		UpdateInstanceUBOData(shader);
 		Material::UpdateWholeUBOData(shader, emptyTexture);
 
-		shader->Uniform<Vec2f>("atlasTexOffset", Vec2f(1.0f) / AtlasSize);
+		// The atlas offset is a part of the instance block in shaders which declare it.
+		if (shader->UsesMaterialInstanceDataBlock())
+			return;
+
+		UpdateInstanceUBOData(shader);
+		shader->GetMaterialUniformHandles().AtlasTexOffset.Set(Vec2f(1.0f) / AtlasSize);
+	}
+
+	Material::InstanceDataBlock AtlasMaterial::GetInstanceDataBlock() const
+	{
+		InstanceDataBlock block{};
+		block.AtlasData = Vec2f(TextureID, AtlasSize.x);
+		block.AtlasTexOffset = Vec2f(1.0f) / AtlasSize;
+
+		return block;
 	}
 
 	Interpolator<float>& AtlasMaterial::GetTextureIDInterpolatorTemplate(float constantTextureID)
@@ -545,7 +595,8 @@ namespace GEE
 		MaterialPtr(matInst.MaterialPtr),
 		AnimationInterp(matInst.AnimationInterp),
 		DrawBeforeAnim(matInst.DrawBeforeAnim),
-		DrawAfterAnim(matInst.DrawAfterAnim)
+		DrawAfterAnim(matInst.DrawAfterAnim),
+		InstanceDataBuffer(std::move(matInst.InstanceDataBuffer))
 	{
 		GEE_CORE_ASSERT(MaterialPtr);
 	}
@@ -619,7 +670,7 @@ namespace GEE
 	{
 		if (AnimationInterp)
 			AnimationInterp->UpdateInterpolatedValPtr();	//Update animated values for each instance
-		MaterialPtr->UpdateInstanceUBOData(shader, AnimationInterp == nullptr);	//If no animation is present, just ask for setting the default material values.
+		MaterialPtr->UpdateInstanceUBOData(shader, AnimationInterp == nullptr, &InstanceDataBuffer);	//If no animation is present, just ask for setting the default material values.
 	}
 
 	void MaterialInstance::UpdateWholeUBOData(Shader* shader, const Texture& emptyTexture) const
@@ -634,6 +685,7 @@ namespace GEE
 		AnimationInterp = matInst.AnimationInterp;
 		DrawBeforeAnim = matInst.DrawBeforeAnim;
 		DrawAfterAnim = matInst.DrawAfterAnim;
+		InstanceDataBuffer = std::move(matInst.InstanceDataBuffer);
 
 		return *this;
 	}
@@ -651,6 +703,17 @@ namespace GEE
 	{
 		LoadedTextures.push_back(tex);
 	}
+
+	Texture MaterialLoadingData::LoadTextureFile(const String& path, bool sRGB) const
+	{
+		const Texture::Format internalFormat = (sRGB) ? (Texture::Format::SRGBA()) : (Texture::Format::RGBA());
+		auto found = DecodedImages.find(path);
+		if (found != DecodedImages.end())
+			return Texture::Loader<unsigned char>::FromDecoded2D(found->second, internalFormat, Texture::MinFilter::Trilinear(), Texture::MagFilter::Bilinear());
+
+		return Texture::Loader<unsigned char>::FromFile2D(path, internalFormat, false, Texture::MinFilter::Trilinear(), Texture::MagFilter::Bilinear());
+	}
+
 	Shader* Material::ShaderInfo::RetrieveShaderForRendering(RenderToolboxCollection& tbCol)
 	{
 		if (CustomShader)
@@ -693,12 +756,43 @@ void GEE::MaterialUtil::DisableColorIfAlbedoTextureDetected(Shader& shader, cons
 {
 	bool foundAlbedo = false;
 	for (int i = 0; i < static_cast<int>(mat.GetTextureCount()); i++)
-		if (mat.GetTexture(i).GetShaderName() == "albedo1")
+		if (mat.Textures[i]->GetShaderName() == "albedo1")
 		{
-			shader.Uniform<bool>("material.disableColor", true);
 			foundAlbedo = true;
+			break;
 		}
 
-	if (!foundAlbedo)
-		shader.Uniform<bool>("material.disableColor", false);
+	shader.GetMaterialUniformHandles().DisableColor.Set(foundAlbedo);
+}
+
+void GEE::MaterialUtil::BindInstanceDataBlock(const Material::InstanceDataBlock& data, CachedUniformBuffer<Material::InstanceDataBlock>& instanceBuffer)
+{
+	const Material::InstanceDataBlock defaultData{};
+	if (std::memcmp(&data, &defaultData, sizeof(Material::InstanceDataBlock)) == 0)
+		BindDefaultInstanceDataBlock();
+	else
+		instanceBuffer.Bind(data, EngineUniformBlockSlot::MaterialInstanceData);
+}
+
+void GEE::MaterialUtil::BindDefaultInstanceDataBlock()
+{
+	// Never disposed; it lives as long as the GL context.
+	static UniformBuffer defaultBuffer;
+	if (!defaultBuffer.HasBeenGenerated())
+	{
+		const Material::InstanceDataBlock defaultData{};
+		defaultBuffer.Generate(EngineUniformBlockSlot::MaterialInstanceData, sizeof(Material::InstanceDataBlock), reinterpret_cast<const float*>(&defaultData));
+		return;
+	}
+
+	defaultBuffer.BindToSlot(EngineUniformBlockSlot::MaterialInstanceData, false);
+}
+
+GEE::SharedPtr<GEE::Material> GEE::MaterialUtil::MakeImportedMaterial(const Material::MaterialLoc& loc)
+{
+	const std::string& name = loc.Name;
+	if (name.size() > 6 && name.substr(name.size() - 6) == "_atlas")
+		return std::static_pointer_cast<Material>(MakeShared<AtlasMaterial>(loc, glm::ivec2(4, 2)));	//TODO: remove this ivec2(4, 2)
+
+	return MakeShared<Material>(loc);
 }
@@ -8,10 +8,11 @@
 
 #include <utility/CerealNames.h>
 #include <cereal/access.hpp>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
 #include <cereal/types/polymorphic.hpp>
 #include <cereal/types/memory.hpp>
 #include <cereal/types/vector.hpp>
+#include <unordered_map>
 
 namespace GEE
 {
@@ -98,6 +99,28 @@ namespace GEE
 			Shader* CustomShader;
 		};
 
+		/**
+		 * @brief std140 layout of the "MaterialData" uniform block, which holds the properties of a material that are not textures.
+		*/
+		struct MaterialDataBlock
+		{
+			Vec4f Color;
+			Vec3f RoughnessMetallicAoColor;
+			float Shininess;
+			float DepthScale;
+			int bDisableColor;	// set if the material has an albedo texture
+			float Padding[2];
+		};
+
+		/**
+		 * @brief std140 layout of the "MaterialInstanceData" uniform block, which holds the values that can differ between instances of the same material.
+		*/
+		struct InstanceDataBlock
+		{
+			Vec2f AtlasData;	// x - texture id, y - number of columns in the atlas. (0, 0) if the material is not an atlas.
+			Vec2f AtlasTexOffset;
+		};
+
 	public:
 		explicit Material(MaterialLoc, ShaderInfo = MaterialShaderHint::Simple);
 		explicit Material(MaterialLoc, const Vec3f& color, ShaderInfo = MaterialShaderHint::Simple);
@@ -131,9 +154,25 @@ namespace GEE
 		{
 		}
 		//...and pass the interpolated values to shader in here. I separated these functions for flexibility - you don't always want to interpolate the values each time you use the material for rendering
-		virtual void UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault = false) const;
+		/**
+		 * @param instanceBuffer: the buffer of the "MaterialInstanceData" block to use if the shader declares it. If nullptr, the buffer of this Material is used.
+		*/
+		virtual void UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault = false, CachedUniformBuffer<InstanceDataBlock>* instanceBuffer = nullptr) const;
+		/**
+		 * @brief Binds the textures of this Material and its properties. Shaders which declare the "MaterialData" block get the std140 buffer of this Material (uploaded only if any property has changed since the last upload); other shaders get "material.*" uniforms.
+		*/
 		virtual void UpdateWholeUBOData(Shader*, const Texture& emptyTexture) const;
 
+		/**
+		 * @brief Uploads the "MaterialData" block of this Material if it is out of date and binds it to EngineUniformBlockSlot::MaterialData.
+		*/
+		void BindDataBlock() const;
+		MaterialDataBlock GetDataBlock() const;
+		/**
+		 * @return the current per-instance values of this Material (e.g. the interpolated atlas texture id).
+		*/
+		virtual InstanceDataBlock GetInstanceDataBlock() const;
+
 		template <typename Archive>
 		void Save(Archive& archive) const
 		{
@@ -174,11 +213,27 @@ namespace GEE
 		float DepthScale;
 
 		float RoughnessColor, MetallicColor, AoColor;
+
+	private:
+		mutable CachedUniformBuffer<MaterialDataBlock> DataBuffer;
+		mutable CachedUniformBuffer<InstanceDataBlock> InstanceDataBuffer;
 	};
 
 	namespace MaterialUtil
 	{
 		void DisableColorIfAlbedoTextureDetected(Shader&, const Material&);
+		/**
+		 * @brief Binds the "MaterialInstanceData" block with the passed data. Default (zeroed) data is bound from a buffer shared by all materials, so instances which do not override anything never allocate their own buffer.
+		*/
+		void BindInstanceDataBlock(const Material::InstanceDataBlock&, CachedUniformBuffer<Material::InstanceDataBlock>& instanceBuffer);
+		/**
+		 * @brief Binds the shared buffer with default (zeroed) per-instance data, e.g. to stop the previously bound atlas index from being used.
+		*/
+		void BindDefaultInstanceDataBlock();
+		/**
+		 * @brief Creates an empty material for a material imported from a model file. Materials whose names end with "_atlas" become AtlasMaterials.
+		*/
+		SharedPtr<Material> MakeImportedMaterial(const Material::MaterialLoc&);
 	}
 
 	struct MaterialLoadingData
@@ -187,11 +242,15 @@ namespace GEE
 		//note: LoadedMaterials and LoadedAiMaterials will ALWAYS be the same size
 		std::vector<aiMaterial*> LoadedAiMaterials;
 		std::vector<SharedPtr<NamedTexture>> LoadedTextures;
+		//Images decoded in advance (e.g. by the worker threads of AsyncTreeLoader), keyed by their paths.
+		std::unordered_map<String, Texture::DecodedImage> DecodedImages;
 
 		SharedPtr<NamedTexture> FindTexture(const String& path) const;
 		//Looks for a texture loaded from the given path.
 		void AddTexture(SharedPtr<NamedTexture>);
 		//Adds the given texture to the LoadedTextures vector. Doesn't check for duplicates - do it yourself using FindTexture()
+		Texture LoadTextureFile(const String& path, bool sRGB) const;
+		//Uploads the image decoded in advance if there is one; otherwise loads the file. Texture files of imported models are always loaded through this.
 	};
 
 	/*
@@ -210,8 +269,9 @@ namespace GEE
 		AtlasMaterial(Material&& mat, Vec2i atlasSize = Vec2i(0), ShaderInfo = MaterialShaderHint::Simple);
 		AtlasMaterial(MaterialLoc loc, Vec2i atlasSize = Vec2i(0), ShaderInfo = MaterialShaderHint::Simple);
 		float GetMaxTextureID() const;
-		void UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault = false) const override;
+		void UpdateInstanceUBOData(Shader* shader, bool setValuesToDefault = false, CachedUniformBuffer<InstanceDataBlock>* instanceBuffer = nullptr) const override;
 		void UpdateWholeUBOData(Shader* shader, const Texture& emptyTexture) const override;
+		InstanceDataBlock GetInstanceDataBlock() const override;
 
 		Interpolator<float>& GetTextureIDInterpolatorTemplate(float constantTextureID);
 		Interpolator<float>& GetTextureIDInterpolatorTemplate(const Interpolation&, float min = 0.0f, float max = 0.0f);
@@ -288,7 +348,12 @@ namespace GEE
 			archive(cereal::make_nvp("MaterialName", materialName),
 			        cereal::make_nvp("MaterialOptionalPath", materialPath));
 			SharedPtr<Material> mat = GameManager::Get().GetRenderEngineHandle()->FindMaterial(materialName);
-			if (!mat)
+			if (mat && materialPath.empty() && !cereal::traits::is_text_archive<Archive>::value)
+			{
+				SharedPtr<Material> savedMat;	// binary archives cannot skip values, so the saved material has to be read even though it is already loaded
+				archive(cereal::make_nvp("ExternalMaterial", savedMat));
+			}
+			else if (!mat)
 			{
 				if (materialPath.empty())
 				{
@@ -316,6 +381,8 @@ namespace GEE
 		SharedPtr<Material> MaterialPtr;
 		InterpolatorBase* AnimationInterp; //optional; use if you animate the material
 		bool DrawBeforeAnim, DrawAfterAnim;
+
+		mutable CachedUniformBuffer<Material::InstanceDataBlock> InstanceDataBuffer;
 	};
 
 	// Should be constexpr but fmod isn't
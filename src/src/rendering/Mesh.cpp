@@ -1,6 +1,7 @@
 #include <rendering/Mesh.h>
 #include <assetload/FileLoader.h>
 #include <scene/hierarchy/HierarchyTree.h>
+#include <rendering/GpuProfiler.h>
 
 namespace GEE
 {
@@ -106,26 +107,35 @@ namespace GEE
 
 	void Mesh::Generate(const std::vector <Vertex>& vertices, const std::vector <unsigned int>& indices, bool keepVerts)
 	{
-		glBindVertexArray(0);
-		glGenBuffers(1, &VBO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), &(vertices)[0], GL_STATIC_DRAW);
+		Generate(vertices.data(), vertices.size(), indices.data(), indices.size(), keepVerts);
+	}
 
-		if (!indices.empty())
+	void Mesh::Generate(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount, bool keepVerts)
+	{
+		// Headless games never render meshes; only the counts (and vertices, if they are kept) are needed.
+		if (!GameManager::IsHeadless())
 		{
-			glGenBuffers(1, &EBO);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), &(indices)[0], GL_STATIC_DRAW);
+			glBindVertexArray(0);
+			glGenBuffers(1, &VBO);
+
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertexCount, vertices, GL_STATIC_DRAW);
+
+			if (indexCount > 0)
+			{
+				glGenBuffers(1, &EBO);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indexCount, indices, GL_STATIC_DRAW);
+			}
 		}
 
-		VertexCount = static_cast<unsigned int>(vertices.size());
-		IndexCount = static_cast<unsigned int>(indices.size());
+		VertexCount = static_cast<unsigned int>(vertexCount);
+		IndexCount = static_cast<unsigned int>(indexCount);
 
 		if (keepVerts)
 		{
-			VertsData = MakeShared<std::vector<Vertex>>(vertices);	//copy all vertices to heap
-			IndicesData = MakeShared<std::vector<unsigned int>>(indices);	//copy all indices to heap
+			VertsData = MakeShared<std::vector<Vertex>>(vertices, vertices + vertexCount);	//copy all vertices to heap
+			IndicesData = MakeShared<std::vector<unsigned int>>(indices, indices + indexCount);	//copy all indices to heap
 			std::cout << "Keeping vertices for a mesh that has verts and index count: " << VertexCount << " " << IndexCount << '\n';
 		}
 	}
@@ -167,6 +177,18 @@ namespace GEE
 			glDrawElements(GL_TRIANGLES, IndexCount, GL_UNSIGNED_INT, nullptr);
 		else
 			glDrawArrays(GL_TRIANGLES, 0, VertexCount);
+
+		GpuProfiler::CountDrawCall(((EBO) ? (IndexCount) : (VertexCount)) / 3);
+	}
+
+	void Mesh::RenderInstanced(unsigned int instanceCount) const
+	{
+		if (EBO)
+			glDrawElementsInstanced(GL_TRIANGLES, IndexCount, GL_UNSIGNED_INT, nullptr, instanceCount);
+		else
+			glDrawArraysInstanced(GL_TRIANGLES, 0, VertexCount, instanceCount);
+
+		GpuProfiler::CountDrawCall(static_cast<std::uint64_t>(((EBO) ? (IndexCount) : (VertexCount)) / 3) * instanceCount);
 	}
 
 	/*
@@ -287,6 +309,8 @@ namespace GEE
 
 	template void MeshInstance::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void MeshInstance::load_and_construct<cereal::JSONInputArchive>(cereal::JSONInputArchive&, cereal::construct<MeshInstance>&);
+	template void MeshInstance::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void MeshInstance::load_and_construct<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&, cereal::construct<MeshInstance>&);
 
 	/*
 		====================================================================
@@ -57,8 +57,16 @@ namespace GEE
 		void Bind(unsigned int VAOcontext) const;
 		void LoadFromGLBuffers(unsigned int vertexCount, unsigned int VAO, unsigned int VBO, unsigned int indexCount = 0, unsigned int EBO = 0);
 		void Generate(const std::vector<Vertex>&, const std::vector<unsigned int>&, bool keepVerts = false);
+		/**
+		 * @brief Uploads vertices and indices from any memory (e.g. a mapped cache file), without copying them to vectors first unless keepVerts is true.
+		*/
+		void Generate(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount, bool keepVerts = false);
 		void GenerateVAO(unsigned int VAOcontext = 0);
 		void Render() const;
+		/**
+		 * @brief Draws the mesh instanceCount times in a single draw call. Per-instance attributes must be bound by the caller.
+		*/
+		void RenderInstanced(unsigned int instanceCount) const;
 		/*template <typename Archive> void Save(Archive& archive) const
 		{
 			archive(cereal::make_nvp("HierarchyTreePath", Localization.GetTreeName()), cereal::make_nvp("NodeName", Localization.NodeName), cereal::make_nvp("SpecificName", Localization.SpecificName), cereal::make_nvp("CastsShadow", CastsShadow));
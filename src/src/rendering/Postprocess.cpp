@@ -78,7 +78,7 @@ namespace GEE
 				const Texture& bindTex = (i == 0) ? (tex) : static_cast<Texture>(tb.BlurFramebuffers[!horizontal]->GetColorTexture(0));
 				bindTex.Bind();
 			}
-			tb.GaussianBlurShader->Uniform<int>("horizontal", horizontal);
+			tb.HorizontalHandle.Set(horizontal);
 			ppTb.RenderFullscreenQuad(tb.GaussianBlurShader, false);
 
 			horizontal = !horizontal;
@@ -111,8 +111,8 @@ namespace GEE
 		tb->SSAONoiseTex->Bind(2);
 
 		tb->SSAOShader->Use();
-		tb->SSAOShader->UniformMatrix4fv("view", info.view);
-		tb->SSAOShader->UniformMatrix4fv("projection", info.projection);
+		tb->SSAOViewHandle.Set(info.view);
+		tb->SSAOProjectionHandle.Set(info.projection);
 
 		RenderFullscreenQuad(info, tb->SSAOShader, false);
 
@@ -149,7 +149,7 @@ namespace GEE
 
 		tb.SMAAShaders[1]->Use();
 		if (bT2x)
-			tb.SMAAShaders[1]->Uniform<Vec4f>("ssIndices", (FrameIndex == 0) ? (Vec4f(1, 1, 1, 0)) : (Vec4f(2, 2, 2, 0)));
+			tb.SSIndicesHandle.Set((FrameIndex == 0) ? (Vec4f(1, 1, 1, 0)) : (Vec4f(2, 2, 2, 0)));
 
 		tb.SMAAFb->GetColorTexture(0).Bind(0);	//bind edges texture to slot 0
 		tb.SMAAAreaTex->Bind(1);
@@ -221,7 +221,6 @@ namespace GEE
 		colorTex.Bind(0);
 		if (blurTex.HasBeenGenerated())
 			blurTex.Bind(1);
-		tb.GetTb().TonemapGammaShader->Uniform<int>("HDRbuffer", 0);
 
 		tb.RenderFullscreenQuad(tb.GetTb().TonemapGammaShader);
 
@@ -15,6 +15,7 @@
 #include <input/InputDevicesStateRetriever.h>
 
 #include <rendering/OutlineRenderer.h>
+#include <utility/ScopeProfiler.h>
 
 namespace GEE
 {
@@ -26,6 +27,10 @@ namespace GEE
 		BoundSkeletonBatch(nullptr),
 		CurrentTbCollection(nullptr),
 		SimpleShader(nullptr)
+	{
+	}
+
+	void RenderEngine::Init(Vec2u resolution) 
 	{
 		//configure some openGL settings 
 		glEnable(GL_DEPTH_TEST);
@@ -39,16 +44,16 @@ namespace GEE
 		                                               Texture::Format::RGBA(), 3);
 		EmptyTexture.SetMinFilter(Texture::MinFilter::Nearest(), true, true);
 		EmptyTexture.SetMagFilter(Texture::MagFilter::Nearest(), true);
-	}
 
-	void RenderEngine::Init(Vec2u resolution) 
-	{
 		Resize(resolution);
 
-		LoadInternalShaders();
-		GenerateEngineObjects();
+		{
+			GEE_PROFILE_SCOPE("Render engine startup");
+			LoadInternalShaders();
+			GenerateEngineObjects();
 
-		Postprocessing.Init(GameHandle, Resolution);
+			Postprocessing.Init(GameHandle, Resolution);
+		}
 
 		CubemapData.DefaultV[0] = glm::lookAt(Vec3f(0.0f), Vec3f(1.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f));
 		CubemapData.DefaultV[1] = glm::lookAt(Vec3f(0.0f), Vec3f(-1.0f, 0.0f, 0.0f), Vec3f(0.0f, -1.0f, 0.0f));
@@ -75,11 +80,16 @@ namespace GEE
 		}
 	}
 
+	void RenderEngine::InitHeadless()
+	{
+		GenerateEngineObjects();
+	}
+
 	void RenderEngine::AddSceneRenderDataPtr(GameSceneRenderData& sceneRenderData)
 	{
 		ScenesRenderData.push_back(&sceneRenderData);
 		sceneRenderData.LightBlockBindingSlot = static_cast<int>(ScenesRenderData.size());
-		if (GameHandle->HasStarted() && sceneRenderData.LightProbes.empty() && !sceneRenderData.bIsAnUIScene && GameHandle->GetGameSettings()->Video.Shading == ShadingAlgorithm::SHADING_PBR_COOK_TORRANCE)
+		if (GameHandle->HasStarted() && !GameManager::IsHeadless() && sceneRenderData.LightProbes.empty() && !sceneRenderData.bIsAnUIScene && GameHandle->GetGameSettings()->Video.Shading == ShadingAlgorithm::SHADING_PBR_COOK_TORRANCE)
 		{
 			LightProbeLoader::LoadLightProbeTextureArrays(&sceneRenderData);
 			sceneRenderData.ProbeTexArrays->IrradianceMapArr.Bind(12);
@@ -124,6 +134,11 @@ namespace GEE
 		Shaders.push_back(ShaderLoader::LoadShaders("Depth", "Shaders/depth.vs", "Shaders/depth.fs"));
 		Shaders.back()->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::MVP});
 		Shaders.back()->UniformBlockBinding("BoneMatrices", 10);
+		Shader* depthShader = Shaders.back().get();
+		Shaders.push_back(ShaderLoader::LoadShadersWithInclData("DepthInstanced", "#define INSTANCING\n", "Shaders/depth.vs", "Shaders/depth.fs"));
+		Shaders.back()->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::VP});
+		Shaders.back()->UniformBlockBinding("BoneMatrices", 10);
+		depthShader->SetInstancedVariant(Shaders.back().get());
 		Shaders.push_back(ShaderLoader::LoadShaders("DepthLinearize", "Shaders/depth_linearize.vs", "Shaders/depth_linearize.fs"));
 		Shaders.back()->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::MODEL, MatrixType::MVP});
 		Shaders.back()->UniformBlockBinding("BoneMatrices", 10);
@@ -148,6 +163,8 @@ namespace GEE
 		Shaders.back()->SetOnMaterialWholeDataUpdateFunc([](Shader& shader, const Material& mat) {
 			MaterialUtil::DisableColorIfAlbedoTextureDetected(shader, mat);
 		});
+		// Draws which do not use materials still read the instance block
+		MaterialUtil::BindDefaultInstanceDataBlock();
 
 		AddShader(ShaderLoader::LoadShaders("TextShader", "Shaders/text.vs", "Shaders/text.fs"));
 		Shaders.back()->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::MVP});
@@ -202,6 +219,11 @@ namespace GEE
 		return BoundSkeletonBatch;
 	}
 
+	RenderQueue& RenderEngine::GetMeshInstanceQueue()
+	{
+		return MeshInstanceQueue;
+	}
+
 	Shader* RenderEngine::GetSimpleShader()
 	{
 		return SimpleShader;
@@ -226,7 +248,10 @@ namespace GEE
 	{
 		RenderTbCollections.push_back(std::move(tbCollection));
 		if (setupToolboxesAccordingToSettings)
+		{
+			GEE_PROFILE_SCOPE_STRING("Render toolbox collection setup: " + RenderTbCollections.back()->GetName());
 			RenderTbCollections.back()->AddTbsRequiredBySettings();
+		}
 
 		CurrentTbCollection = RenderTbCollections.back().get();
 
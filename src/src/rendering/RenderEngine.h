@@ -2,6 +2,7 @@
 #include "Postprocess.h"
 #include <rendering/Renderer.h>
 #include "RenderToolbox.h"
+#include <rendering/RenderQueue.h>
 #include <input/Event.h>
 
 namespace GEE
@@ -19,6 +20,10 @@ namespace GEE
 	public:
 		RenderEngine(GameManager*);
 		void Init(Vec2u resolution);
+		/**
+		 * @brief Only loads the basic shape meshes (without uploading them to the GPU), which headless games still use for collision and bounds.
+		*/
+		void InitHeadless();
 
 		virtual const ShadingAlgorithm& GetShadingModel() override;
 		virtual Mesh& GetBasicShapeMesh(EngineBasicShape) override;
@@ -26,6 +31,7 @@ namespace GEE
 		virtual RenderToolboxCollection* GetCurrentTbCollection() override;
 		virtual Texture GetEmptyTexture() override;
 		virtual SkeletonBatch* GetBoundSkeletonBatch() override;
+		virtual RenderQueue& GetMeshInstanceQueue() override;
 		virtual Shader* GetSimpleShader() override;
 
 		virtual std::vector<Shader*> GetCustomShaders() override;
@@ -84,6 +90,7 @@ namespace GEE
 		Texture EmptyTexture;
 
 		SkeletonBatch* BoundSkeletonBatch;
+		RenderQueue MeshInstanceQueue;
 
 		std::deque <UniquePtr <RenderToolboxCollection>> RenderTbCollections;
 		RenderToolboxCollection* CurrentTbCollection;
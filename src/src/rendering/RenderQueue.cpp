@@ -0,0 +1,341 @@
+#include <rendering/RenderQueue.h>
+#include <rendering/Renderer.h>
+#include <rendering/Material.h>
+#include <scene/RenderableComponent.h>
+#include <cstddef>
+#include <cstring>
+
+namespace GEE
+{
+	RenderQueue::RenderQueue() :
+		Mode(SortMode::StateFirst),
+		bAllowInstancing(false),
+		InstanceVBO(0)
+	{
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+		if (InstanceVBO)
+			glDeleteBuffers(1, &InstanceVBO);
+	}
+
+	void RenderQueue::Clear(SortMode mode, bool allowInstancing)
+	{
+		Items.clear();
+		Entries.clear();
+		Mode = mode;
+		bAllowInstancing = allowInstancing;
+	}
+
+	RenderQueue::SortMode RenderQueue::GetSortModeForPass(const MatrixInfoExt& info)
+	{
+		// Shaded (deferred geometry) passes, shadow passes and passes without blending only need correct depth testing, so we can order them by state.
+		if (info.GetOnlyShadowCasters() || !info.GetAllowBlending() || info.GetRequiredShaderInfo().GetShaderHint() == MaterialShaderHint::Shaded)
+			return SortMode::StateFirst;
+
+		return SortMode::BackToFront;
+	}
+
+	bool RenderQueue::PassesFilter(const MatrixInfoExt& info, const MeshInstance& meshInst)
+	{
+		const Material* material = meshInst.GetMaterialPtr().get();
+		MaterialInstance* materialInst = meshInst.GetMaterialInst();
+
+		return !((material && !material->GetShaderInfo().MatchesRequiredInfo(info.GetRequiredShaderInfo())) ||
+			(info.GetOnlyShadowCasters() && !meshInst.GetMesh().CanCastShadow()) ||
+			(materialInst && !materialInst->ShouldBeDrawn()));
+	}
+
+	void RenderQueue::AddMeshInstance(const MatrixInfoExt& info, Shader& shader, const MeshInstance& meshInst, const Mat4f& modelMat, const void* transformOwner, const Mat4f* prevModelMat)
+	{
+		const Mesh& mesh = meshInst.GetMesh();
+		float viewDepth = GetViewDepth(info, Vec3f(modelMat * Vec4f(mesh.GetBoundingBox().Position, 1.0f)));
+		const Material* material = (meshInst.GetMaterialInst()) ? (&meshInst.GetMaterialInst()->GetMaterialRef()) : (nullptr);
+
+		Entries.push_back(SortEntry{ MakeKey(&shader, material, &mesh, viewDepth), static_cast<unsigned int>(Items.size()) });
+		Items.push_back(DrawItem{ &meshInst, nullptr, transformOwner, modelMat, (prevModelMat) ? (*prevModelMat) : (modelMat) });
+	}
+
+	void RenderQueue::AddRenderable(Shader& shader, Renderable& renderable, float viewDepth)
+	{
+		// Renderables can bind anything, so we give them the state bits of an invalid material and mesh; they will be grouped together.
+		Entries.push_back(SortEntry{ MakeKey(&shader, nullptr, nullptr, viewDepth), static_cast<unsigned int>(Items.size()) });
+		Items.push_back(DrawItem{ nullptr, &renderable, nullptr, Mat4f(1.0f), Mat4f(1.0f) });
+	}
+
+	void RenderQueue::Sort()
+	{
+		if (Entries.size() < 2)
+			return;
+
+		EntriesScratch.resize(Entries.size());
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			unsigned int offsets[256] = { 0 };
+			for (const SortEntry& entry : Entries)
+				offsets[(entry.Key >> shift) & 0xFF]++;
+
+			if (offsets[(Entries.front().Key >> shift) & 0xFF] == Entries.size())	// All keys share this digit; the pass would not change the order
+				continue;
+
+			unsigned int offset = 0;
+			for (unsigned int& digitOffset : offsets)
+			{
+				unsigned int count = digitOffset;
+				digitOffset = offset;
+				offset += count;
+			}
+
+			for (const SortEntry& entry : Entries)
+				EntriesScratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+
+			std::swap(Entries, EntriesScratch);
+		}
+	}
+
+	void RenderQueue::Submit(const SceneMatrixInfo& info, Shader& shader)
+	{
+		SubmitImpl(info, shader, &info);
+	}
+
+	void RenderQueue::Submit(const MatrixInfoExt& info, Shader& shader)
+	{
+		SubmitImpl(info, shader, nullptr);
+	}
+
+	unsigned int RenderQueue::GetDrawCount() const
+	{
+		return static_cast<unsigned int>(Items.size());
+	}
+
+	unsigned int RenderQueue::GetInstancedGroupCount() const
+	{
+		return static_cast<unsigned int>(InstancedGroups.size());
+	}
+
+	bool RenderQueue::IsEmpty() const
+	{
+		return Items.empty();
+	}
+
+	float RenderQueue::GetViewDepth(const MatrixInfo& info, const Vec3f& worldPosition)
+	{
+		return -(info.GetView() * Vec4f(worldPosition, 1.0f)).z;
+	}
+
+	std::uint64_t RenderQueue::MakeKey(const Shader* shader, const Material* material, const Mesh* mesh, float viewDepth) const
+	{
+		// Pointers are folded into a few bits. A collision only means that two different states may interleave - Submit() compares the actual pointers before binding anything.
+		auto foldPointer = [](const void* ptr, unsigned int bits) -> std::uint64_t
+		{
+			if (!ptr)
+				return 0;
+			std::uint64_t value = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr));
+			value ^= value >> 33;
+			value *= 0xff51afd7ed558ccdULL;
+			value ^= value >> 33;
+			return (value & ((std::uint64_t(1) << bits) - 1)) | 1;	// never 0, which is reserved for null pointers
+		};
+
+		// Bit patterns of non-negative floats are ordered like the floats themselves; we keep the 24 most significant bits.
+		viewDepth = std::max(viewDepth, 0.0f);
+		std::uint32_t depthBits;
+		std::memcpy(&depthBits, &viewDepth, sizeof(depthBits));
+		std::uint64_t depth = depthBits >> 8;
+
+		std::uint64_t shaderBits = foldPointer(shader, 8), materialBits = foldPointer(material, 16), meshBits = foldPointer(mesh, 16);
+
+		switch (Mode)
+		{
+		case SortMode::BackToFront:	// [shader 8][inverted depth 24][material 16][mesh 16]
+			return (shaderBits << 56) | ((~depth & 0xFFFFFF) << 32) | (materialBits << 16) | meshBits;
+		case SortMode::StateFirst:
+		default:					// [shader 8][material 16][mesh 16][depth 24]
+			return (shaderBits << 56) | (materialBits << 40) | (meshBits << 24) | depth;
+		}
+	}
+
+	bool RenderQueue::CanBeInstanced(const DrawItem& item)
+	{
+		// Animated material instances have their own per-instance uniforms, so they have to be drawn one by one
+		return item.MeshInst && (!item.MeshInst->GetMaterialInst() || !item.MeshInst->GetMaterialInst()->IsAnimated());
+	}
+
+	bool RenderQueue::CanShareInstancedDraw(const DrawItem& first, const DrawItem& item)
+	{
+		if (!CanBeInstanced(item) || &first.MeshInst->GetMesh() != &item.MeshInst->GetMesh())
+			return false;
+
+		const MaterialInstance* firstMatInst = first.MeshInst->GetMaterialInst(), *matInst = item.MeshInst->GetMaterialInst();
+		return ((firstMatInst) ? (&firstMatInst->GetMaterialRef()) : (nullptr)) == ((matInst) ? (&matInst->GetMaterialRef()) : (nullptr));
+	}
+
+	void RenderQueue::PrepareInstancedGroups(const Shader& shader)
+	{
+		InstancedGroups.clear();
+		InstanceBufferData.clear();
+
+		// Sorting back to front interleaves meshes and materials, so there is nothing to merge
+		if (!bAllowInstancing || Mode != SortMode::StateFirst || !shader.GetInstancedVariant())
+			return;
+
+		const unsigned int entryCount = static_cast<unsigned int>(Entries.size());
+		for (unsigned int first = 0; first < entryCount;)
+		{
+			const DrawItem& firstItem = Items[Entries[first].ItemIndex];
+			unsigned int last = first + 1;
+			if (CanBeInstanced(firstItem))
+				while (last < entryCount && CanShareInstancedDraw(firstItem, Items[Entries[last].ItemIndex]))
+					last++;
+
+			if (last - first >= MinInstancedGroupSize)
+			{
+				InstancedGroups.push_back(InstancedGroup{ first, last - first, static_cast<unsigned int>(InstanceBufferData.size()) });
+				for (unsigned int i = first; i < last; i++)
+				{
+					const DrawItem& item = Items[Entries[i].ItemIndex];
+					InstanceBufferData.push_back(InstanceData{ item.ModelMatrix, item.PrevModelMatrix });
+				}
+			}
+
+			first = last;
+		}
+
+		if (InstanceBufferData.empty())
+			return;
+
+		if (!InstanceVBO)
+			glGenBuffers(1, &InstanceVBO);
+
+		// Respecify the whole buffer every pass; the driver can orphan the old storage instead of waiting for previous draws
+		GLint previousArrayBuffer = 0;
+		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * InstanceBufferData.size(), InstanceBufferData.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
+	}
+
+	void RenderQueue::SubmitInstancedGroup(const MatrixInfoExt& info, Shader& instancedShader, const InstancedGroup& group)
+	{
+		const DrawItem& firstItem = Items[Entries[group.FirstEntry].ItemIndex];
+		const Mesh& mesh = firstItem.MeshInst->GetMesh();
+		MaterialInstance* materialInst = firstItem.MeshInst->GetMaterialInst();
+
+		instancedShader.Use();
+		instancedShader.BindMatrices(Mat4f(1.0f), &info.GetView(), &info.GetProjection(), &info.GetVP());
+		instancedShader.CallPreRenderFunc();
+
+		if (info.GetUseMaterials() && materialInst)
+		{
+			materialInst->UpdateWholeUBOData(&instancedShader, Texture());
+			BindingsGL::BoundMaterial = &materialInst->GetMaterialRef();
+		}
+
+		mesh.Bind(info.GetContextID());
+		BindingsGL::BoundMesh = &mesh;
+
+		// The VAO captures the buffer of each attribute when its pointer is set, so the previous binding can be restored right after
+		GLint previousArrayBuffer = 0;
+		glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousArrayBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+		for (unsigned int column = 0; column < 4; column++)
+		{
+			const std::size_t columnOffset = sizeof(InstanceData) * group.FirstInstance + sizeof(Vec4f) * column;
+			glVertexAttribPointer(InstanceMatrixAttribLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(columnOffset + offsetof(InstanceData, ModelMatrix)));
+			glVertexAttribPointer(InstancePrevMatrixAttribLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(columnOffset + offsetof(InstanceData, PrevModelMatrix)));
+			for (unsigned int location : { InstanceMatrixAttribLocation + column, InstancePrevMatrixAttribLocation + column })
+			{
+				glVertexAttribDivisor(location, 1);
+				glEnableVertexAttribArray(location);
+			}
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(previousArrayBuffer));
+
+		mesh.RenderInstanced(group.Count);
+
+		// The attributes are a part of the mesh VAO state; disable them so regular draws of this mesh do not read the instance buffer
+		for (unsigned int column = 0; column < 4; column++)
+		{
+			glDisableVertexAttribArray(InstanceMatrixAttribLocation + column);
+			glDisableVertexAttribArray(InstancePrevMatrixAttribLocation + column);
+		}
+	}
+
+	void RenderQueue::SubmitImpl(const MatrixInfoExt& info, Shader& shader, const SceneMatrixInfo* sceneInfo)
+	{
+		const void* boundTransformOwner = nullptr;
+		const Mesh* boundMesh = nullptr;
+		const Material* boundMaterial = nullptr;
+		bool bMatricesBound = false;
+
+		PrepareInstancedGroups(shader);
+		unsigned int nextGroup = 0;
+
+		for (unsigned int entryIndex = 0; entryIndex < static_cast<unsigned int>(Entries.size()); entryIndex++)
+		{
+			if (nextGroup < InstancedGroups.size() && InstancedGroups[nextGroup].FirstEntry == entryIndex)
+			{
+				const InstancedGroup& group = InstancedGroups[nextGroup++];
+				SubmitInstancedGroup(info, *shader.GetInstancedVariant(), group);
+				shader.Use();
+
+				// Textures of the group's material are bound now; the uniforms of this shader were not touched
+				bMatricesBound = false;
+				boundMaterial = nullptr;
+				boundMesh = &Items[Entries[entryIndex].ItemIndex].MeshInst->GetMesh();
+
+				entryIndex += group.Count - 1;
+				continue;
+			}
+
+			const DrawItem& item = Items[Entries[entryIndex].ItemIndex];
+
+			if (item.RenderableObj)
+			{
+				GEE_CORE_ASSERT(sceneInfo);
+				item.RenderableObj->Render(*sceneInfo, &shader);
+
+				// The Renderable could have changed any binding
+				bMatricesBound = false;
+				boundMesh = nullptr;
+				boundMaterial = nullptr;
+				continue;
+			}
+
+			const Mesh& mesh = item.MeshInst->GetMesh();
+			MaterialInstance* materialInst = item.MeshInst->GetMaterialInst();
+
+			if (!bMatricesBound || item.TransformOwner != boundTransformOwner)
+			{
+				shader.BindMatrices(item.ModelMatrix, &info.GetView(), &info.GetProjection(), &info.GetVP());
+				shader.CallPreRenderFunc();	// Call user-defined pre render function
+				boundTransformOwner = item.TransformOwner;
+				bMatricesBound = true;
+			}
+
+			if (info.GetUseMaterials() && materialInst)
+			{
+				const Material* material = &materialInst->GetMaterialRef();
+				if (material != boundMaterial)
+				{
+					materialInst->UpdateWholeUBOData(&shader, Texture());
+					boundMaterial = material;
+				}
+				else	// Same material as in the previous draw; only per-instance data (e.g. animated atlas index) can differ
+					materialInst->UpdateInstanceUBOData(&shader);
+
+				BindingsGL::BoundMaterial = material;
+			}
+
+			if (&mesh != boundMesh)
+			{
+				mesh.Bind(info.GetContextID());
+				boundMesh = &mesh;
+				BindingsGL::BoundMesh = &mesh;
+			}
+
+			mesh.Render();
+		}
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <rendering/RenderInfo.h>
+#include <rendering/Mesh.h>
+#include <cstdint>
+
+namespace GEE
+{
+	class Renderable;
+
+	/**
+	 * @brief Collects the draw calls of a single pass, sorts them by 64-bit keys and submits them with as few state changes as possible.
+	 * Opaque passes are ordered by shader, material, mesh and then front-to-back depth, so consecutive draws share their bindings.
+	 * Passes with blending are ordered by shader and then back-to-front depth, so transparent surfaces compose correctly.
+	 * Renderables which cannot be expressed as a list of mesh draws (texts, skinned meshes, UI canvas elements) are queued as a whole and rendered through Renderable::Render() at their sorted position.
+	 * If instancing is allowed and the shader has an instanced variant, consecutive draws of the same mesh with the same (non-animated) material are merged into a single instanced draw call.
+	*/
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		RenderQueue(const RenderQueue&) = delete;
+		RenderQueue& operator=(const RenderQueue&) = delete;
+		~RenderQueue();
+
+		enum class SortMode
+		{
+			StateFirst,
+			BackToFront
+		};
+
+		/**
+		 * @brief Removes all queued draws. The allocated memory is kept, so the queue can be reused every frame without reallocating.
+		 * @param allowInstancing: whether draws of the same mesh and material can be merged into instanced draw calls. Requires a valid OpenGL context for the lifetime of the queue, since an instance buffer is created.
+		*/
+		void Clear(SortMode = SortMode::StateFirst, bool allowInstancing = false);
+		/**
+		 * @return the SortMode suitable for the pass described by info (BackToFront if the pass may blend, StateFirst otherwise).
+		*/
+		static SortMode GetSortModeForPass(const MatrixInfoExt& info);
+
+		/**
+		 * @return a boolean indicating whether the MeshInstance should be drawn in the pass described by info (matches the required shader, casts shadows if only shadow casters are rendered, is not hidden by its material animation).
+		*/
+		static bool PassesFilter(const MatrixInfoExt& info, const MeshInstance&);
+
+		/**
+		 * @brief Queues a draw of the MeshInstance. Does not check if the MeshInstance passes the filter - call PassesFilter() before.
+		 * @param modelMat: the final model matrix of the draw.
+		 * @param transformOwner: an object identifying the model matrix (usually the owning component). Matrices are bound again only if it differs between consecutive draws.
+		 * @param prevModelMat: the model matrix of the draw in the previous frame, uploaded with instanced draws for the velocity buffer. nullptr if it is the same as modelMat.
+		*/
+		void AddMeshInstance(const MatrixInfoExt& info, Shader& shader, const MeshInstance&, const Mat4f& modelMat, const void* transformOwner, const Mat4f* prevModelMat = nullptr);
+		/**
+		 * @brief Queues a Renderable that will be rendered by calling its Render() method.
+		 * @param viewDepth: the depth used for sorting (distance along the view direction).
+		*/
+		void AddRenderable(Shader& shader, Renderable&, float viewDepth);
+
+		/**
+		 * @brief Sorts all queued draws by their keys (LSD radix sort).
+		*/
+		void Sort();
+
+		/**
+		 * @brief Renders all queued draws in the sorted order. The passed shader must be in use.
+		 * The SceneMatrixInfo overload is required if any Renderables were queued.
+		*/
+		void Submit(const SceneMatrixInfo& info, Shader& shader);
+		void Submit(const MatrixInfoExt& info, Shader& shader);
+
+		unsigned int GetDrawCount() const;
+		/**
+		 * @return the number of instanced draw calls issued by the last Submit() call.
+		*/
+		unsigned int GetInstancedGroupCount() const;
+		bool IsEmpty() const;
+
+		static float GetViewDepth(const MatrixInfo& info, const Vec3f& worldPosition);
+
+	private:
+		struct DrawItem
+		{
+			const MeshInstance* MeshInst;
+			Renderable* RenderableObj;	// set only for draws that are rendered as a whole
+			const void* TransformOwner;
+			Mat4f ModelMatrix;
+			Mat4f PrevModelMatrix;
+		};
+		struct SortEntry
+		{
+			std::uint64_t Key;
+			unsigned int ItemIndex;
+		};
+		struct InstancedGroup
+		{
+			unsigned int FirstEntry;
+			unsigned int Count;
+			unsigned int FirstInstance;	// index of the first element of InstanceBufferData
+		};
+		/**
+		 * @brief The per-instance data of instanced draws, as it is laid out in the instance buffer.
+		*/
+		struct InstanceData
+		{
+			Mat4f ModelMatrix;
+			Mat4f PrevModelMatrix;
+		};
+
+		std::uint64_t MakeKey(const Shader*, const Material*, const Mesh*, float viewDepth) const;
+		static bool CanBeInstanced(const DrawItem&);
+		static bool CanShareInstancedDraw(const DrawItem&, const DrawItem&);
+		/**
+		 * @brief Finds runs of sorted draws which can be merged into instanced draw calls and uploads their current and previous model matrices to the instance buffer.
+		*/
+		void PrepareInstancedGroups(const Shader& shader);
+		void SubmitInstancedGroup(const MatrixInfoExt& info, Shader& instancedShader, const InstancedGroup&);
+		void SubmitImpl(const MatrixInfoExt& info, Shader& shader, const SceneMatrixInfo* sceneInfo);
+
+		static constexpr unsigned int MinInstancedGroupSize = 2;
+		static constexpr unsigned int InstanceMatrixAttribLocation = 7;	// a mat4 attribute occupies 4 consecutive locations
+		static constexpr unsigned int InstancePrevMatrixAttribLocation = 11;
+
+		std::vector<DrawItem> Items;
+		std::vector<SortEntry> Entries, EntriesScratch;
+		SortMode Mode;
+		bool bAllowInstancing;
+
+		std::vector<InstancedGroup> InstancedGroups;
+		std::vector<InstanceData> InstanceBufferData;
+		unsigned int InstanceVBO;
+	};
+}
@@ -140,9 +140,7 @@ namespace GEE
 
 			Shaders.back()->SetTextureUnitNames(gShaderTextureUnits);
 			Shaders.back()->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::MODEL, MatrixType::MVP, MatrixType::NORMAL});
-			Shaders.back()->SetOnMaterialWholeDataUpdateFunc([](Shader& shader, const Material& mat) {
-				MaterialUtil::DisableColorIfAlbedoTextureDetected(shader, mat);
-				});
+			// disableColor is a part of the MaterialData block, so there is no need to set it for every draw.
 
 			LightShaders.push_back(Shaders.back().get());
 		}
@@ -151,7 +149,8 @@ namespace GEE
 	DeferredShadingToolbox::DeferredShadingToolbox(ShaderFromHintGetter& getter, const GameSettings::VideoSettings& settings) :
 		RenderToolbox(getter),
 		GFb(nullptr),
-		GeometryShader(nullptr)
+		GeometryShader(nullptr),
+		IBLShader(nullptr)
 	{
 		Setup(settings);
 	}
@@ -244,14 +243,32 @@ namespace GEE
 			LightShaders.push_back(Shaders.back().get());
 		}
 
+		IBLShader = FindShader("CookTorranceIBL");
+		LightProbeHandles.clear();
+		if (IBLShader)
+			for (unsigned int i = 0; ; i++)	// resolve the handles of every element of the array which is active in the program
+			{
+				const std::string probeName = "lightProbes[" + std::to_string(i) + "]";
+				LightProbeUniformHandles handles{ IBLShader->GetHandle<float>(probeName + ".intensity"), IBLShader->GetHandle<Vec3f>(probeName + ".position") };
+				if (!handles.Intensity.IsValid() && !handles.Position.IsValid())
+					break;
+				LightProbeHandles.push_back(handles);
+			}
+
 		GeometryShader = AddShader(ShaderLoader::LoadShadersWithInclData("Geometry", settingsDefines, "Shaders/geometry.vs", "Shaders/geometry.fs"));
 		GeometryShader->UniformBlockBinding("BoneMatrices", 10);
 		GeometryShader->UniformBlockBinding("PreviousBoneMatrices", 11);
 		GeometryShader->SetTextureUnitNames(gShaderTextureUnits);
 		GeometryShader->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::MODEL, MatrixType::MVP, MatrixType::NORMAL});
-		GeometryShader->SetOnMaterialWholeDataUpdateFunc([](Shader& shader, const Material& mat) {
-			MaterialUtil::DisableColorIfAlbedoTextureDetected(shader, mat);
-		});
+
+		Shader* instancedGeometryShader = AddShader(ShaderLoader::LoadShadersWithInclData("GeometryInstanced", settingsDefines + "#define INSTANCING\n", "Shaders/geometry.vs", "Shaders/geometry.fs"));
+		instancedGeometryShader->UniformBlockBinding("BoneMatrices", 10);
+		instancedGeometryShader->UniformBlockBinding("PreviousBoneMatrices", 11);
+		instancedGeometryShader->SetTextureUnitNames(gShaderTextureUnits);
+		instancedGeometryShader->SetExpectedMatrices(std::vector<MatrixType>{MatrixType::VP});
+		GeometryShader->SetInstancedVariant(instancedGeometryShader);
+		GeometryCamPosHandle = GeometryShader->GetHandle<Vec3f>("camPos");
+		InstancedGeometryCamPosHandle = instancedGeometryShader->GetHandle<Vec3f>("camPos");
 
 		SetShaderHint(MaterialShaderHint::Shaded, GeometryShader);
 	}
@@ -314,6 +331,8 @@ namespace GEE
 		SSAOShader = Shaders.back().get();
 
 		SSAOShader->SetExpectedMatrices(std::vector<MatrixType> {MatrixType::VIEW, MatrixType::PROJECTION});
+		SSAOViewHandle = SSAOShader->GetHandle<Mat4f>("view");
+		SSAOProjectionHandle = SSAOShader->GetHandle<Mat4f>("projection");
 		SSAOShader->Use();
 		SSAOShader->Uniform<float>("radius", 0.5f);
 		SSAOShader->Uniform<int>("gPosition", 0);
@@ -429,7 +448,8 @@ namespace GEE
 		SMAAShaders[1]->Uniform<int>("edgesTex", 0);
 		SMAAShaders[1]->Uniform<int>("areaTex", 1);
 		SMAAShaders[1]->Uniform<int>("searchTex", 2);
-		SMAAShaders[1]->Uniform<Vec4f>("ssIndices", Vec4f(0.0f));
+		SSIndicesHandle = SMAAShaders[1]->GetHandle<Vec4f>("ssIndices");
+		SSIndicesHandle.Set(Vec4f(0.0f));
 
 		SMAAShaders[2]->Use();
 		SMAAShaders[2]->Uniform<int>("colorTex", 0);
@@ -498,6 +518,7 @@ namespace GEE
 		GaussianBlurShader = AddShader(ShaderLoader::LoadShaders("GaussianBlur", "Shaders/gaussianblur.vs", "Shaders/gaussianblur.fs"));
 		GaussianBlurShader->Use();
 		GaussianBlurShader->Uniform<int>("tex", 0);
+		HorizontalHandle = GaussianBlurShader->GetHandle<int>("horizontal");
 	}
 
 	ShadowMappingToolbox::ShadowMappingToolbox(ShaderFromHintGetter& getter, const GameSettings::VideoSettings& settings) :
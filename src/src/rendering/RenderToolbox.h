@@ -2,6 +2,7 @@
 #include <game/GameManager.h>
 #include <game/GameSettings.h>
 #include "Framebuffer.h"
+#include <rendering/Shader.h>
 #include <map>
 
 namespace GEE
@@ -62,6 +63,15 @@ namespace GEE
 	class DeferredShadingToolbox : public RenderToolbox
 	{
 	public:
+		/**
+		 * @brief Handles of the uniforms of one element of the "lightProbes" array of the IBL shader.
+		*/
+		struct LightProbeUniformHandles
+		{
+			UniformHandle<float> Intensity;
+			UniformHandle<Vec3f> Position;
+		};
+
 		DeferredShadingToolbox(ShaderFromHintGetter&, const GameSettings::VideoSettings& settings);
 		void Setup(const GameSettings::VideoSettings& settings);
 
@@ -76,6 +86,11 @@ namespace GEE
 
 		std::vector<Shader*> LightShaders;
 		Shader* GeometryShader;
+
+		// Resolved once in Setup(), because these are set every frame.
+		UniformHandle<Vec3f> GeometryCamPosHandle, InstancedGeometryCamPosHandle;
+		Shader* IBLShader;	// nullptr if the shading algorithm has no IBL pass
+		std::vector<LightProbeUniformHandles> LightProbeHandles;	// indexed by the position of the probe in the "lightProbes" array of IBLShader
 	};
 
 	class MainFramebufferToolbox : public RenderToolbox
@@ -102,6 +117,7 @@ namespace GEE
 		GEE_FB::Framebuffer* SSAOFb;
 
 		Shader* SSAOShader;
+		UniformHandle<Mat4f> SSAOViewHandle, SSAOProjectionHandle;
 
 		Texture* SSAONoiseTex;
 	};
@@ -130,6 +146,7 @@ namespace GEE
 		GEE_FB::Framebuffer* SMAAFb; //three color buffers; we use the first two color buffers as edgeTex&blendTex in SMAA pass and optionally the last one to store the neighborhood blend result for reprojection
 
 		Shader* SMAAShaders[4];
+		UniformHandle<Vec4f> SSIndicesHandle;	// of the blending weight shader
 
 		Texture* SMAAAreaTex, * SMAASearchTex;
 	};
@@ -162,6 +179,7 @@ namespace GEE
 											//Side note 2: I've heard that they are similar in terms of performance. So now I wonder why do we use ping-pong framebuffers and not ping-pong color buffers. They should work the same, shouldn't they?
 
 		Shader* GaussianBlurShader;
+		UniformHandle<int> HorizontalHandle;
 	};
 
 	class ShadowMappingToolbox : public RenderToolbox
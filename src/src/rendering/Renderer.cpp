@@ -11,6 +11,9 @@
 #include <scene/TextComponent.h>
 #include <editor/EditorManager.h>
 #include <physics/CollisionObject.h>
+#include <math/Frustum.h>
+#include <rendering/RenderQueue.h>
+#include <rendering/GpuProfiler.h>
 
 namespace GEE
 {
@@ -38,47 +41,35 @@ namespace GEE
 	{
 	}
 
-	void Renderer::StaticMeshInstances(const MatrixInfoExt& info, const std::vector<MeshInstance>& meshes, const Transform& transform, Shader& shader, bool billboard)
+	template <typename MeshInstanceSpan>
+	void Renderer::StaticMeshInstancesImpl(const MatrixInfoExt& info, MeshInstanceSpan meshes, const Transform& transform, Shader& shader, bool billboard)
 	{
 		if (meshes.empty())
 			return;
 
-		bool handledShader = false;
-		for (const MeshInstance& meshInst : meshes)
-		{
-			const Mesh& mesh = meshInst.GetMesh();
-			MaterialInstance* materialInst = meshInst.GetMaterialInst();
-			const Material* material = meshInst.GetMaterialPtr().get();
+		RenderQueue& queue = Impl.RenderHandle.GetMeshInstanceQueue();
+		queue.Clear(RenderQueue::GetSortModeForPass(info));
 
-			if ((material && !material->GetShaderInfo().MatchesRequiredInfo(info.GetRequiredShaderInfo())) ||
-				(info.GetOnlyShadowCasters() && !mesh.CanCastShadow()) || 
-				(materialInst && !materialInst->ShouldBeDrawn()))
-				continue;
-
-			if (!handledShader)
-			{
-				handledShader = true;
+		Mat4f modelMat = transform.GetWorldTransformMatrix();	//the ComponentTransform's world transform is cached
+		if (billboard)
+			modelMat = modelMat * Mat4f(glm::inverse(transform.GetWorldTransform().GetRotationMatrix()) * glm::inverse(Mat3f(info.GetView())));
 
-				Mat4f modelMat = transform.GetWorldTransformMatrix();	//the ComponentTransform's world transform is cached
-				if (billboard)
-					modelMat = modelMat * Mat4f(glm::inverse(transform.GetWorldTransform().GetRotationMatrix()) * glm::inverse(Mat3f(info.GetView())));
-
-
-				shader.BindMatrices(modelMat, &info.GetView(), &info.GetProjection(), &info.GetVP());
-				shader.CallPreRenderFunc();	// Call user-defined pre render function
-			}
+		for (const MeshInstance& meshInst : meshes)
+			if (RenderQueue::PassesFilter(info, meshInst))
+				queue.AddMeshInstance(info, shader, meshInst, modelMat, &transform);
 
-			////////////////////////////////////////Impl.BindMesh(&mesh);
-			////////////////////////////////////////Impl::MeshBind->Set(&mesh);
+		queue.Sort();
+		queue.Submit(info, shader);
+	}
 
-			if (info.GetUseMaterials() && materialInst)
-			{
-				materialInst->UpdateWholeUBOData(&shader, Texture());//////////////////////////////////////// Impl::BindMaterialInstance(materialInst);
-			}
+	void Renderer::StaticMeshInstances(const MatrixInfoExt& info, Span<const MeshInstance> meshes, const Transform& transform, Shader& shader, bool billboard)
+	{
+		StaticMeshInstancesImpl(info, meshes, transform, shader, billboard);
+	}
 
-			mesh.Bind(info.GetContextID());
-			mesh.Render();
-		}
+	void Renderer::StaticMeshInstances(const MatrixInfoExt& info, IndirectSpan<const MeshInstance, UniquePtr<MeshInstance>> meshes, const Transform& transform, Shader& shader, bool billboard)
+	{
+		StaticMeshInstancesImpl(info, meshes, transform, shader, billboard);
 	}
 
 	Mat4f Renderer::ImplUtil::GetCubemapView(GEE_FB::Axis cubemapSide)
@@ -286,6 +277,7 @@ namespace GEE
 
 	void ShadowMapRenderer::ShadowMaps(RenderingContextID contextID, RenderToolboxCollection& tbCollection, GameSceneRenderData& sceneRenderData, std::vector<std::reference_wrapper<LightComponent>> lights)
 	{
+		GEE_PROFILE_RENDER_PASS("Shadow maps pass");
 		ShadowMappingToolbox* shadowsTb = tbCollection.GetTb<ShadowMappingToolbox>();
 		shadowsTb->ShadowFramebuffer->Bind();
 		bool dynamicShadowRender = tbCollection.GetVideoSettings().ShadowLevel > SettingLevel::SETTING_MEDIUM;
@@ -304,6 +296,17 @@ namespace GEE
 
 		Impl.RenderHandle.BindSkeletonBatch(&sceneRenderData, static_cast<unsigned int>(0));
 
+		// Look the shaders and their uniforms up once, not for every light
+		Shader& depthShader = Impl.GetShader(RendererShaderHint::DepthOnly);
+		Shader& linearizedDepthShader = Impl.GetShader(RendererShaderHint::DepthOnlyLinearized);
+		Shader* instancedDepthShader = depthShader.GetInstancedVariant();
+
+		const UniformHandle<float> depthBiasHandle = depthShader.GetHandle<float>("lightBias");
+		const UniformHandle<float> instancedDepthBiasHandle = (instancedDepthShader) ? (instancedDepthShader->GetHandle<float>("lightBias")) : (UniformHandle<float>());
+		const UniformHandle<float> linearizedFarHandle = linearizedDepthShader.GetHandle<float>("far");
+		const UniformHandle<float> linearizedBiasHandle = linearizedDepthShader.GetHandle<float>("lightBias");
+		const UniformHandle<Vec3f> linearizedLightPosHandle = linearizedDepthShader.GetHandle<Vec3f>("lightPos");
+
 		for (int i = 0; i < static_cast<int>(lights.size()); i++)
 		{
 			LightComponent& light = lights[i].get();
@@ -326,7 +329,7 @@ namespace GEE
 			{
 				if (!bCubemapBound)
 				{
-					Impl.GetShader(RendererShaderHint::DepthOnlyLinearized).Use();
+					linearizedDepthShader.Use();
 					bCubemapBound = true;
 				}
 
@@ -335,9 +338,9 @@ namespace GEE
 				Mat4f viewTranslation = glm::translate(Mat4f(1.0f), -lightPos);
 				Mat4f projection = light.GetProjection();
 
-				Impl.GetShader(RendererShaderHint::DepthOnlyLinearized).Uniform<float>("far", light.GetFar());
-				Impl.GetShader(RendererShaderHint::DepthOnlyLinearized).Uniform<float>("lightBias", light.GetShadowBias());
-				Impl.GetShader(RendererShaderHint::DepthOnlyLinearized).Uniform<Vec3f>("lightPos", lightPos);
+				linearizedFarHandle.Set(light.GetFar());
+				linearizedBiasHandle.Set(light.GetShadowBias());
+				linearizedLightPosHandle.Set(lightPos);
 
 				int cubemapFirst = light.GetShadowMapNr() * 6;
 
@@ -348,13 +351,13 @@ namespace GEE
 				info.StopRequiringShaderInfo();
 				shadowsTb->ShadowFramebuffer->Attachments.push_back(GEE_FB::FramebufferAttachment(*shadowsTb->ShadowCubemapArray, GEE_FB::AttachmentSlot::Depth()));
 
-				CubemapRenderer(Impl.RenderHandle, shadowsTb->ShadowFramebuffer).FromScene(info, *shadowsTb->ShadowFramebuffer, shadowsTb->ShadowFramebuffer->GetAnyDepthAttachment(), &Impl.GetShader(RendererShaderHint::DepthOnlyLinearized), &cubemapFirst);
+				CubemapRenderer(Impl.RenderHandle, shadowsTb->ShadowFramebuffer).FromScene(info, *shadowsTb->ShadowFramebuffer, shadowsTb->ShadowFramebuffer->GetAnyDepthAttachment(), &linearizedDepthShader, &cubemapFirst);
 			}
 			else
 			{
 				if (bCubemapBound || i == 0)
 				{
-					Impl.GetShader(RendererShaderHint::DepthOnly).Use();
+					depthShader.Use();
 					bCubemapBound = false;
 				}
 
@@ -362,7 +365,13 @@ namespace GEE
 				Mat4f projection = light.GetProjection();
 				Mat4f VP = projection * view;
 
-				Impl.GetShader(RendererShaderHint::DepthOnly).Uniform<float>("lightBias", light.GetShadowBias());
+				if (instancedDepthShader)
+				{
+					instancedDepthShader->Use();
+					instancedDepthBiasHandle.Set(light.GetShadowBias());
+					depthShader.Use();
+				}
+				depthBiasHandle.Set(light.GetShadowBias());
 
 				shadowsTb->ShadowFramebuffer->Attach(GEE_FB::FramebufferAttachment(*shadowsTb->ShadowMapArray, light.GetShadowMapNr(), GEE_FB::AttachmentSlot::Depth()), false, false);
 				glClear(GL_DEPTH_BUFFER_BIT);
@@ -371,7 +380,7 @@ namespace GEE
 				info.CalculateVP();
 				info.SetUseMaterials(false);
 				info.SetOnlyShadowCasters(true);
-				SceneRenderer(Impl.RenderHandle, shadowsTb->ShadowFramebuffer).RawRender(info, Impl.GetShader(RendererShaderHint::DepthOnly));
+				SceneRenderer(Impl.RenderHandle, shadowsTb->ShadowFramebuffer).RawRender(info, depthShader);
 
 				shadowsTb->ShadowFramebuffer->Detach(GEE_FB::AttachmentSlot::Depth());
 			}
@@ -409,6 +418,7 @@ namespace GEE
 
 	void SceneRenderer::FullRender(SceneMatrixInfo& info, Viewport viewport, bool clearMainFB, bool modifyForwardsDepthForUI, std::function<void(GEE_FB::Framebuffer&)>&& renderIconsFunc)
 	{
+		GEE_PROFILE_RENDER_PASS("Scene render");
 		auto& tbCollection = info.GetTbCollection();
 		auto& sceneRenderData = info.GetSceneRenderData();
 		const GameSettings::VideoSettings& settings = tbCollection.GetVideoSettings();
@@ -454,10 +464,18 @@ namespace GEE
 					glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
 				Shader* gShader = deferredTb->GeometryShader;
+				if (Shader* instancedGShader = gShader->GetInstancedVariant())
+				{
+					instancedGShader->Use();
+					deferredTb->InstancedGeometryCamPosHandle.Set(info.GetCamPosition());
+				}
 				gShader->Use();
-				gShader->Uniform<Vec3f>("camPos", info.GetCamPosition());
+				deferredTb->GeometryCamPosHandle.Set(info.GetCamPosition());
 
-				RawRender(info, *gShader);
+				{
+					GEE_PROFILE_RENDER_PASS("Geometry pass");
+					RawRender(info, *gShader);
+				}
 
 				info.SetMainPass(false);
 				info.StopRequiringShaderInfo();
@@ -470,7 +488,10 @@ namespace GEE
 				Texture SSAOtex;
 				
 				if (settings.AmbientOcclusionSamples > 0)
+				{
+					GEE_PROFILE_RENDER_PASS("SSAO pass");
 					SSAOtex = PostprocessRenderer(Impl.RenderHandle, GFramebuffer).SSAO(info, GFramebuffer.GetColorTexture(1), GFramebuffer.GetColorTexture(2));	//pass gPosition and gNormal
+				}
 
 				////////////////////3. Lighting pass
 				for (int i = 0; i < static_cast<int>(deferredTb->LightShaders.size()); i++)
@@ -490,28 +511,32 @@ namespace GEE
 				if (SSAOtex.HasBeenGenerated())
 					SSAOtex.Bind(4);
 
-				VolumeRenderer(Impl.RenderHandle, &MainFramebuffer).Volumes(info, sceneRenderData.GetSceneLightsVolumes(), false);
+				{
+					GEE_PROFILE_RENDER_PASS("Lighting pass");
+					VolumeRenderer(Impl.RenderHandle, &MainFramebuffer).Volumes(info, sceneRenderData.GetSceneLightsVolumes(), false);
+				}
 				
 				////////////////////3.1 IBL pass
 				
-				deferredTb->FindShader("CookTorranceIBL")->Use();
+				deferredTb->IBLShader->Use();
 				//Impl.GetShader(RendererShaderHint::IBL).Use();
-				for (int i = 0; i < static_cast<int>(sceneRenderData.LightProbes.size()); i++)
+				for (int i = 0; i < static_cast<int>(sceneRenderData.LightProbes.size()) && i < static_cast<int>(deferredTb->LightProbeHandles.size()); i++)
 				{
 					LightProbeComponent* probe = sceneRenderData.LightProbes[i];
-					Shader* shader = probe->GetRenderShader(tbCollection);
-					shader->Uniform<float>("lightProbes[" + std::to_string(i) + "].intensity", probe->GetProbeIntensity());
+					const DeferredShadingToolbox::LightProbeUniformHandles& probeHandles = deferredTb->LightProbeHandles[i];
+					probeHandles.Intensity.Set(probe->GetProbeIntensity());
 
 					if (probe->GetShape() == EngineBasicShape::Quad)
 						continue;
 
-					shader->Uniform<Vec3f>("lightProbes[" + std::to_string(i) + "].position", probe->GetTransform().GetWorldTransform().GetPos());
+					probeHandles.Position.Set(probe->GetTransform().GetWorldTransform().GetPos());
 				}
 				
 				auto probeVolumes = sceneRenderData.GetLightProbeVolumes();
 
 				if (!probeVolumes.empty())
 				{
+					GEE_PROFILE_RENDER_PASS("IBL pass");
 					sceneRenderData.ProbeTexArrays->IrradianceMapArr.Bind(12);
 					sceneRenderData.ProbeTexArrays->PrefilterMapArr.Bind(13);
 					sceneRenderData.ProbeTexArrays->BRDFLut.Bind(14);
@@ -554,6 +579,7 @@ namespace GEE
 				lightShader->UniformBlockBinding("Lights", sceneRenderData.LightsBuffer.BlockBindingSlot);
 				sceneRenderData.UpdateLightUniforms();
 
+				GEE_PROFILE_RENDER_PASS("Forward shading pass");
 				RawRender(info, *lightShader);
 			}
 		}
@@ -582,9 +608,13 @@ namespace GEE
 		info.SetMainPass(true);
 		
 		if (modifyForwardsDepthForUI)
+		{
+			GEE_PROFILE_RENDER_PASS("UI pass");
 			RawUIRender(info);
+		}
 		else
 		{
+			GEE_PROFILE_RENDER_PASS("Forward pass");
 			info.SetRequiredShaderInfo(MaterialShaderHint::Simple);
 			RawRender(info, *Impl.RenderHandle.GetSimpleShader());
 			for (auto shader : this->Impl.RenderHandle.GetCustomShaders())
@@ -594,10 +624,8 @@ namespace GEE
 			}
 		}
 		
-		Shader& defaultForwardShader = Impl.GetShader(RendererShaderHint::DefaultForward);
-		defaultForwardShader.Use();
-		defaultForwardShader.Uniform<Vec2f>("atlasData", Vec2f(0.0f));
-		defaultForwardShader.Uniform<Vec2f>("atlasTexOffset", Vec2f(0.0f));
+		// Do not let the atlas index of the last rendered material affect the following draws
+		MaterialUtil::BindDefaultInstanceDataBlock();
 
 
 		info.SetMainPass(false);
@@ -629,12 +657,36 @@ namespace GEE
 		BindingsGL::BoundMesh = nullptr;
 		BindingsGL::BoundMaterial = nullptr;
 
+		const Frustum frustum(info.GetVP());
+		CullingPassStats stats{ shader.GetName(), info.GetOnlyShadowCasters(), 0, 0 };
+		Boxf<Vec3f> worldBounds(Vec3f(0.0f), Vec3f(0.0f));
+
+		RenderQueue& queue = info.GetSceneRenderData().GetRenderQueue();
+		queue.Clear(RenderQueue::GetSortModeForPass(info), true);
+
+		info.GetSceneRenderData().UpdateWorldBounds();
+
 		for (auto renderable : info.GetSceneRenderData().Renderables)
 		{
 			if (info.GetOnlyShadowCasters() && !renderable->CastsShadow())
 				continue;
-			renderable->Render(info, &shader);
+
+			stats.TestedCount++;
+			bool bHasBounds = renderable->GetWorldBounds(worldBounds);
+			if (bHasBounds && !frustum.Intersects(worldBounds))
+			{
+				stats.CulledCount++;
+				continue;
+			}
+
+			if (!renderable->EnqueueDraws(info, shader, queue))
+				queue.AddRenderable(shader, *renderable, (bHasBounds) ? (RenderQueue::GetViewDepth(info, worldBounds.Position)) : (0.0f));
 		}
+
+		queue.Sort();
+		queue.Submit(info, shader);
+
+		info.GetSceneRenderData().RecordCullingPass(stats);
 	}
 
 	void SceneRenderer::RawUIRender(const SceneMatrixInfo& infoTemplate)
@@ -679,6 +731,7 @@ namespace GEE
 		const Viewport* viewport, const Texture& tex, int passes,
 		unsigned int writeColorBuffer)
 	{
+		GEE_PROFILE_RENDER_PASS("Gaussian blur");
 		GEE_CORE_ASSERT(Impl.OptionalFramebuffer != nullptr);
 		const GEE_FB::Framebuffer& framebuffer = *Impl.OptionalFramebuffer;
 		if (passes == 0)
@@ -704,7 +757,7 @@ namespace GEE
 				const Texture& bindTex = (i == 0) ? (tex) : static_cast<Texture>(tb.BlurFramebuffers[!horizontal]->GetColorTexture(0));
 				bindTex.Bind();
 			}
-			tb.GaussianBlurShader->Uniform<int>("horizontal", horizontal);
+			tb.HorizontalHandle.Set(horizontal);
 			ppTb.RenderFullscreenQuad(tb.GaussianBlurShader, false);
 
 			horizontal = !horizontal;
@@ -737,8 +790,8 @@ namespace GEE
 		tb->SSAONoiseTex->Bind(2);
 
 		tb->SSAOShader->Use();
-		tb->SSAOShader->Uniform<Mat4f>("view", info.GetView());
-		tb->SSAOShader->Uniform<Mat4f>("projection", info.GetProjection());
+		tb->SSAOViewHandle.Set(info.GetView());
+		tb->SSAOProjectionHandle.Set(info.GetProjection());
 
 
 		RenderFullscreenQuad(TbInfo<MatrixInfoExt>(info.GetTbCollection(), info), tb->SSAOShader, false);
@@ -755,6 +808,7 @@ namespace GEE
 		const Texture& previousColorTex, const Texture& velocityTex,
 		unsigned int writeColorBuffer, bool bT2x)
 	{
+		GEE_PROFILE_RENDER_PASS("SMAA");
 		GEE_CORE_ASSERT(Impl.OptionalFramebuffer != nullptr);
 		const GEE_FB::Framebuffer& framebuffer = *Impl.OptionalFramebuffer;
 		SMAAToolbox& tb = ppTb.GetTb();
@@ -835,6 +889,7 @@ namespace GEE
 
 	Texture PostprocessRenderer::TonemapGamma(PPToolbox<ComposedImageStorageToolbox> tb, const Viewport* viewport, const Texture& colorTex, const Texture& blurTex)
 	{
+		GEE_PROFILE_RENDER_PASS("Tonemapping and gamma correction");
 		GEE_CORE_ASSERT(Impl.OptionalFramebuffer != nullptr);
 		const GEE_FB::Framebuffer& framebuffer = *Impl.OptionalFramebuffer;
 		if (viewport) framebuffer.Bind(*viewport);
@@ -852,7 +907,6 @@ namespace GEE
 			blurTex.Bind(1);
 		else
 			Texture().Bind(1);
-		tb.GetTb().TonemapGammaShader->Uniform<int>("HDRbuffer", 0);
 
 		tb.RenderFullscreenQuad(tb.GetTb().TonemapGammaShader);
 
@@ -861,6 +915,7 @@ namespace GEE
 
 	void PostprocessRenderer::Render(RenderingContextID contextID, RenderToolboxCollection& tbCollection, const Viewport* viewport, const Texture& colorTex, Texture blurTex, const Texture& depthTex, const Texture& velocityTex, std::function<void(GEE_FB::Framebuffer&)> renderIconsFunc)
 	{
+		GEE_PROFILE_RENDER_PASS("Postprocess");
 		GEE_CORE_ASSERT(Impl.OptionalFramebuffer != nullptr);
 		const GEE_FB::Framebuffer& finalFramebuffer = *Impl.OptionalFramebuffer;
 		const GameSettings::VideoSettings& settings = tbCollection.GetVideoSettings();
@@ -924,6 +979,7 @@ namespace GEE
 	}
 	void LightProbeRenderer::AllSceneProbes(RenderingContextID contextID, GameSceneRenderData& sceneRenderData)
 	{
+		GEE_PROFILE_RENDER_PASS("Light probes pass");
 		if (sceneRenderData.LightProbes.empty())
 		{
 			std::cout << "INFO: No light probes in scene " << sceneRenderData.GetSceneName() << ". Nothing will be rendered.\n";
@@ -989,7 +1045,7 @@ namespace GEE
 
 		std::cout << "Initting done.\n";
 	}
-	void SkeletalMeshRenderer::SkeletalMeshInstances(const MatrixInfoExt& info, const std::vector<MeshInstance>& meshes, SkeletonInfo& skelInfo, const Transform& transform, Shader& shader)
+	void SkeletalMeshRenderer::SkeletalMeshInstances(const MatrixInfoExt& info, IndirectSpan<const MeshInstance, UniquePtr<MeshInstance>> meshes, SkeletonInfo& skelInfo, const Transform& transform, Shader& shader)
 	{
 		if (meshes.empty())
 			return;
@@ -1014,7 +1070,7 @@ namespace GEE
 			{
 				handledShader = true;
 
-				shader.Uniform<int>("boneIDOffset", skelInfo.GetBoneIDOffset());
+				shader.GetBoneIDOffsetHandle().Set(skelInfo.GetBoneIDOffset());
 
 				Mat4f modelMat = transform.GetWorldTransformMatrix();	//the ComponentTransform's world transform is cached
 
@@ -1024,7 +1080,7 @@ namespace GEE
 			if (skelInfo.GetBatchPtr() !=  Impl.RenderHandle.GetBoundSkeletonBatch())
 				Impl.RenderHandle.BindSkeletonBatch(skelInfo.GetBatchPtr());
 
-			shader.Uniform<int>("boneIDOffset", skelInfo.GetBoneIDOffset());
+			shader.GetBoneIDOffsetHandle().Set(skelInfo.GetBoneIDOffset());
 
 			//if (BindingsGL::BoundMesh != &mesh || i == 0)
 			{
@@ -1065,6 +1121,8 @@ namespace GEE
 	void PhysicsDebugRenderer::DebugRender(Physics::GameScenePhysicsData& scenePhysicsData, SceneMatrixInfo& info)
 	{
 		using namespace Physics::Util;
+		GEE_PROFILE_RENDER_PASS("Physics debug pass");
+		scenePhysicsData.GetPhysicsHandle()->FetchResults();	// the render buffer cannot be read while the scene is being simulated
 		const physx::PxRenderBuffer& rb = scenePhysicsData.GetPxScene()->getRenderBuffer();
 
 		std::vector<std::array<Vec3f, 2>> verts;
@@ -1127,6 +1185,7 @@ namespace GEE
 		debugShader->Uniform<Mat4f>("MVP", info.GetVP());
 		debugShader->Uniform<Vec3f>("color", color);
 		glDrawArrays(mode, first, count);
+		GpuProfiler::CountDrawCall((mode == GL_TRIANGLES) ? (count / 3) : (0));
 	}
 	void GameRenderer::PrepareFrame(GameScene* mainScene)
 	{
@@ -1188,10 +1247,11 @@ namespace GEE
 		auto textMaterial = MakeShared<Material>("TextMaterial", *shader);
 
 		info.SetUseMaterials(false);	// do not bind materials before rendering quads
+		const UniformHandle<int> glyphNrHandle = shader->GetHandle<int>("material.glyphNr");
 
 		for (int i = 0; i < static_cast<int>(content.length()); i++)
 		{
-			shader->Uniform<int>("material.glyphNr", content[i]);
+			glyphNrHandle.Set(content[i]);
 			const Character& c = fontVariation.GetCharacter(content[i]);
 
 			Renderer(*this).StaticMeshInstances(info, { MeshInstance(Impl.GetBasicShapeMesh(EngineBasicShape::Quad), textMaterial) }, letterTransforms[i], *shader);
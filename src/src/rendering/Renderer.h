@@ -4,6 +4,7 @@
 #include <rendering/Texture.h>
 #include <rendering/RenderToolbox.h>
 #include <UI/Font.h>
+#include <utility/Span.h>
 
 namespace GEE
 {
@@ -67,9 +68,12 @@ namespace GEE
 		Renderer& operator=(Renderer&&) = delete;
 
 		// Utility rendering function
-		void StaticMeshInstances(const MatrixInfoExt& info, const std::vector<MeshInstance>& meshes, const Transform& transform, Shader& shader, bool billboard = false); //Note: this function does not call the Use method of passed Shader. Do it manually.
+		void StaticMeshInstances(const MatrixInfoExt& info, Span<const MeshInstance> meshes, const Transform& transform, Shader& shader, bool billboard = false); //Note: this function does not call the Use method of passed Shader. Do it manually.
+		void StaticMeshInstances(const MatrixInfoExt& info, IndirectSpan<const MeshInstance, UniquePtr<MeshInstance>> meshes, const Transform& transform, Shader& shader, bool billboard = false);
 
 	protected:
+		template <typename MeshInstanceSpan> void StaticMeshInstancesImpl(const MatrixInfoExt& info, MeshInstanceSpan meshes, const Transform& transform, Shader& shader, bool billboard);
+
 		struct ImplUtil
 		{
 			ImplUtil(RenderEngineManager& engineHandle, const GEE_FB::Framebuffer* optionalFramebuffer = nullptr)
@@ -225,7 +229,7 @@ namespace GEE
 	public:
 		using Renderer::Renderer;
 
-		void SkeletalMeshInstances(const MatrixInfoExt& info, const std::vector<MeshInstance>& meshes, SkeletonInfo& skelInfo, const Transform& transform, Shader& shader);
+		void SkeletalMeshInstances(const MatrixInfoExt& info, IndirectSpan<const MeshInstance, UniquePtr<MeshInstance>> meshes, SkeletonInfo& skelInfo, const Transform& transform, Shader& shader);
 	};
 
 	class TextRenderer : public Renderer
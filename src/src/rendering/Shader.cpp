@@ -1,4 +1,7 @@
 #include <rendering/Shader.h>
+#include <rendering/ShaderBinaryCache.h>
+#include <rendering/GpuProfiler.h>
+#include <chrono>
 #include <fstream>
 
 #include <UI/UICanvasActor.h>
@@ -7,56 +10,59 @@
 
 namespace GEE
 {
-	template <> void Shader::Uniform<int>(const String& name, const int& val) const { glUniform1i(FindLocation(name), val); }
-	template <> void Shader::Uniform<bool>(const String& name, const bool& val) const { glUniform1i(FindLocation(name), val); }
-	template <> void Shader::Uniform<float>(const String& name, const float& val) const { glUniform1f(FindLocation(name), val); }
+	template <> void UniformHandle<int>::Set(const int& val) const { glUniform1i(Location, val); }
+	template <> void UniformHandle<bool>::Set(const bool& val) const { glUniform1i(Location, val); }
+	template <> void UniformHandle<float>::Set(const float& val) const { glUniform1f(Location, val); }
 
-	template <> void Shader::Uniform<Vec2f>(const String& name, const Vec2f& val) const { glUniform2fv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec3f>(const String& name, const Vec3f& val) const { glUniform3fv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec4f>(const String& name, const Vec4f& val) const { glUniform4fv(FindLocation(name), 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec2f>::Set(const Vec2f& val) const { glUniform2fv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec3f>::Set(const Vec3f& val) const { glUniform3fv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec4f>::Set(const Vec4f& val) const { glUniform4fv(Location, 1, Math::GetDataPtr(val)); }
 
-	template <> void Shader::Uniform<Vec2u>(const String& name, const Vec2u& val) const { glUniform2uiv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec3u>(const String& name, const Vec3u& val) const { glUniform3uiv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec4u>(const String& name, const Vec4u& val) const { glUniform4uiv(FindLocation(name), 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec2u>::Set(const Vec2u& val) const { glUniform2uiv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec3u>::Set(const Vec3u& val) const { glUniform3uiv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec4u>::Set(const Vec4u& val) const { glUniform4uiv(Location, 1, Math::GetDataPtr(val)); }
 
-	template <> void Shader::Uniform<Vec2i>(const String& name, const Vec2i& val) const { glUniform2iv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec3i>(const String& name, const Vec3i& val) const { glUniform3iv(FindLocation(name), 1, Math::GetDataPtr(val)); }
-	template <> void Shader::Uniform<Vec4i>(const String& name, const Vec4i& val) const { glUniform4iv(FindLocation(name), 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec2i>::Set(const Vec2i& val) const { glUniform2iv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec3i>::Set(const Vec3i& val) const { glUniform3iv(Location, 1, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Vec4i>::Set(const Vec4i& val) const { glUniform4iv(Location, 1, Math::GetDataPtr(val)); }
 
-	template <> void Shader::Uniform<Vec2b>(const String& name, const Vec2b& val) const { Uniform<Vec2i>(name, static_cast<const Vec2i>(val)); }
-	template <> void Shader::Uniform<Vec3b>(const String& name, const Vec3b& val) const { Uniform<Vec3i>(name, static_cast<const Vec3i>(val)); }
-	template <> void Shader::Uniform<Vec4b>(const String& name, const Vec4b& val) const { Uniform<Vec4i>(name, static_cast<const Vec4i>(val)); }
+	template <> void UniformHandle<Vec2b>::Set(const Vec2b& val) const { UniformHandle<Vec2i>(Location).Set(static_cast<const Vec2i>(val)); }
+	template <> void UniformHandle<Vec3b>::Set(const Vec3b& val) const { UniformHandle<Vec3i>(Location).Set(static_cast<const Vec3i>(val)); }
+	template <> void UniformHandle<Vec4b>::Set(const Vec4b& val) const { UniformHandle<Vec4i>(Location).Set(static_cast<const Vec4i>(val)); }
 
-	template <> void Shader::Uniform<Mat3f>(const String& name, const Mat3f& val) const { glUniformMatrix3fv(FindLocation(name), 1, GL_FALSE, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Mat3f>::Set(const Mat3f& val) const { glUniformMatrix3fv(Location, 1, GL_FALSE, Math::GetDataPtr(val)); }
 
-	template <> void Shader::Uniform<Mat4f>(const String& name, const Mat4f& val) const { glUniformMatrix4fv(FindLocation(name), 1, GL_FALSE, Math::GetDataPtr(val)); }
+	template <> void UniformHandle<Mat4f>::Set(const Mat4f& val) const { glUniformMatrix4fv(Location, 1, GL_FALSE, Math::GetDataPtr(val)); }
 
 
 
-	template <> void Shader::UniformArray<int>(const String& name, const int* val, unsigned int size) const { glUniform1iv(FindLocation(name), size, val); }
-	template <> void Shader::UniformArray<bool>(const String& name, const bool* val, unsigned int size) const { glUniform1iv(FindLocation(name), size, reinterpret_cast<const GLint*>(val)); }
-	template <> void Shader::UniformArray<float>(const String& name, const float* val, unsigned int size) const { glUniform1fv(FindLocation(name), size, val); }
+	template <> void UniformHandle<int>::SetArray(const int* val, unsigned int size) const { glUniform1iv(Location, size, val); }
+	template <> void UniformHandle<bool>::SetArray(const bool* val, unsigned int size) const { glUniform1iv(Location, size, reinterpret_cast<const GLint*>(val)); }
+	template <> void UniformHandle<float>::SetArray(const float* val, unsigned int size) const { glUniform1fv(Location, size, val); }
 
-	template <> void Shader::UniformArray<Vec2f>(const String& name, const Vec2f* val, unsigned int size) const { glUniform2fv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec3f>(const String& name, const Vec3f* val, unsigned int size) const { glUniform3fv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec4f>(const String& name, const Vec4f* val, unsigned int size) const { glUniform4fv(FindLocation(name), size, &(*val)[0]); }
+	template <> void UniformHandle<Vec2f>::SetArray(const Vec2f* val, unsigned int size) const { glUniform2fv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec3f>::SetArray(const Vec3f* val, unsigned int size) const { glUniform3fv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec4f>::SetArray(const Vec4f* val, unsigned int size) const { glUniform4fv(Location, size, &(*val)[0]); }
 
-	template <> void Shader::UniformArray<Vec2u>(const String& name, const Vec2u* val, unsigned int size) const { glUniform2uiv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec3u>(const String& name, const Vec3u* val, unsigned int size) const { glUniform3uiv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec4u>(const String& name, const Vec4u* val, unsigned int size) const { glUniform4uiv(FindLocation(name), size, &(*val)[0]); }
+	template <> void UniformHandle<Vec2u>::SetArray(const Vec2u* val, unsigned int size) const { glUniform2uiv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec3u>::SetArray(const Vec3u* val, unsigned int size) const { glUniform3uiv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec4u>::SetArray(const Vec4u* val, unsigned int size) const { glUniform4uiv(Location, size, &(*val)[0]); }
 
-	template <> void Shader::UniformArray<Vec2i>(const String& name, const Vec2i* val, unsigned int size) const { glUniform2iv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec3i>(const String& name, const Vec3i* val, unsigned int size) const { glUniform3iv(FindLocation(name), size, &(*val)[0]); }
-	template <> void Shader::UniformArray<Vec4i>(const String& name, const Vec4i* val, unsigned int size) const { glUniform4iv(FindLocation(name), size, &(*val)[0]); }
+	template <> void UniformHandle<Vec2i>::SetArray(const Vec2i* val, unsigned int size) const { glUniform2iv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec3i>::SetArray(const Vec3i* val, unsigned int size) const { glUniform3iv(Location, size, &(*val)[0]); }
+	template <> void UniformHandle<Vec4i>::SetArray(const Vec4i* val, unsigned int size) const { glUniform4iv(Location, size, &(*val)[0]); }
 
-	template <> void Shader::UniformArray<Mat3f>(const String& name, const Mat3f* val, unsigned int size) const { glUniformMatrix3fv(FindLocation(name), size, GL_FALSE, &(*val)[0][0]); }
+	template <> void UniformHandle<Mat3f>::SetArray(const Mat3f* val, unsigned int size) const { glUniformMatrix3fv(Location, size, GL_FALSE, &(*val)[0][0]); }
 
-	template <> void Shader::UniformArray<Mat4f>(const String& name, const Mat4f* val, unsigned int size) const { glUniformMatrix4fv(FindLocation(name), size, GL_FALSE, &(*val)[0][0]); }
+	template <> void UniformHandle<Mat4f>::SetArray(const Mat4f* val, unsigned int size) const { glUniformMatrix4fv(Location, size, GL_FALSE, &(*val)[0][0]); }
 
 	Shader::Shader(const String& name) :
 		Program(0),
 		Name(name),
 		ExpectedMatrices{},
+		InstancedVariant(nullptr),
+		bUsesMaterialDataBlock(false),
+		bUsesMaterialInstanceDataBlock(false),
 		OnMaterialWholeDataUpdateFunc(nullptr)
 	{
 		ShadersSource = { "", "", "" };
@@ -123,6 +129,16 @@ namespace GEE
 			std::cerr << "ERROR! Can't find matrix type " << matType << '\n';
 	}
 
+	void Shader::SetInstancedVariant(Shader* instancedVariant)
+	{
+		InstancedVariant = instancedVariant;
+	}
+
+	Shader* Shader::GetInstancedVariant() const
+	{
+		return InstancedVariant;
+	}
+
 	void Shader::CallPreRenderFunc()
 	{
 		if (PreRenderFunc)
@@ -154,24 +170,25 @@ namespace GEE
 	void Shader::Use() const
 	{
 		glUseProgram(Program);
+		GpuProfiler::CountShaderBind();
 	}
 
 	void Shader::BindMatrices(const Mat4f& model, const Mat4f* view, const Mat4f* projection, const Mat4f* VP)
 	{
 		if (ExpectedMatrices[MatrixType::MODEL])
-			Uniform("model", model);
+			MatrixHandles[MatrixType::MODEL].Set(model);
 		if (ExpectedMatrices[MatrixType::VIEW])
-			Uniform("view", *view);
+			MatrixHandles[MatrixType::VIEW].Set(*view);
 		if (ExpectedMatrices[MatrixType::PROJECTION])
-			Uniform("projection", *projection);
+			MatrixHandles[MatrixType::PROJECTION].Set(*projection);
 		if (ExpectedMatrices[MatrixType::MV])
-			Uniform("MV", (*view) * model);
+			MatrixHandles[MatrixType::MV].Set((*view) * model);
 		if (ExpectedMatrices[MatrixType::VP])
-			Uniform("VP", *VP);
+			MatrixHandles[MatrixType::VP].Set(*VP);
 		if (ExpectedMatrices[MatrixType::MVP])
-			Uniform("MVP", (*VP) * model);
+			MatrixHandles[MatrixType::MVP].Set((*VP) * model);
 		if (ExpectedMatrices[MatrixType::NORMAL])
-			Uniform<Mat3f>("normalMat", Math::ModelToNormal(model));
+			NormalMatrixHandle.Set(Math::ModelToNormal(model));
 	}
 
 
@@ -203,32 +220,66 @@ namespace GEE
 
 	GLint Shader::FindLocation(const String& name) const
 	{
-		if (Locations[name] == 0)
-			Locations[name] = glGetUniformLocation(Program, name.c_str());
+		// Location 0 is valid, so only the presence of the key tells that the location was already queried.
+		auto found = Locations.find(name);
+		if (found == Locations.end())
+			found = Locations.emplace(name, glGetUniformLocation(Program, name.c_str())).first;
 
-		return Locations[name];
+		return found->second;
 	}
 
+	void Shader::ResolveEngineUniformHandles()
+	{
+		const std::array<String, MatrixType::NORMAL> matrixNames = { "model", "view", "projection", "MV", "VP", "MVP" };
+		for (unsigned int i = 0; i < matrixNames.size(); i++)
+			MatrixHandles[i] = GetHandle<Mat4f>(matrixNames[i]);
+		NormalMatrixHandle = GetHandle<Mat3f>("normalMat");
+		BoneIDOffsetHandle = GetHandle<int>("boneIDOffset");
+		LightIndexHandle = GetHandle<int>("lightIndex");
+		LightProbeNrHandle = GetHandle<float>("lightProbeNr");
+
+		MaterialHandles.Shininess = GetHandle<float>("material.shininess");
+		MaterialHandles.DepthScale = GetHandle<float>("material.depthScale");
+		MaterialHandles.Color = GetHandle<Vec4f>("material.color");
+		MaterialHandles.RoughnessMetallicAoColor = GetHandle<Vec3f>("material.roughnessMetallicAoColor");
+		MaterialHandles.DisableColor = GetHandle<bool>("material.disableColor");
+		MaterialHandles.AtlasData = GetHandle<Vec2f>("atlasData");
+		MaterialHandles.AtlasTexOffset = GetHandle<Vec2f>("atlasTexOffset");
+	}
 
-	unsigned int ShaderLoader::LoadShader(GLenum type, const String& shaderPath, String additionalData, String* shaderSourcePtr)
+	void Shader::SetupEngineUniformBlocks()
+	{
+		const GLuint materialBlockIndex = glGetUniformBlockIndex(Program, "MaterialData");
+		bUsesMaterialDataBlock = (materialBlockIndex != GL_INVALID_INDEX);
+		if (bUsesMaterialDataBlock)
+			UniformBlockBinding(materialBlockIndex, EngineUniformBlockSlot::MaterialData);
+
+		const GLuint instanceBlockIndex = glGetUniformBlockIndex(Program, "MaterialInstanceData");
+		bUsesMaterialInstanceDataBlock = (instanceBlockIndex != GL_INVALID_INDEX);
+		if (bUsesMaterialInstanceDataBlock)
+			UniformBlockBinding(instanceBlockIndex, EngineUniformBlockSlot::MaterialInstanceData);
+	}
+
+
+	bool ShaderLoader::ReadShaderSource(const String& shaderPath, const String& additionalData, String& shaderSource)
 	{
-		additionalData = "#version 400 core\n" + additionalData;
 		std::fstream shaderFile(shaderPath);
 
 		if (!shaderFile.good())
 		{
 			std::cout << "ERROR: Cannot open: " << shaderPath << "(\n";
-			return -1;
+			return false;
 		}
 
 		std::stringstream shaderStream;
 		shaderStream << shaderFile.rdbuf();
 
-		String shaderSourceStr = additionalData + shaderStream.str();
-		if (shaderSourcePtr)
-			*shaderSourcePtr = shaderSourceStr;
-
+		shaderSource = "#version 400 core\n" + additionalData + shaderStream.str();
+		return true;
+	}
 
+	unsigned int ShaderLoader::CompileShader(GLenum type, const String& shaderSourceStr, const String& shaderPath)
+	{
 		const char* shaderSource = shaderSourceStr.c_str();
 
 		unsigned int shader = glCreateShader(type);
@@ -255,6 +306,20 @@ namespace GEE
 		return true;
 	}
 
+	bool ShaderLoader::DebugProgram(unsigned int programID, const String& shaderName)
+	{
+		int result;
+		char data[512];
+		glGetProgramiv(programID, GL_LINK_STATUS, &result);
+		if (!result)
+		{
+			glGetProgramInfoLog(programID, 512, NULL, data);
+			std::cout << "Program linking error (" + shaderName + ")\n" << data << '\n';
+			return false;
+		}
+		return true;
+	}
+
 	SharedPtr<Shader> ShaderLoader::LoadShaders(const String& shaderName, const String& vShaderPath, const String& fShaderPath, const String& gShaderPath)
 	{
 		return LoadShadersWithInclData(shaderName, "", vShaderPath, fShaderPath, gShaderPath);
@@ -267,27 +332,62 @@ namespace GEE
 
 	SharedPtr<Shader> ShaderLoader::LoadShadersWithExclData(const String& shaderName, const String& vShaderData, const String& vShaderPath, const String& fShaderData, const String& fShaderPath, const String& gShaderData, const String& gShaderPath)
 	{
+		const auto loadingStart = std::chrono::steady_clock::now();
+
 		SharedPtr<Shader> shaderObj = MakeShared<Shader>(shaderName);
 		unsigned int nrShaders = (gShaderPath.empty()) ? (2) : (3);
-		Vector<unsigned int> shaders(nrShaders);
+		const std::array<GLenum, 3> types = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER };
+		const std::array<const String*, 3> paths = { &vShaderPath, &fShaderPath, &gShaderPath };
+		const std::array<const String*, 3> datas = { &vShaderData, &fShaderData, &gShaderData };
 
+		bool bAllSourcesRead = true;
+		for (unsigned int i = 0; i < nrShaders; i++)
+			bAllSourcesRead &= ReadShaderSource(*paths[i], *datas[i], shaderObj->ShadersSource[i]);
 
-		shaders[0] = LoadShader(GL_VERTEX_SHADER, vShaderPath, vShaderData, &shaderObj->ShadersSource[0]);
-		shaders[1] = LoadShader(GL_FRAGMENT_SHADER, fShaderPath, fShaderData, &shaderObj->ShadersSource[1]);
-		if (nrShaders == 3) shaders[2] = LoadShader(GL_GEOMETRY_SHADER, gShaderPath, gShaderData, &shaderObj->ShadersSource[2]);
+		ShaderBinaryCache& binaryCache = ShaderBinaryCache::Get();
+		binaryCache.Init();
+		const bool bCacheable = bAllSourcesRead && binaryCache.IsEnabled();
+		const std::uint64_t binaryKey = (bCacheable) ? (binaryCache.ComputeKey(shaderObj->ShadersSource)) : (0);
 
 		shaderObj->Program = glCreateProgram();
+		const unsigned int rejectedBinaryCount = binaryCache.GetStats().RejectedBinaries;
+		const bool bLoadedFromCache = bCacheable && binaryCache.TryLoad(shaderObj->Program, binaryKey);
 
-		for (unsigned int i = 0; i < nrShaders; i++)
-			glAttachShader(shaderObj->Program, shaders[i]);
-		glLinkProgram(shaderObj->Program);
-
-		for (unsigned int i = 0; i < nrShaders; i++)
+		if (!bLoadedFromCache)
 		{
-			glDetachShader(shaderObj->Program, shaders[i]);
-			glDeleteShader(shaders[i]);
+			if (binaryCache.GetStats().RejectedBinaries != rejectedBinaryCount)
+			{
+				// A failed glProgramBinary call may leave the program in an unusable state, so start from a fresh one.
+				glDeleteProgram(shaderObj->Program);
+				shaderObj->Program = glCreateProgram();
+			}
+
+			Vector<unsigned int> shaders(nrShaders);
+			for (unsigned int i = 0; i < nrShaders; i++)
+			{
+				shaders[i] = CompileShader(types[i], shaderObj->ShadersSource[i], *paths[i]);
+				glAttachShader(shaderObj->Program, shaders[i]);
+			}
+
+			if (bCacheable)
+				binaryCache.PrepareForStore(shaderObj->Program);
+			glLinkProgram(shaderObj->Program);
+
+			for (unsigned int i = 0; i < nrShaders; i++)
+			{
+				glDetachShader(shaderObj->Program, shaders[i]);
+				glDeleteShader(shaders[i]);
+			}
+
+			if (bCacheable && DebugProgram(shaderObj->Program, shaderName))
+				binaryCache.Store(shaderObj->Program, binaryKey);
 		}
 
+		binaryCache.RecordLoadedProgram(bLoadedFromCache, std::chrono::duration<Time>(std::chrono::steady_clock::now() - loadingStart).count());
+
+		shaderObj->SetupEngineUniformBlocks();
+		shaderObj->ResolveEngineUniformHandles();
+
 		return shaderObj;
 	}
 }
\ No newline at end of file
@@ -26,10 +26,55 @@ namespace GEE
 	class EditorDescriptionBuilder;
 	class Material;
 
+	/**
+	 * @brief Block binding slots of the uniform blocks that the engine binds by itself. A shader which declares a block with one of these names is linked to its slot right after it is loaded.
+	*/
+	namespace EngineUniformBlockSlot
+	{
+		constexpr unsigned int MaterialData = 12;	// "MaterialData" - see Material::MaterialDataBlock
+		constexpr unsigned int MaterialInstanceData = 13;	// "MaterialInstanceData" - see Material::InstanceDataBlock
+	}
+
+	/**
+	 * @brief A uniform location of a linked shader program, resolved once (see Shader::GetHandle()). Setting it is a single glUniform* call, without any name lookup.
+	 * Like Shader::Uniform(), it sets the uniform of the program that is currently in use, so the shader must be used before calling Set().
+	 * A default-constructed handle (or a handle to a uniform which is not active in the program) is invalid; setting it does nothing.
+	*/
+	template <typename T>
+	class UniformHandle
+	{
+	public:
+		UniformHandle() : Location(-1) {}
+
+		[[nodiscard]] bool IsValid() const { return Location != -1; }
+		[[nodiscard]] GLint GetLocation() const { return Location; }
+		void Set(const T&) const;
+		void SetArray(const T*, unsigned int size) const;
+
+	private:
+		explicit UniformHandle(GLint location) : Location(location) {}
+		GLint Location;
+
+		friend class Shader;
+		template <typename> friend class UniformHandle;
+	};
+
 	class Shader
 	{
 		friend struct ShaderLoader;
 	public:
+		/**
+		 * @brief Handles of the "material.*" and atlas uniforms, used by shaders which do not declare the MaterialData and MaterialInstanceData blocks.
+		*/
+		struct MaterialUniformHandles
+		{
+			UniformHandle<float> Shininess, DepthScale;
+			UniformHandle<Vec4f> Color;
+			UniformHandle<Vec3f> RoughnessMetallicAoColor;
+			UniformHandle<bool> DisableColor;
+			UniformHandle<Vec2f> AtlasData, AtlasTexOffset;
+		};
+
 		explicit Shader(const String& name = "undefinedShader");
 		[[nodiscard]] String GetName();
 		[[nodiscard]] Vector<Pair<unsigned int, String>>* GetMaterialTextureUnits();
@@ -41,6 +86,13 @@ namespace GEE
 		void SetExpectedMatrices(std::vector<MatrixType>);
 		void AddExpectedMatrix(const String&);
 
+		/**
+		 * @brief Sets the variant of this shader compiled with INSTANCING defined, which reads model matrices from per-instance vertex attributes (locations 7-10).
+		 * The variant is not owned by this shader. Remember to set any per-pass uniforms on both shaders.
+		*/
+		void SetInstancedVariant(Shader*);
+		[[nodiscard]] Shader* GetInstancedVariant() const;
+
 		/**
 		 * @param func: A procedure (void function) with no parameters.
 		*/
@@ -63,14 +115,43 @@ namespace GEE
 		void CallOnMaterialWholeDataUpdateFunc(const Material&);
 
 		template <typename T>
-		void Uniform(const String& nameInShader, const T&) const;
+		void Uniform(const String& nameInShader, const T& val) const { GetHandle<T>(nameInShader).Set(val); }
 		template <typename T>
-		void UniformArray(const String& nameInShader, const T*, unsigned int size) const;
+		void UniformArray(const String& nameInShader, const T* val, unsigned int size) const { GetHandle<T>(nameInShader).SetArray(val, size); }
+
+		/**
+		 * @brief Resolves the location of a uniform. Do it once (e.g. when the shader is loaded or before a loop over draw calls) and keep the handle, instead of calling Uniform() with the name for every draw.
+		 * @return a handle to the uniform; invalid if the uniform is not active in the program.
+		*/
+		template <typename T>
+		[[nodiscard]] UniformHandle<T> GetHandle(const String& nameInShader) const { return UniformHandle<T>(FindLocation(nameInShader)); }
+		/**
+		 * @return the handle of the "boneIDOffset" uniform, resolved when the shader was loaded.
+		*/
+		[[nodiscard]] const UniformHandle<int>& GetBoneIDOffsetHandle() const { return BoneIDOffsetHandle; }
+		/**
+		 * @return the handles of the "lightIndex" and "lightProbeNr" uniforms set for every light and light probe volume (see RenderableVolume::SetupRenderUniforms()), resolved when the shader was loaded.
+		*/
+		[[nodiscard]] const UniformHandle<int>& GetLightIndexHandle() const { return LightIndexHandle; }
+		[[nodiscard]] const UniformHandle<float>& GetLightProbeNrHandle() const { return LightProbeNrHandle; }
+		/**
+		 * @return the handles of the material uniforms, resolved when the shader was loaded.
+		*/
+		[[nodiscard]] const MaterialUniformHandles& GetMaterialUniformHandles() const { return MaterialHandles; }
 
 		void UniformBlockBinding(const String&, unsigned int) const;
 		void UniformBlockBinding(unsigned int, unsigned int) const;
 
 		unsigned int GetUniformBlockIndex(const String&) const;
+
+		/**
+		 * @return true if the shader reads the properties of materials from the std140 "MaterialData" block instead of "material.*" uniforms.
+		*/
+		[[nodiscard]] bool UsesMaterialDataBlock() const { return bUsesMaterialDataBlock; }
+		/**
+		 * @return true if the shader reads per-instance material data (e.g. the atlas index) from the std140 "MaterialInstanceData" block.
+		*/
+		[[nodiscard]] bool UsesMaterialInstanceDataBlock() const { return bUsesMaterialInstanceDataBlock; }
 		void Use() const;
 		void BindMatrices(const Mat4f& model, const Mat4f* view, const Mat4f* projection, const Mat4f* VP);
 
@@ -81,6 +162,14 @@ namespace GEE
 	private:
 		static void DebugShader(unsigned int);
 		GLint FindLocation(const String&) const;
+		/**
+		 * @brief Checks which of the engine uniform blocks (see EngineUniformBlockSlot) are declared in the program and links them to their slots.
+		*/
+		void SetupEngineUniformBlocks();
+		/**
+		 * @brief Resolves the handles of the uniforms set by the engine for every draw (matrices, the bone ID offset, light volume indices and material uniforms).
+		*/
+		void ResolveEngineUniformHandles();
 
 		unsigned int Program;
 		String Name;
@@ -89,8 +178,18 @@ namespace GEE
 		bool ExpectedMatrices[MATRICES_NB];
 
 		std::function<void()> PreRenderFunc;
+		Shader* InstancedVariant;
+
+		bool bUsesMaterialDataBlock, bUsesMaterialInstanceDataBlock;
 
-		mutable std::unordered_map<String, GLenum> Locations;
+		std::array<UniformHandle<Mat4f>, MatrixType::NORMAL> MatrixHandles;	// all matrices but the normal matrix, indexed by MatrixType
+		UniformHandle<Mat3f> NormalMatrixHandle;
+		UniformHandle<int> BoneIDOffsetHandle;
+		UniformHandle<int> LightIndexHandle;
+		UniformHandle<float> LightProbeNrHandle;
+		MaterialUniformHandles MaterialHandles;
+
+		mutable std::unordered_map<String, GLint> Locations;
 		std::array<String, 3> ShadersSource;
 
 		std::function<void(Shader&, const Material&)> OnMaterialWholeDataUpdateFunc;
@@ -101,7 +200,12 @@ namespace GEE
 	struct ShaderLoader
 	{
 	private:
-		static unsigned int LoadShader(GLenum type, const String& path, String additionalData = String(), String* shaderSourcePtr = nullptr);
+		/**
+		 * @brief Reads the source of a shader and prepends the version directive and additionalData to it.
+		 * @return: A boolean indicating whether the file could be opened.
+		*/
+		static bool ReadShaderSource(const String& path, const String& additionalData, String& shaderSource);
+		static unsigned int CompileShader(GLenum type, const String& shaderSource, const String& path = String());
 		/**
 		 * @brief Debug a shader by logging any compilation errors, if such exist.
 		 * @param shaderID: The OpenGL id of the shader.
@@ -109,6 +213,11 @@ namespace GEE
 		 * @return: A boolean indicating whether compilation was successful.
 		*/
 		static bool DebugShader(unsigned int shaderID, const String& path = String());
+		/**
+		 * @brief Debug a program by logging any linking errors, if such exist.
+		 * @return: A boolean indicating whether linking was successful.
+		*/
+		static bool DebugProgram(unsigned int programID, const String& shaderName = String());
 
 	public:
 		static SharedPtr<Shader> LoadShaders(const String& shaderName, const String& vShaderPath, const String& fShaderPath, const String& gShaderPath = String());
@@ -0,0 +1,230 @@
+#include <rendering/ShaderBinaryCache.h>
+#include <utility/ScopeProfiler.h>
+#include <glfw/glfw3.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace GEE
+{
+	namespace
+	{
+		// ARB_get_program_binary (core since OpenGL 4.1); not loaded by our OpenGL 4.0 glad loader.
+		using GetProgramBinaryProc = void (APIENTRY*)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+		using ProgramBinaryProc = void (APIENTRY*)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+		using ProgramParameteriProc = void (APIENTRY*)(GLuint program, GLenum pname, GLint value);
+
+		GetProgramBinaryProc GetProgramBinary = nullptr;
+		ProgramBinaryProc ProgramBinary = nullptr;
+		ProgramParameteriProc ProgramParameteri = nullptr;
+
+		constexpr std::uint32_t BinaryFileMagic = 0x42454547;	// "GEEB"
+		constexpr std::uint32_t BinaryFileVersion = 1;
+
+		struct BinaryFileHeader
+		{
+			std::uint32_t Magic;
+			std::uint32_t Version;
+			std::uint64_t Key;
+			std::uint32_t Format;
+			std::uint32_t Length;
+		};
+
+		std::uint64_t HashFNV1a(const String& str, std::uint64_t hash)
+		{
+			for (unsigned char c : str)
+			{
+				hash ^= c;
+				hash *= 1099511628211ull;
+			}
+
+			// Separate consecutive strings, so ("ab", "c") and ("a", "bc") hash differently
+			hash ^= 0xFFu;
+			hash *= 1099511628211ull;
+
+			return hash;
+		}
+
+		String GetGLString(GLenum name)
+		{
+			const GLubyte* str = glGetString(name);
+			return (str) ? (String(reinterpret_cast<const char*>(str))) : (String());
+		}
+	}
+
+	ShaderBinaryCache::ShaderBinaryCache() :
+		bInitialized(false),
+		bSupported(false),
+		bEnabled(false)
+	{
+	}
+
+	ShaderBinaryCache& ShaderBinaryCache::Get()
+	{
+		static ShaderBinaryCache cache;
+		return cache;
+	}
+
+	void ShaderBinaryCache::Init(const String& directory)
+	{
+		if (bInitialized)
+			return;
+		bInitialized = true;
+		Directory = directory;
+
+		GetProgramBinary = reinterpret_cast<GetProgramBinaryProc>(glfwGetProcAddress("glGetProgramBinary"));
+		ProgramBinary = reinterpret_cast<ProgramBinaryProc>(glfwGetProcAddress("glProgramBinary"));
+		ProgramParameteri = reinterpret_cast<ProgramParameteriProc>(glfwGetProcAddress("glProgramParameteri"));
+
+		GLint formatCount = 0;
+		if (GetProgramBinary && ProgramBinary && ProgramParameteri)
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+		bSupported = bEnabled = (formatCount > 0);
+		if (!bSupported)
+		{
+			std::cout << "INFO: The driver does not support program binaries. Shaders will be compiled from source on every launch.\n";
+			return;
+		}
+
+		DriverIdentity = GetGLString(GL_VENDOR) + '\n' + GetGLString(GL_RENDERER) + '\n' + GetGLString(GL_VERSION);
+
+		std::error_code error;
+		std::filesystem::create_directories(Directory, error);
+		if (error)
+		{
+			std::cout << "ERROR: Cannot create the shader cache directory " << Directory << " (" << error.message() << "). The shader cache is disabled.\n";
+			bEnabled = false;
+		}
+	}
+
+	void ShaderBinaryCache::SetEnabled(bool enabled)
+	{
+		bEnabled = enabled && bSupported;
+	}
+
+	std::uint64_t ShaderBinaryCache::ComputeKey(const std::array<String, 3>& shadersSource) const
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+		hash = HashFNV1a(std::to_string(BinaryFileVersion), hash);
+		hash = HashFNV1a(DriverIdentity, hash);
+		for (const String& source : shadersSource)
+			hash = HashFNV1a(source, hash);
+
+		return hash;
+	}
+
+	bool ShaderBinaryCache::TryLoad(unsigned int program, std::uint64_t key)
+	{
+		if (!bEnabled)
+			return false;
+
+		const String path = GetBinaryPath(key);
+		std::ifstream file(path, std::ios::binary);
+		if (!file.good())
+			return false;	// not cached yet
+
+		BinaryFileHeader header{};
+		std::vector<char> binary;
+		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryFileHeader));
+
+		bool bValid = file.good() && header.Magic == BinaryFileMagic && header.Version == BinaryFileVersion && header.Key == key && header.Length > 0;
+		if (bValid)
+		{
+			binary.resize(header.Length);
+			file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+			bValid = file.good();
+		}
+		file.close();
+
+		if (bValid)
+		{
+			ProgramBinary(program, static_cast<GLenum>(header.Format), binary.data(), static_cast<GLsizei>(binary.size()));
+
+			GLint linkStatus = GL_FALSE;
+			glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+			if (linkStatus == GL_TRUE)
+				return true;
+		}
+
+		// The binary is truncated or the driver refused it (it may reject binaries at any time, e.g. after an update which did not change the version string).
+		CurrentStats.RejectedBinaries++;
+		GEE_PROFILE_COUNTER("Shader binaries rejected", CurrentStats.RejectedBinaries);
+		std::error_code error;
+		std::filesystem::remove(path, error);
+
+		return false;
+	}
+
+	void ShaderBinaryCache::PrepareForStore(unsigned int program) const
+	{
+		if (bEnabled)
+			ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	void ShaderBinaryCache::Store(unsigned int program, std::uint64_t key)
+	{
+		if (!bEnabled)
+			return;
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		std::vector<char> binary(static_cast<std::size_t>(length));
+		GLsizei writtenLength = 0;
+		GLenum format = 0;
+		GetProgramBinary(program, length, &writtenLength, &format, binary.data());
+		if (writtenLength <= 0)
+			return;
+
+		BinaryFileHeader header{};
+		header.Magic = BinaryFileMagic;
+		header.Version = BinaryFileVersion;
+		header.Key = key;
+		header.Format = static_cast<std::uint32_t>(format);
+		header.Length = static_cast<std::uint32_t>(writtenLength);
+
+		std::ofstream file(GetBinaryPath(key), std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryFileHeader));
+		file.write(binary.data(), writtenLength);
+
+		if (!file.good())
+			std::cout << "ERROR: Cannot write the shader binary " << GetBinaryPath(key) << ".\n";
+	}
+
+	void ShaderBinaryCache::RecordLoadedProgram(bool loadedFromCache, Time loadingTime)
+	{
+		if (loadedFromCache)
+		{
+			CurrentStats.LoadedFromCache++;
+			CurrentStats.CacheLoadingTime += loadingTime;
+		}
+		else
+		{
+			CurrentStats.CompiledFromSource++;
+			CurrentStats.CompilationTime += loadingTime;
+		}
+
+		GEE_PROFILE_COUNTER("Shader programs loaded from cache", CurrentStats.LoadedFromCache);
+		GEE_PROFILE_COUNTER("Shader programs compiled from source", CurrentStats.CompiledFromSource);
+	}
+
+	String ShaderBinaryCache::GetBinaryPath(std::uint64_t key) const
+	{
+		std::stringstream path;
+		path << Directory << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+		return path.str();
+	}
+}
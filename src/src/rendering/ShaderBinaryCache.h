@@ -0,0 +1,71 @@
+#pragma once
+#include <utility/Utility.h>
+#include <array>
+#include <cstdint>
+
+namespace GEE
+{
+	/**
+	 * @brief Disk cache of linked shader program binaries (glGetProgramBinary/glProgramBinary).
+	 * A binary is keyed by a hash of the complete source of every stage (which already contains the defines passed to ShaderLoader) and of the vendor, renderer and version strings of the driver, so a driver update or a change of any source or setting makes ShaderLoader compile the program from source again.
+	 * The program binary entry points are not a part of OpenGL 4.0, so they are loaded at runtime. If the driver does not expose them, the cache stays disabled.
+	*/
+	class ShaderBinaryCache
+	{
+	public:
+		/**
+		 * @brief Counters of the programs loaded by ShaderLoader.
+		*/
+		struct Stats
+		{
+			unsigned int LoadedFromCache = 0;	// warm loads
+			unsigned int CompiledFromSource = 0;	// cold loads
+			unsigned int RejectedBinaries = 0;	// cached binaries which the driver refused to load
+			Time CacheLoadingTime = 0.0;
+			Time CompilationTime = 0.0;
+		};
+
+		static ShaderBinaryCache& Get();
+
+		/**
+		 * @brief Must be called with a current OpenGL context. Does nothing if the cache has already been initialized.
+		*/
+		void Init(const String& directory = "ShaderCache/");
+		[[nodiscard]] bool IsEnabled() const { return bEnabled; }
+		/**
+		 * @brief Allows to force compiling every program from source (e.g. while working on shaders). The cache cannot be enabled if the driver does not support program binaries.
+		*/
+		void SetEnabled(bool enabled);
+
+		[[nodiscard]] std::uint64_t ComputeKey(const std::array<String, 3>& shadersSource) const;
+		/**
+		 * @brief Loads the cached binary of the program with the passed key, if there is any.
+		 * @return true if the program has been loaded and linked successfully. If false is returned, the program should be compiled from source; a stale binary is removed from the disk.
+		*/
+		bool TryLoad(unsigned int program, std::uint64_t key);
+		/**
+		 * @brief Must be called before linking a program which will be passed to Store().
+		*/
+		void PrepareForStore(unsigned int program) const;
+		/**
+		 * @brief Saves the binary of a successfully linked program.
+		*/
+		void Store(unsigned int program, std::uint64_t key);
+
+		/**
+		 * @brief Updates the stats and records the counters of warm (cached) and cold (compiled) loads to ScopeProfiler, so they show up in the trace next to the scopes of the loading stages.
+		*/
+		void RecordLoadedProgram(bool loadedFromCache, Time loadingTime);
+		[[nodiscard]] const Stats& GetStats() const { return CurrentStats; }
+
+	private:
+		ShaderBinaryCache();
+		String GetBinaryPath(std::uint64_t key) const;
+
+		bool bInitialized, bSupported, bEnabled;
+		String Directory;
+		String DriverIdentity;	// vendor, renderer and version of the driver
+
+		Stats CurrentStats;
+	};
+}
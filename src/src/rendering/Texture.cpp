@@ -1,5 +1,8 @@
 #include <rendering/Texture.h>
+#include <rendering/GpuProfiler.h>
+#include <game/GameManager.h>
 #include <stb_image.h>
+#include <algorithm>
 #include <iostream>
 #include <assimp/texture.h>
 
@@ -35,6 +38,7 @@ namespace GEE
 		if (texSlot >= 0)
 			glActiveTexture(GL_TEXTURE0 + texSlot);
 		glBindTexture(Type, ID);
+		GpuProfiler::CountTextureBind();
 	}
 
 	GLenum Texture::GetType() const
@@ -79,6 +83,9 @@ namespace GEE
 
 	void Texture::SetWrap(GLenum wrapS, GLenum wrapT, GLenum wrapR, bool isAlreadyBound)
 	{
+		if (!HasBeenGenerated())	// e.g. textures of headless games
+			return;
+
 		if (!isAlreadyBound) Bind();
 		
 		if (wrapS != 0) glTexParameteri(GetType(), GL_TEXTURE_WRAP_S, wrapS);
@@ -88,17 +95,26 @@ namespace GEE
 
 	void Texture::SetBorderColor(const Vec4f& color)
 	{
+		if (!HasBeenGenerated())
+			return;
+
 		glTexParameterfv(Type, GL_TEXTURE_BORDER_COLOR, Math::GetDataPtr(color));
 	}
 
 	void Texture::GenerateMipmap(bool isAlreadyBound)
 	{
+		if (!HasBeenGenerated())
+			return;
+
 		if (!isAlreadyBound) Bind();
 		glGenerateMipmap(Type);
 	}
 
 	void Texture::SetMinFilter(MinFilter minFilter, bool isAlreadyBound, bool generateMipmapIfPossible)
 	{
+		if (!HasBeenGenerated())
+			return;
+
 		if (!isAlreadyBound) Bind();
 		glTexParameteri(Type, GL_TEXTURE_MIN_FILTER, Impl::GetTextureFilterGL(minFilter.Filter));
 
@@ -116,6 +132,9 @@ namespace GEE
 
 	void Texture::SetMagFilter(MagFilter magFilter, bool isAlreadyBound)
 	{
+		if (!HasBeenGenerated())
+			return;
+
 		glTexParameteri(Type, GL_TEXTURE_MAG_FILTER, Impl::GetTextureFilterGL(magFilter.Filter));
 	}
 
@@ -147,8 +166,18 @@ namespace GEE
 	template <typename PixelChannelType>
 	Texture Texture::Loader<PixelChannelType>::FromFile2D(const std::string& filepath, Format internalFormat, bool flip, MinFilter minFilter, MagFilter magFilter)
 	{
-		if (flip)
-			stbi_set_flip_vertically_on_load(true);
+		return FromDecoded2D(DecodeFile2D(filepath, flip), internalFormat, minFilter, magFilter);
+	}
+
+	template <typename PixelChannelType>
+	Texture::DecodedImage Texture::Loader<PixelChannelType>::DecodeFile2D(const std::string& filepath, bool flip)
+	{
+		DecodedImage image;
+		image.Path = filepath;
+
+		// Headless games do not create textures, so the pixels would never be used.
+		if (GameManager::IsHeadless())
+			return image;
 
 		int width = 0, height = 0, nrChannels = 0;
 		void* data = nullptr;
@@ -166,22 +195,50 @@ namespace GEE
 			std::cerr << "Can't load texture from " << filepath << '\n';
 			if (stbi_failure_reason())
 				std::cout << "Stbi failure: " << stbi_failure_reason() << "\n";
+			return image;
+		}
+
+		// Flipped here instead of with stbi_set_flip_vertically_on_load(), which changes a global setting that worker threads decoding other images would see.
+		if (flip)
+		{
+			const std::size_t rowSize = static_cast<std::size_t>(width) * static_cast<std::size_t>(nrChannels) * sizeof(PixelChannelType);
+			unsigned char* pixelBytes = static_cast<unsigned char*>(data);
+			for (int row = 0; row < height / 2; row++)
+				std::swap_ranges(pixelBytes + row * rowSize, pixelBytes + (row + 1) * rowSize, pixelBytes + (height - 1 - row) * rowSize);
+		}
+
+		image.Size = Vec2u(width, height);
+		image.ChannelCount = nrChannels;
+		image.Pixels = std::shared_ptr<void>(data, [](void* pixels) { stbi_image_free(pixels); });
+
+		return image;
+	}
+
+	template <typename PixelChannelType>
+	Texture Texture::Loader<PixelChannelType>::FromDecoded2D(const DecodedImage& image, Format internalFormat, MinFilter minFilter, MagFilter magFilter)
+	{
+		if (GameManager::IsHeadless())
+		{
+			// There is no OpenGL context. Keep the path and format, so the texture is still saved correctly.
+			Texture tex;
+			tex.SetPath(image.Path);
+			tex.InternalFormat = internalFormat;
+			return tex;
+		}
+
+		if (!image.IsValid())
+		{
 			Texture tex = Texture::Loader<float>::FromBuffer2D(Vec2u(1, 1), Math::GetDataPtr(Vec3f(1.0f, 0.0f, 1.0f)), Format::RGB(), 3);	//set the texture's color to pink so its obvious that this texture is missing
 			tex.SetMinFilter(MinFilter::Nearest(), true, true);	//disable mipmaps
 			return tex;
 		}
 
-		Texture tex = FromBuffer2D(Vec2u(width, height), data, internalFormat, nrChannels);
-		tex.SetPath(filepath);
+		Texture tex = FromBuffer2D(image.Size, image.Pixels.get(), internalFormat, image.ChannelCount);
+		tex.SetPath(image.Path);
 
 		tex.SetMinFilter(minFilter, true, true);
 		tex.SetMagFilter(magFilter, true);
 
-		if (flip)
-			stbi_set_flip_vertically_on_load(false);
-
-		stbi_image_free(data);
-
 		return tex;
 	}
 
@@ -345,6 +402,9 @@ namespace GEE
 	template <typename PixelChannelType>
 	Texture Texture::Loader<PixelChannelType>::Assimp::FromAssimpEmbedded(const aiTexture& assimpTex, bool sRGB, MinFilter minFilter, MagFilter magFilter)
 	{
+		if (GameManager::IsHeadless())
+			return Texture();
+
 		Texture tex = FromBuffer2D(assimpTex.mWidth, &assimpTex.pcData[0].b, (sRGB) ? (Format::SRGBA()) : (Format::RGBA()));
 		tex.SetMinFilter(minFilter, true, true);
 		tex.SetMagFilter(magFilter, true);
@@ -5,6 +5,7 @@
 #include <utility/CerealNames.h>
 #include <cereal/access.hpp>
 #include <array>
+#include <memory>
 
 #include "utility/Asserts.h"
 
@@ -87,10 +88,32 @@ namespace GEE
 		{
 			struct Uint24_8 {};
 		};
+		/**
+		 * @brief Pixels of an image file decoded on the CPU, which have not been uploaded to the GPU yet. See Loader::DecodeFile2D().
+		*/
+		struct DecodedImage
+		{
+			std::string Path;
+			Vec2u Size = Vec2u(0);
+			int ChannelCount = 0;
+			std::shared_ptr<void> Pixels;
+
+			bool IsValid() const { return Pixels != nullptr; }
+		};
 		template <typename PixelChannelType = unsigned char>
 		struct Loader
 		{
 			static Texture FromFile2D(const std::string&, Format internalFormat = Format::RGBA(), bool flip = false, MinFilter = MinFilter::Trilinear(), MagFilter = MagFilter::Bilinear());
+			/**
+			 * @brief Decodes an image file without touching OpenGL or any global setting of stb_image, so it can be called by any thread.
+			 * @param flip: pass true to flip the image vertically
+			 * @return the decoded image. It is invalid if the file could not be decoded, and in headless games, which do not decode images at all.
+			*/
+			static DecodedImage DecodeFile2D(const std::string&, bool flip = false);
+			/**
+			 * @brief Uploads a decoded image. If the image is invalid, a pink placeholder texture is returned (just like FromFile2D() does for files that cannot be loaded). Headless games get a texture which only has a path.
+			*/
+			static Texture FromDecoded2D(const DecodedImage&, Format internalFormat = Format::RGBA(), MinFilter = MinFilter::Trilinear(), MagFilter = MagFilter::Bilinear());
 			//static Texture FromFileEquirectangularCubemap(const std::string&);
 
 			static Texture FromBuffer2D(unsigned int width, const void* buffer, Format internalFormat = Format::RGBA(), int desiredChannels = 0);
@@ -23,6 +23,7 @@ namespace GEE
 		SetupStream(nullptr),
 		ActorGEEID(IDSystem<Actor>::GenerateID())
 	{
+		Scene.GetComponentRegistry().RegisterActor(*this);
 		RootComponent = MakeUnique<Component>(*this, nullptr, Name + "'s root", t);
 	}
 
@@ -48,6 +49,8 @@ namespace GEE
 		KillingProcessFrame(moved.KillingProcessFrame)
 	{
 		std::cout << "UWAGA: MOVE CONSTRUCTOR NIE DZIALA. (" + Name + ") (" + Scene.GetName() + ")\n";
+		if (!IsBeingKilled())
+			Scene.GetComponentRegistry().RegisterActor(*this);
 		RootComponent = MakeUnique<Component>(*this, nullptr, Name + "'s root", Transform());
 		//exit(-1);
 	}
@@ -210,9 +213,26 @@ namespace GEE
 			Children[i]->UpdateAll(dt);
 	}
 
+	void Actor::CollectParallelUpdateRoots(ComponentUpdatePhase phase, std::vector<Component*>& roots)
+	{
+		if (IsBeingKilled())
+			return;
+
+		RootComponent->CollectParallelUpdateRoots(phase, roots);
+		for (auto& it : Children)
+			it->CollectParallelUpdateRoots(phase, roots);
+	}
+
 	void Actor::MarkAsKilled()
 	{
+		if (Scene.IsInParallelUpdate())
+		{
+			Scene.DeferStructuralChange([this]() { MarkAsKilled(); });
+			return;
+		}
+
 		KillingProcessFrame = GameHandle->GetTotalFrameCount();
+		Scene.GetComponentRegistry().UnregisterActor(*this);
 		if (!RootComponent->IsBeingKilled())	//Check if the root is not being killed to avoid infinite recursion (killing the root kills the actor which kills the root which kills the actor...)
 			RootComponent->MarkAsKilled();
 
@@ -237,6 +257,11 @@ namespace GEE
 			ParentActor->Children.erase(std::remove_if(ParentActor->Children.begin(), ParentActor->Children.end(), [this](UniquePtr<Actor>& child) { return child.get() == this; }), ParentActor->Children.end());
 	}
 
+	Actor::~Actor()
+	{
+		Scene.GetComponentRegistry().UnregisterActor(*this);
+	}
+
 	void Actor::DebugRender(SceneMatrixInfo info, Shader* shader) const
 	{
 		RootComponent->DebugRenderAll(info, *shader);
@@ -264,13 +289,12 @@ namespace GEE
 
 	Actor* Actor::FindActor(GEEID geeid)
 	{
-		if (ActorGEEID == geeid)
-			return this;
+		Actor* found = Scene.GetComponentRegistry().FindActor(geeid);
 
-		for (int i = 0; i < static_cast<int>(Children.size()); i++)
-			if (Actor* found = Children[i]->FindActor(geeid))
-				if (!found->IsBeingKilled())
-					return found;
+		// Check if the found Actor is this one or one of its descendants
+		for (const Actor* ancestor = found; ancestor; ancestor = ancestor->ParentActor)
+			if (ancestor == this)
+				return found;
 
 		return nullptr;
 	}
@@ -321,7 +345,9 @@ namespace GEE
 		CerealComponentSerializationData::ActorRef = this;	//For constructing the root component and its children
 		CerealComponentSerializationData::ParentComp = nullptr;	//The root component doesn't have a parent
 		RootComponent = nullptr;
+		const GEEID previousGEEID = ActorGEEID;
 		archive(CEREAL_NVP(Name), CEREAL_NVP(ActorGEEID), CEREAL_NVP(RootComponent));
+		Scene.GetComponentRegistry().OnActorGEEIDChanged(*this, previousGEEID);
 		std::cout << "Serializing actor " << Name << '\n';
 
 		if (Scene.HasStarted())
@@ -339,4 +365,6 @@ namespace GEE
 
 	template void Actor::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void Actor::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void Actor::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void Actor::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 }
\ No newline at end of file
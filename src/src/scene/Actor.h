@@ -4,7 +4,7 @@
 #include <math/Transform.h>
 #include <input/Event.h>
 #include <utility/CerealNames.h>
-#include <cereal/archives/json.hpp>
+#include <utility/CerealArchives.h>
 #include <cereal/types/polymorphic.hpp>
 
 namespace GEE
@@ -86,6 +86,10 @@ namespace GEE
 
 		virtual void Update(Time dt);
 		void UpdateAll(Time dt);
+		/**
+		 * @brief See Component::CollectParallelUpdateRoots. Note that Components updated in a parallel phase are updated even if Update() of their Actor is overridden to skip them.
+		*/
+		void CollectParallelUpdateRoots(ComponentUpdatePhase phase, std::vector<Component*>& roots);
 
 		void MarkAsKilled();
 
@@ -95,6 +99,9 @@ namespace GEE
 		void DebugRenderAll(SceneMatrixInfo info, Shader* shader) const;
 
 		Actor* FindActor(const std::string& name);
+		/**
+		 * @brief Finds this Actor or one of its descendants by GEEID. O(depth of the found Actor) - uses the ComponentRegistry of the scene. Killed Actors are not found.
+		*/
 		Actor* FindActor(GEEID);
 		const Actor* FindActor(const std::string& name) const
 		{
@@ -128,7 +135,7 @@ namespace GEE
 		template <typename Archive> void Save(Archive& archive) const;
 		template <typename Archive> void Load(Archive& archive);
 
-		virtual ~Actor() = default;
+		virtual ~Actor();
 
 	protected:
 		std::string Name;
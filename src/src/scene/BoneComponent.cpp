@@ -118,5 +118,12 @@ namespace GEE
 		return it->second;
 	}
 
+	std::vector<String> BoneMapping::GetBoneNames() const
+	{
+		std::vector<String> names(Mapping.size());
+		for (const auto& it : Mapping)
+			names[it.second] = it.first;
 
+		return names;
+	}
 }
\ No newline at end of file
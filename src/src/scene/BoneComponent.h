@@ -34,6 +34,7 @@ namespace GEE
 		BoneComponent& operator=(BoneComponent&&) = delete;	//TODO: de-delete this, it should be written but i am too lazy
 
 		void Update(Time dt) override;
+		ComponentUpdatePhase GetUpdatePhase() const override { return ComponentUpdatePhase::Pose; }
 		unsigned int GetID() const;
 		const Mat4f& GetFinalMatrix();
 
@@ -63,6 +64,10 @@ namespace GEE
 	public:
 		unsigned int GetBoneID(const String& name);
 		unsigned int GetBoneID(const String& name) const;
+		/**
+		 * @return the names of all mapped bones, ordered by their IDs.
+		*/
+		std::vector<String> GetBoneNames() const;
 	};
 
 	aiBone* FindAiBoneFromNode(const aiScene*, const aiNode*);
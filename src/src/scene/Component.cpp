@@ -39,6 +39,7 @@ namespace GEE
 		DebugRenderLastFrameMVP(Mat4f(1.0f)),
 		KillingProcessFrame(0)
 	{
+		Scene.GetComponentRegistry().RegisterComponent(*this);
 	}
 
 	Component::Component(Component&& comp) :
@@ -56,12 +57,16 @@ namespace GEE
 		KillingProcessFrame(comp.KillingProcessFrame)
 	{
 		std::cout << "Komponentowy move...\n";
+		if (!IsBeingKilled())
+			Scene.GetComponentRegistry().RegisterComponent(*this);
 	}
 
 	Component& Component::operator=(Component&& comp)
 	{
+		const GEEID previousGEEID = ComponentGEEID;
 		Name = comp.Name;
 		ComponentGEEID = comp.ComponentGEEID;
+		Scene.GetComponentRegistry().OnComponentGEEIDChanged(*this, previousGEEID);
 		ComponentTransform = comp.ComponentTransform;
 		Children = std::move(comp.Children);
 		CollisionObj = std::move(comp.CollisionObj);
@@ -72,8 +77,10 @@ namespace GEE
 
 	Component& Component::operator=(const Component& compT)
 	{
+		const GEEID previousGEEID = ComponentGEEID;
 		Name = compT.Name;
 		ComponentGEEID = IDSystem<Component>::GenerateID();
+		Scene.GetComponentRegistry().OnComponentGEEIDChanged(*this, previousGEEID);
 		ComponentTransform *= compT.ComponentTransform;
 		SetCollisionObject((compT.CollisionObj) ? (MakeUnique<Physics::CollisionObject>(*compT.CollisionObj)) : (nullptr));
 		DebugRenderMat = compT.DebugRenderMat;
@@ -214,6 +221,23 @@ namespace GEE
 		return nullptr;
 	}
 
+	std::unique_lock<std::recursive_mutex> Component::LockSceneStructure() const
+	{
+		return Scene.LockStructureDuringParallelUpdate();
+	}
+
+	Component* Component::FindComponentInHierarchy(GEEID geeid)
+	{
+		Component* found = Scene.GetComponentRegistry().FindComponent(geeid);
+
+		// Check if the found Component is this one or one of its descendants
+		for (Component* ancestor = found; ancestor; ancestor = ancestor->ParentComponent)
+			if (ancestor == this)
+				return found;
+
+		return nullptr;
+	}
+
 	void Component::MoveChildren(Component& comp)
 	{
 		std::for_each(Children.begin(), Children.end(), [&comp](UniquePtr<Component>& child) { comp.AddComponent(std::move(child)); });
@@ -251,6 +275,16 @@ namespace GEE
 
 	Component& Component::AddComponent(UniquePtr<Component> component)
 	{
+		if (Scene.IsInParallelUpdate())
+		{
+			// The returned Component would not be attached yet, so it could not be used like one added outside of a parallel phase.
+			GEE_CORE_ASSERT(false, "Components must not be added during a parallel update phase. Use GameScene::DeferStructuralChange() instead.");
+			std::cout << "ERROR: Component " << component->GetName() << " added to " << Name << " during a parallel update phase. It will be attached after the phase.\n";
+			Component& addedComponent = *component;
+			Scene.DeferAddComponent(*this, std::move(component));
+			return addedComponent;
+		}
+
 		component->GetTransform().SetParentTransform(&this->ComponentTransform);
 		component->ParentComponent = this;
 		Children.push_back(std::move(component));
@@ -275,7 +309,9 @@ namespace GEE
 
 	void Component::UpdateAll(Time dt)
 	{
-		Update(dt);
+		// Components updated in a parallel phase have already been updated this frame
+		if (!Scene.UsesParallelUpdate() || GetUpdatePhase() == ComponentUpdatePhase::Serial)
+			Update(dt);
 		for (int i = 0; i < static_cast<int>(Children.size()); i++)
 			Children[i]->UpdateAll(dt);
 
@@ -286,6 +322,40 @@ namespace GEE
 		}
 	}
 
+	void Component::CollectParallelUpdateRoots(ComponentUpdatePhase phase, std::vector<Component*>& roots)
+	{
+		if (IsBeingKilled())
+			return;
+
+		if (GetUpdatePhase() == phase)
+		{
+			roots.push_back(this);
+			return;
+		}
+
+		for (auto& it : Children)
+			it->CollectParallelUpdateRoots(phase, roots);
+	}
+
+	void Component::CollectParallelUpdateExternalSubtrees(ComponentUpdatePhase phase, std::vector<Component*>& subtrees) const
+	{
+		if (GetUpdatePhase() == phase)
+			if (Component* subtree = GetParallelUpdateExternalSubtree())
+				subtrees.push_back(subtree);
+
+		for (auto& it : Children)
+			it->CollectParallelUpdateExternalSubtrees(phase, subtrees);
+	}
+
+	void Component::UpdateAllInPhase(ComponentUpdatePhase phase, Time dt)
+	{
+		if (GetUpdatePhase() == phase)
+			Update(dt);
+
+		for (auto& it : Children)
+			it->UpdateAllInPhase(phase, dt);
+	}
+
 	void Component::HandleEventAll(const Event& ev)
 	{
 		HandleEvent(ev);
@@ -605,7 +675,14 @@ namespace GEE
 
 	void Component::MarkAsKilled()
 	{
+		if (Scene.IsInParallelUpdate())
+		{
+			Scene.DeferStructuralChange([this]() { MarkAsKilled(); });
+			return;
+		}
+
 		KillingProcessFrame = GameHandle->GetTotalFrameCount();
+		Scene.GetComponentRegistry().UnregisterComponent(*this);
 		if (CollisionObj && CollisionObj->ActorPtr && Scene.GetPhysicsData())
 			Scene.GetPhysicsData()->EraseCollisionObject(*CollisionObj);
 
@@ -639,7 +716,9 @@ namespace GEE
 	template<typename Archive>
 	void Component::Load(Archive& archive)
 	{
+		const GEEID previousGEEID = ComponentGEEID;
 		archive(CEREAL_NVP(Name), CEREAL_NVP(ComponentGEEID), CEREAL_NVP(ComponentTransform), CEREAL_NVP(CollisionObj));
+		Scene.GetComponentRegistry().OnComponentGEEIDChanged(*this, previousGEEID);
 		if (CollisionObj)
 			Scene.GetPhysicsData()->AddCollisionObject(*CollisionObj, ComponentTransform);
 
@@ -664,6 +743,7 @@ namespace GEE
 
 	Component::~Component()
 	{
+		Scene.GetComponentRegistry().UnregisterComponent(*this);
 		//std::cout << "Erasing component " << Name << " " << this << ".\n";
 		if (ComponentTransform.GetParentTransform())
 			ComponentTransform.GetParentTransform()->RemoveChild(&ComponentTransform);
@@ -673,4 +753,6 @@ namespace GEE
 
 	template void Component::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void Component::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void Component::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void Component::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 }
\ No newline at end of file
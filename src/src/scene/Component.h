@@ -7,6 +7,7 @@
 #include <editor/EditorManager.h>
 #include <physics/CollisionObject.h>
 #include <rendering/Material.h>
+#include <mutex>
 
 namespace GEE
 {
@@ -37,6 +38,20 @@ namespace GEE
 
 	};
 
+	/**
+	 * @brief The phase of the phased scene update (see GameScene::SetUseParallelUpdate) in which a Component is updated. Phases are executed in the order of declaration.
+	 * A Component updated in a parallel phase runs concurrently with other Components of the same phase that are not its descendants or ancestors. It may modify only itself and its own subtree
+	 * (or the subtree returned by Component::GetParallelUpdateExternalSubtree()) and must not read the state of other Components, apart from the world transforms of its ancestors.
+	 * It must not add Components either; changes of the hierarchy have to be queued with GameScene::DeferStructuralChange().
+	 * Subtrees which would be modified by more than one thread (e.g. a skeleton animated by two AnimationManagerComponents) are updated one after another on the main thread instead.
+	*/
+	enum class ComponentUpdatePhase
+	{
+		Animation,	// parallel; Components that animate transforms
+		Pose,	// parallel; Components that compute their state from the (already animated) transforms
+		Serial	// updated on the main thread, in hierarchy order
+	};
+
 	class ComponentBase
 	{
 	public:
@@ -90,7 +105,7 @@ namespace GEE
 		template <class CompClass = Component> CompClass* GetComponent(const String& name);
 
 		/**
-		 * @brief Find by GEEID and get a pointer of type CompClass to a Component further in the hierarchy (kids, kids' kids, ...). Limit the use of this function at runtime, as dynamic_cast has a significant overhead.
+		 * @brief Find by GEEID and get a pointer of type CompClass to a Component further in the hierarchy (kids, kids' kids, ...). The Component is found in O(1) using the ComponentRegistry of the scene; killed Components are not found.
 		 * @tparam CompClass: The sought Component must be dynamic_castable to CompClass.
 		 * @param name: The GEEID of the sought Component.
 		 * @return: A pointer to the sought Component.
@@ -98,7 +113,7 @@ namespace GEE
 		template <class CompClass = Component> CompClass* GetComponent(GEEID geeid);
 
 		/**
-		 * @brief This function returns every element further in the hierarchy that is of CompClass type
+		 * @brief This function returns every element further in the hierarchy that is of CompClass type. To get all Components of a type in the whole scene, use GameScene::GetComponents instead.
 		*/
 		template<class CompClass> void GetAllComponents(std::vector <CompClass*>* comps);
 		/**
@@ -112,6 +127,9 @@ namespace GEE
 		void SetName(const String& name);
 		virtual void SetTransform(const Transform& transform);
 		Physics::CollisionObject* SetCollisionObject(UniquePtr<Physics::CollisionObject>);
+		/**
+		 * @brief Attaches the passed Component to this one. Must not be called during a parallel phase of the scene update; queue the whole change with GameScene::DeferStructuralChange() instead.
+		*/
 		Component& AddComponent(UniquePtr<Component> component) override;
 		void AddComponents(std::vector<UniquePtr<Component>> components);
 
@@ -121,6 +139,28 @@ namespace GEE
 		virtual void Update(Time dt);
 		void UpdateAll(Time dt);
 
+		/**
+		 * @brief Override this method to update the Component in a parallel phase, if its Update() meets the requirements described in ComponentUpdatePhase. Ignored if the phased update of the scene is disabled.
+		*/
+		virtual ComponentUpdatePhase GetUpdatePhase() const { return ComponentUpdatePhase::Serial; }
+		/**
+		 * @brief Override this method if Update() in a parallel phase also modifies Components outside of the subtree of this Component.
+		 * @return the root of the subtree modified by this Component outside of its own subtree or nullptr if there is none.
+		*/
+		virtual Component* GetParallelUpdateExternalSubtree() const { return nullptr; }
+		/**
+		 * @brief Finds the topmost Components in this subtree that are updated in the passed phase. Each of them is updated along with its subtree by a single thread.
+		*/
+		void CollectParallelUpdateRoots(ComponentUpdatePhase phase, std::vector<Component*>& roots);
+		/**
+		 * @brief Finds the subtrees outside of this one, which are modified by the Components in this subtree updated in the passed phase (see GetParallelUpdateExternalSubtree()).
+		*/
+		void CollectParallelUpdateExternalSubtrees(ComponentUpdatePhase phase, std::vector<Component*>& subtrees) const;
+		/**
+		 * @brief Updates the Components in this subtree (including this one) that are updated in the passed phase.
+		*/
+		void UpdateAllInPhase(ComponentUpdatePhase phase, Time dt);
+
 		virtual void HandleEvent(const Event& ev) {}
 		void HandleEventAll(const Event& ev);
 
@@ -153,6 +193,8 @@ namespace GEE
 		UniquePtr<Component> DetachChild(Component& soughtChild);	//Find child in hierarchy and detach it from its parent
 		void MoveChildren(Component& moveTo);
 		void Delete();
+		std::unique_lock<std::recursive_mutex> LockSceneStructure() const;
+		Component* FindComponentInHierarchy(GEEID geeid);
 
 		String Name;
 		GEEID ComponentGEEID;
@@ -187,7 +229,12 @@ namespace GEE
 	template<typename ChildClass, typename... Args>
 	ChildClass& Component::CreateComponent(Args&&... args)
 	{
-		UniquePtr<ChildClass> createdChild = MakeUnique<ChildClass>(ActorRef, this, std::forward<Args>(args)...);
+		UniquePtr<ChildClass> createdChild;
+		{
+			// Constructors may register the Component in scene-wide containers, so they must not run concurrently during a parallel update phase.
+			auto lock = LockSceneStructure();
+			createdChild = MakeUnique<ChildClass>(ActorRef, this, std::forward<Args>(args)...);
+		}
 		ChildClass& childRef = *createdChild;
 		AddComponent(std::move(createdChild));
 
@@ -209,14 +256,7 @@ namespace GEE
 	template<class CompClass>
 	CompClass* Component::GetComponent(GEEID geeid)
 	{
-		if (ComponentGEEID == geeid)
-			return dynamic_cast<CompClass*>(this);
-
-		for (const auto& it : Children)
-			if (auto found = it->GetComponent<CompClass>(geeid))
-				return found;
-
-		return nullptr;
+		return dynamic_cast<CompClass*>(FindComponentInHierarchy(geeid));
 	}
 	template<class CompClass>
 	void Component::GetAllComponents(std::vector<CompClass*>* comps)
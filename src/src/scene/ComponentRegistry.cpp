@@ -0,0 +1,122 @@
+#include <scene/ComponentRegistry.h>
+#include <scene/Actor.h>
+
+namespace GEE
+{
+	ComponentRegistry::ComponentRegistry() :
+		Version(1)
+	{
+	}
+
+	void ComponentRegistry::RegisterComponent(Component& comp)
+	{
+		if (Locations.find(&comp) != Locations.end())
+			return;
+
+		Locations[&comp] = Location{ PendingBucketIndex, static_cast<unsigned int>(PendingComponents.size()) };
+		PendingComponents.push_back(&comp);
+		ComponentsByGEEID[comp.GetGEEID()] = &comp;
+	}
+
+	void ComponentRegistry::UnregisterComponent(Component& comp)
+	{
+		auto found = Locations.find(&comp);
+		if (found == Locations.end())
+			return;
+
+		const Location location = found->second;
+		Locations.erase(found);
+		if (location.BucketIndex == PendingBucketIndex)
+			RemoveFromVector(PendingComponents, location.Index, PendingBucketIndex);
+		else
+		{
+			RemoveFromVector(Buckets[location.BucketIndex].Components, location.Index, location.BucketIndex);
+			Version++;
+		}
+
+		// Another Component might have taken over the GEEID (e.g. the one it was moved to)
+		auto foundID = ComponentsByGEEID.find(comp.GetGEEID());
+		if (foundID != ComponentsByGEEID.end() && foundID->second == &comp)
+			ComponentsByGEEID.erase(foundID);
+	}
+
+	void ComponentRegistry::OnComponentGEEIDChanged(Component& comp, GEEID previousGEEID)
+	{
+		if (Locations.find(&comp) == Locations.end() || comp.GetGEEID() == previousGEEID)
+			return;
+
+		auto foundID = ComponentsByGEEID.find(previousGEEID);
+		if (foundID != ComponentsByGEEID.end() && foundID->second == &comp)
+			ComponentsByGEEID.erase(foundID);
+		ComponentsByGEEID[comp.GetGEEID()] = &comp;
+	}
+
+	void ComponentRegistry::RegisterActor(Actor& actor)
+	{
+		ActorsByGEEID[actor.GetGEEID()] = &actor;
+	}
+
+	void ComponentRegistry::UnregisterActor(Actor& actor)
+	{
+		auto found = ActorsByGEEID.find(actor.GetGEEID());
+		if (found != ActorsByGEEID.end() && found->second == &actor)
+			ActorsByGEEID.erase(found);
+	}
+
+	void ComponentRegistry::OnActorGEEIDChanged(Actor& actor, GEEID previousGEEID)
+	{
+		auto found = ActorsByGEEID.find(previousGEEID);
+		if (found == ActorsByGEEID.end() || found->second != &actor)
+			return;
+
+		ActorsByGEEID.erase(found);
+		ActorsByGEEID[actor.GetGEEID()] = &actor;
+	}
+
+	Component* ComponentRegistry::FindComponent(GEEID geeid) const
+	{
+		auto found = ComponentsByGEEID.find(geeid);
+		return (found != ComponentsByGEEID.end()) ? (found->second) : (nullptr);
+	}
+
+	Actor* ComponentRegistry::FindActor(GEEID geeid) const
+	{
+		auto found = ActorsByGEEID.find(geeid);
+		return (found != ActorsByGEEID.end()) ? (found->second) : (nullptr);
+	}
+
+	void ComponentRegistry::ResolvePendingComponents()
+	{
+		if (PendingComponents.empty())
+			return;
+
+		for (Component* comp : PendingComponents)
+		{
+			const std::type_index type(typeid(*comp));
+			auto foundBucket = BucketIndices.find(type);
+			if (foundBucket == BucketIndices.end())
+			{
+				foundBucket = BucketIndices.emplace(type, static_cast<unsigned int>(Buckets.size())).first;
+				Buckets.push_back(TypeBucket());
+			}
+
+			std::vector<Component*>& bucketComponents = Buckets[foundBucket->second].Components;
+			Locations[comp] = Location{ foundBucket->second, static_cast<unsigned int>(bucketComponents.size()) };
+			bucketComponents.push_back(comp);
+		}
+
+		PendingComponents.clear();
+		Version++;
+	}
+
+	void ComponentRegistry::RemoveFromVector(std::vector<Component*>& vec, unsigned int index, unsigned int bucketIndex)
+	{
+		// Swap with the last element, so the removal is O(1)
+		if (index != vec.size() - 1)
+		{
+			vec[index] = vec.back();
+			Locations[vec[index]] = Location{ bucketIndex, index };
+		}
+		vec.pop_back();
+	}
+}
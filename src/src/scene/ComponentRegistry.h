@@ -0,0 +1,128 @@
+#pragma once
+#include <utility/Utility.h>
+#include <limits>
+#include <typeindex>
+#include <type_traits>
+#include <unordered_map>
+
+namespace GEE
+{
+	class Actor;
+	class Component;
+
+	/**
+	 * @brief Index of the live (not killed) Actors and Components of a GameScene, by GEEID and by the concrete type of the Component.
+	 * Components register themselves when they are constructed and unregister when they are killed or destroyed. Their concrete type is not known until their construction finishes, so it is resolved on the next typed query.
+	 * Not thread-safe: during parallel update phases it is only modified under the scene's structure lock (see GameScene::LockStructureDuringParallelUpdate) and must not be queried.
+	*/
+	class ComponentRegistry
+	{
+	public:
+		ComponentRegistry();
+		ComponentRegistry(const ComponentRegistry&) = delete;
+		ComponentRegistry& operator=(const ComponentRegistry&) = delete;
+
+		void RegisterComponent(Component&);
+		/**
+		 * @brief Does nothing if the Component is not registered.
+		*/
+		void UnregisterComponent(Component&);
+		/**
+		 * @brief Must be called after the GEEID of a registered Component has changed (e.g. when it was loaded).
+		*/
+		void OnComponentGEEIDChanged(Component&, GEEID previousGEEID);
+
+		void RegisterActor(Actor&);
+		void UnregisterActor(Actor&);
+		void OnActorGEEIDChanged(Actor&, GEEID previousGEEID);
+
+		/**
+		 * @return the live Component with the passed GEEID or nullptr if there is none. O(1).
+		*/
+		Component* FindComponent(GEEID geeid) const;
+		/**
+		 * @return the live Actor with the passed GEEID or nullptr if there is none. O(1).
+		*/
+		Actor* FindActor(GEEID geeid) const;
+
+		/**
+		 * @return all live Components of CompClass type (including the ones of classes derived from it), in no particular order.
+		 * The list is cached until a Component is registered or unregistered, so repeated queries are cheap; computing it requires one dynamic_cast per concrete type, not per Component.
+		*/
+		template <typename CompClass> const std::vector<CompClass*>& GetComponents();
+		/**
+		 * @return the number of live Components.
+		*/
+		std::size_t GetComponentCount() const { return Locations.size(); }
+
+	private:
+		struct Location
+		{
+			unsigned int BucketIndex;	// PendingBucketIndex if the concrete type has not been resolved yet
+			unsigned int Index;	// index in the bucket (or in PendingComponents)
+		};
+		struct TypeBucket
+		{
+			std::vector<Component*> Components;	// all of the same concrete type
+		};
+		struct QueryCacheBase
+		{
+			virtual ~QueryCacheBase() = default;
+			std::uint64_t Version = 0;
+		};
+		template <typename CompClass> struct QueryCache : public QueryCacheBase
+		{
+			std::vector<CompClass*> Components;
+		};
+
+		void ResolvePendingComponents();
+		/**
+		 * @return true if the Components in the bucket are of CastToClass type (casting one of them is enough, because they are all of the same concrete type).
+		*/
+		template <typename CastToClass> static bool IsBucketOfType(const TypeBucket& bucket);
+		void RemoveFromVector(std::vector<Component*>& vec, unsigned int index, unsigned int bucketIndex);
+
+		static constexpr unsigned int PendingBucketIndex = std::numeric_limits<unsigned int>::max();
+
+		std::vector<TypeBucket> Buckets;
+		std::unordered_map<std::type_index, unsigned int> BucketIndices;
+		std::vector<Component*> PendingComponents;
+		std::unordered_map<const Component*, Location> Locations;
+
+		std::unordered_map<GEEID, Component*> ComponentsByGEEID;
+		std::unordered_map<GEEID, Actor*> ActorsByGEEID;
+
+		std::uint64_t Version;	// changed whenever the set of typed Components changes
+		std::unordered_map<std::type_index, UniquePtr<QueryCacheBase>> QueryCaches;
+	};
+
+	template <typename CastToClass>
+	bool ComponentRegistry::IsBucketOfType(const TypeBucket& bucket)
+	{
+		return !bucket.Components.empty() && dynamic_cast<CastToClass*>(bucket.Components.front()) != nullptr;
+	}
+
+	template <typename CompClass>
+	const std::vector<CompClass*>& ComponentRegistry::GetComponents()
+	{
+		static_assert(std::is_base_of_v<Component, CompClass>, "Only Components are stored in the ComponentRegistry.");
+		ResolvePendingComponents();
+
+		UniquePtr<QueryCacheBase>& cacheBase = QueryCaches[std::type_index(typeid(CompClass))];
+		if (!cacheBase)
+			cacheBase = MakeUnique<QueryCache<CompClass>>();
+
+		QueryCache<CompClass>& cache = static_cast<QueryCache<CompClass>&>(*cacheBase);
+		if (cache.Version == Version)
+			return cache.Components;
+
+		cache.Components.clear();
+		for (const TypeBucket& bucket : Buckets)
+			if (IsBucketOfType<CompClass>(bucket))
+				for (Component* comp : bucket.Components)
+					cache.Components.push_back(static_cast<CompClass*>(comp));
+		cache.Version = Version;
+
+		return cache.Components;
+	}
+}
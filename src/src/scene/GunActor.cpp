@@ -249,4 +249,6 @@ namespace GEE
 
 	template void GunActor::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void GunActor::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void GunActor::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void GunActor::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 }
\ No newline at end of file
@@ -401,7 +401,7 @@ namespace GEE
 
 	void LightVolume::SetupRenderUniforms(const Shader& shader) const
 	{
-		shader.Uniform<int>("lightIndex", LightCompPtr->GetLightIndex());
+		shader.GetLightIndexHandle().Set(static_cast<int>(LightCompPtr->GetLightIndex()));
 	}
 
 
@@ -17,8 +17,11 @@ namespace GEE
 		ProbeIndex(0),
 		ProbeIntensity(1.0f)
 	{
-		EnvironmentMap = NamedTexture(Texture::Loader<float>::ReserveEmptyCubemap(Vec2u(1024), Texture::Format::Float16::RGB()), "Environment cubemap");
-		EnvironmentMap.SetMinFilter(Texture::MinFilter::Trilinear(), true, false);
+		if (!GameManager::IsHeadless())
+		{
+			EnvironmentMap = NamedTexture(Texture::Loader<float>::ReserveEmptyCubemap(Vec2u(1024), Texture::Format::Float16::RGB()), "Environment cubemap");
+			EnvironmentMap.SetMinFilter(Texture::MinFilter::Trilinear(), true, false);
+		}
 		GetScene().GetRenderData()->AddLightProbe(*this);
 	}
 
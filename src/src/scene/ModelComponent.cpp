@@ -16,6 +16,8 @@
 #include <editor/EditorActions.h>
 
 #include <rendering/Renderer.h>
+#include <math/Frustum.h>
+#include <rendering/RenderQueue.h>
 
 namespace GEE
 {
@@ -26,7 +28,13 @@ namespace GEE
 		UIComponent(actor, parentComp),
 		LastFrameMVP(Mat4f(1.0f)),
 		SkelInfo(nullptr),
-		RenderAsBillboard(false)
+		RenderAsBillboard(false),
+		WorldBoundsCache(Vec3f(0.0f), Vec3f(0.0f)),
+		WorldBoundsDirtyFlag(std::numeric_limits<unsigned int>::max()),
+		WorldBoundsMeshCount(0),
+		PrevFrameWorldMatrix(Mat4f(1.0f)),
+		CurrentFrameWorldMatrix(Mat4f(1.0f)),
+		WorldMatrixFrame(std::numeric_limits<unsigned long long>::max())
 	{
 		SetSkeletonInfo(info);
 	}
@@ -37,7 +45,13 @@ namespace GEE
 		MeshInstances(std::move(model.MeshInstances)),
 		SkelInfo(nullptr),
 		RenderAsBillboard(model.RenderAsBillboard),
-		LastFrameMVP(model.LastFrameMVP)
+		LastFrameMVP(model.LastFrameMVP),
+		WorldBoundsCache(Vec3f(0.0f), Vec3f(0.0f)),
+		WorldBoundsDirtyFlag(std::numeric_limits<unsigned int>::max()),
+		WorldBoundsMeshCount(0),
+		PrevFrameWorldMatrix(Mat4f(1.0f)),
+		CurrentFrameWorldMatrix(Mat4f(1.0f)),
+		WorldMatrixFrame(std::numeric_limits<unsigned long long>::max())
 	{
 		SetSkeletonInfo(model.SkelInfo);
 	}
@@ -129,6 +143,61 @@ namespace GEE
 		return materials;
 	}
 
+	bool ModelComponent::GetWorldBounds(Boxf<Vec3f>& worldBounds) const
+	{
+		if (MeshInstances.empty() || RenderAsBillboard || CanvasPtr || (SkelInfo && SkelInfo->GetBoneCount() > 0))
+			return false;
+
+		// Usually the bounds were already transformed by GameSceneRenderData::UpdateWorldBounds(), with the bounds of other models
+		Boxf<Vec3f> localBounds(Vec3f(0.0f), Vec3f(0.0f));
+		Mat4f worldMatrix;
+		if (GetStaleLocalBounds(localBounds, worldMatrix))
+			SetWorldBoundsCache(Math::TransformBox(localBounds, worldMatrix));
+
+		if (WorldBoundsMeshCount != MeshInstances.size())	// the bounds are unknown
+			return false;
+
+		worldBounds = WorldBoundsCache;
+		return true;
+	}
+
+	bool ModelComponent::GetStaleLocalBounds(Boxf<Vec3f>& localBounds, Mat4f& worldMatrix) const
+	{
+		if (MeshInstances.empty() || RenderAsBillboard || CanvasPtr || (SkelInfo && SkelInfo->GetBoneCount() > 0))
+			return false;
+
+		bool bAcquiredFlag = false;
+		if (WorldBoundsDirtyFlag == std::numeric_limits<unsigned int>::max())
+		{
+			WorldBoundsDirtyFlag = GetTransform().AddDirtyFlag();
+			bAcquiredFlag = true;
+		}
+
+		if (!GetTransform().GetDirtyFlag(WorldBoundsDirtyFlag) && !bAcquiredFlag && WorldBoundsMeshCount == MeshInstances.size())
+			return false;
+
+		localBounds = MeshInstances.front()->GetMesh().GetBoundingBox();
+		for (auto& it : MeshInstances)
+		{
+			Boxf<Vec3f> meshBounds = it->GetMesh().GetBoundingBox();
+			if (meshBounds.Size == Vec3f(0.0f))	// Bounding box unknown (the mesh was not loaded from a file); we cannot cull this model safely
+			{
+				WorldBoundsMeshCount = 0;
+				return false;
+			}
+			localBounds = Math::BoxUnion(localBounds, meshBounds);
+		}
+
+		worldMatrix = GetTransform().GetWorldTransformMatrix();
+		return true;
+	}
+
+	void ModelComponent::SetWorldBoundsCache(const Boxf<Vec3f>& worldBounds) const
+	{
+		WorldBoundsCache = worldBounds;
+		WorldBoundsMeshCount = static_cast<unsigned int>(MeshInstances.size());
+	}
+
 	MeshInstance* ModelComponent::FindMeshInstance(const std::string& nodeName, const std::string& specificMeshName)
 	{
 		/*for (int i = 0; i < 2; i++)	//Search 2 times; first look at the specific names and then at node names.
@@ -189,20 +258,50 @@ namespace GEE
 
 		if (!anyMeetsShaderRequirements)
 			return;
-			
-		std::vector<MeshInstance> meshInstances;
-		std::transform(MeshInstances.begin(), MeshInstances.end(), std::back_inserter(meshInstances), [](UniquePtr<MeshInstance>& instVec) { return *instVec; });
 
+		// The renderers view MeshInstances directly, so no MeshInstance (and none of its shared pointers) is copied
 		if (SkelInfo && SkelInfo->GetBoneCount() > 0)
-			SkeletalMeshRenderer(*GetGameHandle() ->GetRenderEngineHandle()).SkeletalMeshInstances(info, meshInstances, *SkelInfo, GetTransform().GetWorldTransform(), *shader);
+			SkeletalMeshRenderer(*GetGameHandle() ->GetRenderEngineHandle()).SkeletalMeshInstances(info, MeshInstances, *SkelInfo, GetTransform().GetWorldTransform(), *shader);
 		else
 		{
-			Renderer(*GetGameHandle()->GetRenderEngineHandle()).StaticMeshInstances((CanvasPtr) ? (CanvasPtr->BindForRender(info)) : (info), meshInstances, GetTransform().GetWorldTransform(), *shader, RenderAsBillboard);
+			Renderer(*GetGameHandle()->GetRenderEngineHandle()).StaticMeshInstances((CanvasPtr) ? (CanvasPtr->BindForRender(info)) : (info), MeshInstances, GetTransform().GetWorldTransform(), *shader, RenderAsBillboard);
 			if (CanvasPtr)
 				CanvasPtr->UnbindForRender();
 		}
 	}
 
+	bool ModelComponent::EnqueueDraws(const SceneMatrixInfo& info, Shader& shader, RenderQueue& queue)
+	{
+		if (GetHide() || IsBeingKilled() || MeshInstances.empty())
+			return true;
+		if (CanvasPtr || (SkelInfo && SkelInfo->GetBoneCount() > 0))
+			return false;
+
+		bool anyMeetsShaderRequirements = false;
+		for (auto& it : MeshInstances)
+			if (!info.GetRequiredShaderInfo().IsValid() || (it->GetMaterialPtr() && it->GetMaterialPtr()->GetShaderInfo().MatchesRequiredInfo(info.GetRequiredShaderInfo())))
+				anyMeetsShaderRequirements = true;
+
+		if (!anyMeetsShaderRequirements)
+			return true;
+
+		const Transform& worldTransform = GetTransform().GetWorldTransform();
+		Mat4f modelMat = GetTransform().GetWorldTransformMatrix();
+		Mat4f prevModelMat = GetPrevFrameWorldMatrix(modelMat);
+		if (RenderAsBillboard)
+		{
+			const Mat4f billboardMat(glm::inverse(worldTransform.GetRotationMatrix()) * glm::inverse(Mat3f(info.GetView())));
+			modelMat = modelMat * billboardMat;
+			prevModelMat = prevModelMat * billboardMat;
+		}
+
+		for (auto& it : MeshInstances)
+			if (RenderQueue::PassesFilter(info, *it))
+				queue.AddMeshInstance(info, shader, *it, modelMat, this, &prevModelMat);
+
+		return true;
+	}
+
 	void ModelComponent::GetEditorDescription(ComponentDescriptionBuilder descBuilder)
 	{
 		RenderableComponent::GetEditorDescription(descBuilder);
@@ -350,6 +449,22 @@ namespace GEE
 		SkelInfo = nullptr;
 	}
 
+	const Mat4f& ModelComponent::GetPrevFrameWorldMatrix(const Mat4f& worldMat) const
+	{
+		const unsigned long long frame = GetGameHandle()->GetTotalFrameCount();
+		if (frame != WorldMatrixFrame)
+		{
+			// A model rendered for the first time did not move
+			PrevFrameWorldMatrix = (WorldMatrixFrame == std::numeric_limits<unsigned long long>::max()) ? (worldMat) : (CurrentFrameWorldMatrix);
+			CurrentFrameWorldMatrix = worldMat;
+			WorldMatrixFrame = frame;
+		}
+
+		return PrevFrameWorldMatrix;
+	}
+
 	template void ModelComponent::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void ModelComponent::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void ModelComponent::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void ModelComponent::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 }
\ No newline at end of file
@@ -45,6 +45,13 @@ namespace GEE
 		const Mat4f& GetLastFrameMVP() const;
 		SkeletonInfo* GetSkeletonInfo() const;
 		std::vector<const Material*> GetMaterials() const override;
+		/**
+		 * @brief Computes the union of the bounding boxes of all MeshInstances, transformed to world space. The result is cached until the transform or the mesh instances change.
+		 * Skinned models, billboards and models inside UI canvases are not culled, since their final vertex positions do not depend only on the world transform.
+		*/
+		bool GetWorldBounds(Boxf<Vec3f>& worldBounds) const override;
+		bool GetStaleLocalBounds(Boxf<Vec3f>& localBounds, Mat4f& worldMatrix) const override;
+		void SetWorldBoundsCache(const Boxf<Vec3f>& worldBounds) const override;
 
 		MeshInstance* FindMeshInstance(const std::string& nodeName, const std::string& specificMeshName = std::string());
 		void AddMeshInst(const MeshInstance&);
@@ -53,6 +60,10 @@ namespace GEE
 		void Update(Time dt) override;
 
 		void Render(const SceneMatrixInfo&, Shader* shader) override;
+		/**
+		 * @brief Queues static meshes. Skinned models and models inside UI canvases are rendered through Render().
+		*/
+		bool EnqueueDraws(const SceneMatrixInfo&, Shader& shader, RenderQueue& queue) override;
 
 		void GetEditorDescription(ComponentDescriptionBuilder) override;
 
@@ -80,6 +91,10 @@ namespace GEE
 	protected:
 		unsigned int GetUIDepth() const override;
 		void SignalSkeletonInfoDeath();
+		/**
+		 * @return the world transform matrix of the previous rendered frame, for the velocity buffer. The first call in a frame remembers worldMat as the matrix of the current frame.
+		*/
+		const Mat4f& GetPrevFrameWorldMatrix(const Mat4f& worldMat) const;
 
 		friend class SkeletonInfo;
 
@@ -89,6 +104,14 @@ namespace GEE
 		bool RenderAsBillboard;
 
 		mutable Mat4f LastFrameMVP;	//for velocity buffer; this field is only updated when velocity buffer is needed (for temporal AA/motion blur), in any other case it will be set to an identity matrix
+
+	private:
+		mutable Boxf<Vec3f> WorldBoundsCache;
+		mutable unsigned int WorldBoundsDirtyFlag;	// index of the dirty flag in the transform; acquired lazily, because moving a Transform does not preserve its extra dirty flags
+		mutable unsigned int WorldBoundsMeshCount;	// number of mesh instances the cache was computed for (MeshInstances is public, so it can change without notice)
+
+		mutable Mat4f PrevFrameWorldMatrix, CurrentFrameWorldMatrix;
+		mutable unsigned long long WorldMatrixFrame;	// the frame CurrentFrameWorldMatrix was rendered in
 	};
 
 	template <> inline void Hierarchy::Instantiation::Impl<ModelComponent>::InstantiateToComp(SharedPtr<Instantiation::Data> data, const NodeBase& instantiatedNode, ModelComponent& targetComp)
@@ -1,19 +1,41 @@
 #pragma once
 #include <scene/Component.h>
 #include <rendering/RenderInfo.h>
+#include <math/Box.h>
 namespace GEE
 {
+	class RenderQueue;
+
 	class Renderable
 	{
 	public:
 		Renderable(GameScene& scene);
 		Renderable(Renderable&& renderable);
 		virtual void Render(const SceneMatrixInfo& info, Shader* shader) = 0;
+		/**
+		 * @brief Adds the draws of this Renderable to the queue instead of rendering it immediately. Used by SceneRenderer::RawRender to sort draws across the scene.
+		 * @return a boolean indicating whether the Renderable was handled; if false is returned, the Renderable is queued as a whole and its Render() method will be called.
+		*/
+		virtual bool EnqueueDraws(const SceneMatrixInfo& info, Shader& shader, RenderQueue& queue) { return false; }
 		bool GetHide() const;
 		void SetHide(bool hide);
 		bool CastsShadow() const;
 		void SetCastsShadow(bool castsShadow);
 		virtual std::vector<const Material*> GetMaterials() const;
+		/**
+		 * @brief Used for frustum culling. Renderables which do not override this function are never culled.
+		 * @param worldBounds: filled with the world space bounding box of this Renderable (only if the function returns true)
+		 * @return a boolean indicating whether the Renderable has known bounds and can be culled
+		*/
+		virtual bool GetWorldBounds(Boxf<Vec3f>& worldBounds) const { return false; }
+		/**
+		 * @brief Lets GameSceneRenderData::UpdateWorldBounds() transform the bounds of all Renderables in a single batched call. Renderables which cache their world bounds override it together with SetWorldBoundsCache().
+		 * @param localBounds: filled with the local bounding box (only if the function returns true)
+		 * @param worldMatrix: filled with the matrix which transforms localBounds to world space (only if the function returns true)
+		 * @return a boolean indicating whether the cached world bounds are stale; if true is returned, SetWorldBoundsCache() must be called with the transformed box.
+		*/
+		virtual bool GetStaleLocalBounds(Boxf<Vec3f>& localBounds, Mat4f& worldMatrix) const { return false; }
+		virtual void SetWorldBoundsCache(const Boxf<Vec3f>& worldBounds) const {}
 		virtual ~Renderable();
 	protected:
 		virtual unsigned int GetUIDepth() const { return 0; }
@@ -187,6 +187,8 @@ namespace GEE
 
 	template void Node<>::Serialize<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
 	template void Node<>::Serialize<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&);
+	template void Node<>::Serialize<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
+	template void Node<>::Serialize<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&);
 
 	template <> Node<ModelComponent>::Node(Actor& tempActor, const std::string& name) :
 		CompT(ModelComponent(tempActor, nullptr, name))
@@ -214,6 +214,8 @@ namespace GEE
 
 	template void Tree::Save<cereal::JSONOutputArchive>(cereal::JSONOutputArchive&) const;
 	template void Tree::Load<cereal::JSONInputArchive>(cereal::JSONInputArchive&);
+	template void Tree::Save<cereal::PortableBinaryOutputArchive>(cereal::PortableBinaryOutputArchive&) const;
+	template void Tree::Load<cereal::PortableBinaryInputArchive>(cereal::PortableBinaryInputArchive&);
 
 	//HierarchyTree::Root points to an incomplete type. We are forced to define a constructor, but we don't really need to write anything in it, so we just keep the default one.
 	Tree::~Tree() = default;
@@ -0,0 +1,58 @@
+#include <utility/AllocationCounter.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace GEE
+{
+	std::atomic<std::uint64_t> GlobalAllocationCount(0);
+	std::uint64_t SectionBeginAllocationCount = 0, LastSectionAllocationCount = 0;
+
+	std::uint64_t AllocationCounter::GetAllocationCount()
+	{
+		return GlobalAllocationCount.load(std::memory_order_relaxed);
+	}
+
+	void AllocationCounter::BeginSection()
+	{
+		SectionBeginAllocationCount = GetAllocationCount();
+	}
+
+	std::uint64_t AllocationCounter::EndSection()
+	{
+		return LastSectionAllocationCount = GetAllocationCount() - SectionBeginAllocationCount;
+	}
+
+	std::uint64_t AllocationCounter::GetLastSectionAllocationCount()
+	{
+		return LastSectionAllocationCount;
+	}
+}
+
+#ifdef GEE_ALLOCATION_COUNTER_ENABLED
+// Replacements of the global allocation functions. The other forms (nothrow, sized and array deletes) call these by default.
+// Over-aligned allocations (std::align_val_t) are not counted.
+void* operator new(std::size_t size)
+{
+	GEE::GlobalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc((size > 0) ? (size) : (1)))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	operator delete(ptr);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+// Not GEE_DEBUG, which utility/Asserts.h always defines; the allocation functions are only replaced in builds without NDEBUG.
+#if !defined(NDEBUG)
+	#define GEE_ALLOCATION_COUNTER_ENABLED
+#endif
+
+namespace GEE
+{
+	/**
+	 * @brief Counts heap allocations made through the global operator new. Counting is enabled only in debug builds (without NDEBUG); otherwise the counters always stay at 0.
+	 * Used to verify that hot paths (e.g. rendering a static scene) do not allocate.
+	*/
+	class AllocationCounter
+	{
+	public:
+		static constexpr bool IsEnabled()
+		{
+		#ifdef GEE_ALLOCATION_COUNTER_ENABLED
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+		/**
+		 * @return the number of allocations since the program started.
+		*/
+		static std::uint64_t GetAllocationCount();
+
+		/**
+		 * @brief Marks the beginning of a measured section (e.g. a frame). Single section at a time; called from the main thread.
+		*/
+		static void BeginSection();
+		/**
+		 * @brief Ends the measured section.
+		 * @return the number of allocations made since the last BeginSection() call (by any thread).
+		*/
+		static std::uint64_t EndSection();
+		/**
+		 * @return the result of the last EndSection() call.
+		*/
+		static std::uint64_t GetLastSectionAllocationCount();
+	};
+}
\ No newline at end of file
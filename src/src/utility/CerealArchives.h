@@ -0,0 +1,9 @@
+#pragma once
+#include <utility/CerealNames.h>
+/*
+*	All archive types the engine serializes with. Include this header instead of a specific archive, before any polymorphic type is registered (GEE_REGISTER_TYPE),
+*	because cereal only creates the polymorphic bindings for archives which were included at the point of registration.
+*	Every Save/Load/Serialize which is explicitly instantiated for one archive type must be instantiated for all of them.
+*/
+#include <cereal/archives/json.hpp>
+#include <cereal/archives/portable_binary.hpp>
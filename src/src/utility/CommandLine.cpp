@@ -0,0 +1,50 @@
+#include <utility/CommandLine.h>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+
+namespace GEE
+{
+	namespace CommandLine
+	{
+		bool ParseUnsigned(const String& argument, unsigned long long& value, unsigned long long minValue, unsigned long long maxValue)
+		{
+			// Unlike std::stoull, std::from_chars rejects signs and leading whitespace and reports overflow without throwing.
+			unsigned long long parsedValue = 0;
+			const char* end = argument.data() + argument.size();
+			const std::from_chars_result result = std::from_chars(argument.data(), end, parsedValue);
+			if (argument.empty() || result.ec != std::errc() || result.ptr != end || parsedValue < minValue || parsedValue > maxValue)
+				return false;
+
+			value = parsedValue;
+			return true;
+		}
+
+		bool ParseUnsigned(const String& argument, unsigned int& value, unsigned int minValue)
+		{
+			unsigned long long parsedValue = 0;
+			if (!ParseUnsigned(argument, parsedValue, minValue, std::numeric_limits<unsigned int>::max()))
+				return false;
+
+			value = static_cast<unsigned int>(parsedValue);
+			return true;
+		}
+
+		bool ParseDouble(const String& argument, double& value)
+		{
+			if (argument.empty() || std::isspace(static_cast<unsigned char>(argument.front())))
+				return false;
+
+			char* end = nullptr;
+			errno = 0;
+			const double parsedValue = std::strtod(argument.c_str(), &end);
+			if (errno == ERANGE || end != argument.c_str() + argument.size() || !std::isfinite(parsedValue))
+				return false;
+
+			value = parsedValue;
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+#include <utility/Utility.h>
+#include <limits>
+
+namespace GEE
+{
+	/**
+	 * @brief Parsing of numeric command line arguments. The whole argument must be a number (no whitespace or trailing characters) and nothing is thrown, so callers can print their usage instead.
+	 * The value is only written if the argument is valid.
+	*/
+	namespace CommandLine
+	{
+		/**
+		 * @return false if the argument is not a non-negative integer in [minValue, maxValue].
+		*/
+		bool ParseUnsigned(const String& argument, unsigned long long& value, unsigned long long minValue = 0, unsigned long long maxValue = std::numeric_limits<unsigned long long>::max());
+		bool ParseUnsigned(const String& argument, unsigned int& value, unsigned int minValue = 0);
+		/**
+		 * @return false if the argument is not a finite number.
+		*/
+		bool ParseDouble(const String& argument, double& value);
+	}
+}
\ No newline at end of file
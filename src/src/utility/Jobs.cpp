@@ -0,0 +1,272 @@
+#include <utility/Jobs.h>
+#include <utility/ScopeProfiler.h>
+#include <algorithm>
+
+namespace GEE
+{
+	struct Job
+	{
+		JobSystem::JobFunc Func;
+		JobSystem* System = nullptr;
+		JobFence* Fence = nullptr;
+
+		std::atomic<unsigned int> UnfinishedDependencyCount{ 0 };
+		std::atomic<bool> bFinished{ false };
+
+		std::mutex ContinuationMutex;
+		std::vector<SharedPtr<Job>> Continuations;	// jobs that depend on this one
+	};
+
+	namespace
+	{
+		thread_local const JobSystem* CurrentWorkerOwner = nullptr;
+		thread_local int CurrentWorkerIndex = -1;
+	}
+
+	template <typename Predicate>
+	void JobSystem::HelpUntil(Predicate&& predicate)
+	{
+		while (!predicate())
+			if (!TryExecuteJob())
+				std::this_thread::yield();
+	}
+
+	bool JobHandle::IsFinished() const
+	{
+		return !ScheduledJob || ScheduledJob->bFinished.load(std::memory_order_acquire);
+	}
+
+	void JobHandle::Wait() const
+	{
+		if (IsFinished())
+			return;
+
+		ScheduledJob->System->HelpUntil([this]() { return IsFinished(); });
+	}
+
+	JobFence::JobFence() :
+		PendingJobCount(0)
+	{
+	}
+
+	void JobFence::Wait() const
+	{
+		if (IsSignaled())
+			return;
+
+		JobSystem::Get().HelpUntil([this]() { return IsSignaled(); });
+	}
+
+	JobSystem::JobSystem(unsigned int workerCount) :
+		NextExternalQueue(0),
+		QueuedJobCount(0),
+		bStopping(false)
+	{
+		// There is always at least one queue, so jobs can be scheduled even without workers.
+		for (unsigned int i = 0; i < std::max(workerCount, 1u); i++)
+			Queues.push_back(MakeUnique<WorkerQueue>());
+
+		Workers.reserve(workerCount);
+		for (unsigned int i = 0; i < workerCount; i++)
+			Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(SleepMutex);
+			bStopping = true;
+		}
+		SleepCondition.notify_all();
+
+		for (auto& worker : Workers)
+			worker.join();
+
+		while (TryExecuteJob());
+	}
+
+	JobSystem& JobSystem::Get()
+	{
+		static JobSystem engineJobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+		return engineJobSystem;
+	}
+
+	int JobSystem::GetCurrentWorkerIndex() const
+	{
+		return (CurrentWorkerOwner == this) ? (CurrentWorkerIndex) : (-1);
+	}
+
+	JobHandle JobSystem::Schedule(JobFunc func, Span<const JobHandle> dependencies, JobFence* fence)
+	{
+		SharedPtr<Job> job = MakeShared<Job>();
+		job->Func = std::move(func);
+		job->System = this;
+		job->Fence = fence;
+		if (fence)
+			fence->PendingJobCount.fetch_add(1, std::memory_order_relaxed);
+
+		// Hold one "dependency" until all real dependencies are registered, so the job is not enqueued by a dependency finishing in the meantime.
+		job->UnfinishedDependencyCount.store(1, std::memory_order_relaxed);
+		for (const JobHandle& dependency : dependencies)
+		{
+			if (!dependency.ScheduledJob)
+				continue;
+
+			Job& dependencyJob = *dependency.ScheduledJob;
+			std::lock_guard<std::mutex> lock(dependencyJob.ContinuationMutex);
+			if (dependencyJob.bFinished.load(std::memory_order_acquire))
+				continue;
+
+			job->UnfinishedDependencyCount.fetch_add(1, std::memory_order_relaxed);
+			dependencyJob.Continuations.push_back(job);
+		}
+
+		if (job->UnfinishedDependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Enqueue(job);
+
+		return JobHandle(job);
+	}
+
+	JobHandle JobSystem::ParallelFor(std::size_t count, std::size_t minBatchSize, RangeFunc func, Span<const JobHandle> dependencies, JobFence* fence)
+	{
+		minBatchSize = std::max(minBatchSize, static_cast<std::size_t>(1));
+		// A few batches per thread let faster threads steal the remaining work.
+		const std::size_t maxBatchCount = static_cast<std::size_t>(GetWorkerCount() + 1) * 4;
+		const std::size_t batchCount = std::min((count + minBatchSize - 1) / minBatchSize, maxBatchCount);
+
+		if (batchCount <= 1 && dependencies.empty())
+		{
+			if (count > 0)
+				func(0, count);
+			return JobHandle();
+		}
+
+		SharedPtr<RangeFunc> sharedFunc = MakeShared<RangeFunc>(std::move(func));
+		std::vector<JobHandle> batches;
+		batches.reserve(batchCount);
+		for (std::size_t i = 0; i < batchCount; i++)
+		{
+			const std::size_t begin = count * i / batchCount, end = count * (i + 1) / batchCount;
+			batches.push_back(Schedule([sharedFunc, begin, end]() { (*sharedFunc)(begin, end); }, dependencies, fence));
+		}
+
+		return Schedule([]() {}, batches, fence);
+	}
+
+	void JobSystem::EndFrame()
+	{
+		HelpUntil([this]() { return FrameFence.IsSignaled(); });
+	}
+
+	bool JobSystem::TryExecuteJob()
+	{
+		if (SharedPtr<Job> job = FindJob(GetCurrentWorkerIndex()))
+		{
+			Execute(job);
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::WorkerLoop(unsigned int workerIndex)
+	{
+		CurrentWorkerOwner = this;
+		CurrentWorkerIndex = static_cast<int>(workerIndex);
+		ScopeProfiler::SetThreadName("Job worker " + std::to_string(workerIndex));
+
+		while (true)
+		{
+			if (SharedPtr<Job> job = FindJob(CurrentWorkerIndex))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(SleepMutex);
+			SleepCondition.wait(lock, [this]() { return bStopping || QueuedJobCount.load(std::memory_order_acquire) > 0; });
+			if (bStopping && QueuedJobCount.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	void JobSystem::Enqueue(SharedPtr<Job> job)
+	{
+		// Workers push to their own queue (the jobs they create are likely to use the data that is already in their cache). Other threads distribute jobs evenly.
+		int workerIndex = GetCurrentWorkerIndex();
+		unsigned int queueIndex = (workerIndex >= 0) ? (static_cast<unsigned int>(workerIndex)) : (NextExternalQueue.fetch_add(1, std::memory_order_relaxed) % Queues.size());
+
+		{
+			std::lock_guard<std::mutex> lock(Queues[queueIndex]->Mutex);
+			Queues[queueIndex]->Jobs.push_back(std::move(job));
+		}
+		QueuedJobCount.fetch_add(1, std::memory_order_release);
+
+		// Lock the mutex before notifying, so a worker which has just checked the counter cannot miss the notification.
+		{
+			std::lock_guard<std::mutex> lock(SleepMutex);
+		}
+		SleepCondition.notify_one();
+	}
+
+	SharedPtr<Job> JobSystem::FindJob(int workerIndex)
+	{
+		if (QueuedJobCount.load(std::memory_order_acquire) == 0)
+			return nullptr;
+
+		const unsigned int queueCount = static_cast<unsigned int>(Queues.size());
+		if (workerIndex >= 0)
+		{
+			WorkerQueue& ownQueue = *Queues[workerIndex];
+			std::lock_guard<std::mutex> lock(ownQueue.Mutex);
+			if (!ownQueue.Jobs.empty())
+			{
+				SharedPtr<Job> job = std::move(ownQueue.Jobs.back());
+				ownQueue.Jobs.pop_back();
+				QueuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+				return job;
+			}
+		}
+
+		// Steal the oldest job from another queue.
+		const unsigned int firstVictim = (workerIndex >= 0) ? (static_cast<unsigned int>(workerIndex) + 1) : (0);
+		for (unsigned int i = 0; i < queueCount; i++)
+		{
+			WorkerQueue& victimQueue = *Queues[(firstVictim + i) % queueCount];
+			std::lock_guard<std::mutex> lock(victimQueue.Mutex);
+			if (!victimQueue.Jobs.empty())
+			{
+				SharedPtr<Job> job = std::move(victimQueue.Jobs.front());
+				victimQueue.Jobs.pop_front();
+				QueuedJobCount.fetch_sub(1, std::memory_order_acq_rel);
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void JobSystem::Execute(const SharedPtr<Job>& job)
+	{
+		{
+			GEE_PROFILE_SCOPE("Job");
+			job->Func();
+			job->Func = nullptr;	// release everything captured by the function
+		}
+
+		std::vector<SharedPtr<Job>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(job->ContinuationMutex);
+			job->bFinished.store(true, std::memory_order_release);
+			continuations.swap(job->Continuations);
+		}
+
+		for (auto& continuation : continuations)
+			if (continuation->UnfinishedDependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Enqueue(std::move(continuation));
+
+		// The fence may be destroyed as soon as it is signaled, so it must be the last thing accessed.
+		if (job->Fence)
+			job->Fence->PendingJobCount.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
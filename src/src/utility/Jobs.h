@@ -0,0 +1,152 @@
+#pragma once
+#include <utility/Utility.h>
+#include <utility/Span.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace GEE
+{
+	struct Job;
+	class JobSystem;
+
+	/**
+	 * @brief Refers to a scheduled job. Cheap to copy; the job is kept alive as long as any handle refers to it.
+	 * A default-constructed handle refers to no job and is always considered finished.
+	*/
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+
+		bool IsValid() const { return ScheduledJob != nullptr; }
+		bool IsFinished() const;
+		/**
+		 * @brief Blocks until the job is finished. The calling thread executes other scheduled jobs in the meantime, so waiting from inside a job does not deadlock.
+		*/
+		void Wait() const;
+
+	private:
+		JobHandle(SharedPtr<Job> job) : ScheduledJob(std::move(job)) {}
+		SharedPtr<Job> ScheduledJob;
+		friend class JobSystem;
+	};
+
+	/**
+	 * @brief Counts unfinished jobs that were scheduled with it. Can be reused once it is signaled.
+	*/
+	class JobFence
+	{
+	public:
+		JobFence();
+		JobFence(const JobFence&) = delete;
+		JobFence& operator=(const JobFence&) = delete;
+
+		bool IsSignaled() const { return PendingJobCount.load(std::memory_order_acquire) == 0; }
+		/**
+		 * @brief Blocks until all jobs scheduled with this fence are finished. Like JobHandle::Wait(), it executes other jobs of the engine job system (JobSystem::Get()) while waiting.
+		*/
+		void Wait() const;
+
+	private:
+		std::atomic<unsigned int> PendingJobCount;
+		friend class JobSystem;
+	};
+
+	/**
+	 * @brief Work-stealing job scheduler. Each worker thread has its own queue: it pushes and pops jobs at the back, while idle workers steal from the front of other queues.
+	 * Threads that are not workers (e.g. the main thread) hand jobs to the workers in a round-robin fashion and execute jobs themselves when they wait.
+	 * There is one worker per core, except for the core used by the main thread.
+	*/
+	class JobSystem
+	{
+	public:
+		using JobFunc = std::function<void()>;
+		/**
+		 * @brief Called by ParallelFor with a range of indices [begin, end).
+		*/
+		using RangeFunc = std::function<void(std::size_t begin, std::size_t end)>;
+
+		/**
+		 * @param workerCount: the number of worker threads to start. Can be 0 - scheduled jobs are then executed only by threads which wait for them.
+		*/
+		explicit JobSystem(unsigned int workerCount);
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		/**
+		 * @brief Executes all remaining jobs and stops the worker threads.
+		*/
+		~JobSystem();
+
+		/**
+		 * @return the engine-wide job system. The worker threads are started on the first call.
+		*/
+		static JobSystem& Get();
+
+		unsigned int GetWorkerCount() const { return static_cast<unsigned int>(Workers.size()); }
+		/**
+		 * @return the index of the worker thread that calls this method or -1 if it is not called by a worker of this JobSystem.
+		*/
+		int GetCurrentWorkerIndex() const;
+
+		/**
+		 * @brief Schedules func to be executed once all the dependencies are finished.
+		 * @param fence: optional fence which will not be signaled until the job is finished.
+		*/
+		JobHandle Schedule(JobFunc func, Span<const JobHandle> dependencies = {}, JobFence* fence = nullptr);
+
+		/**
+		 * @brief Splits the range [0, count) into batches of at least minBatchSize indices and executes func for each batch in parallel.
+		 * Small ranges are executed immediately on the calling thread.
+		 * @return a handle to a job which finishes after all the batches are finished. Everything func captures by reference must stay valid until then.
+		*/
+		JobHandle ParallelFor(std::size_t count, std::size_t minBatchSize, RangeFunc func, Span<const JobHandle> dependencies = {}, JobFence* fence = nullptr);
+
+		/**
+		 * @return the fence of the current frame. Jobs that may run in the background but have to finish before the end of the frame (e.g. before the scene is rendered or modified) should be scheduled with it.
+		*/
+		JobFence& GetFrameFence() { return FrameFence; }
+		/**
+		 * @brief Waits for the frame fence. Called by the game loop once per frame.
+		*/
+		void EndFrame();
+
+		/**
+		 * @brief Executes a single queued job on the calling thread, if there is any.
+		 * @return true if a job was executed.
+		*/
+		bool TryExecuteJob();
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex Mutex;
+			std::deque<SharedPtr<Job>> Jobs;
+		};
+
+		void WorkerLoop(unsigned int workerIndex);
+		void Enqueue(SharedPtr<Job> job);
+		SharedPtr<Job> FindJob(int workerIndex);
+		void Execute(const SharedPtr<Job>& job);
+		/**
+		 * @brief Waits until the predicate returns true, executing other jobs in the meantime.
+		*/
+		template <typename Predicate> void HelpUntil(Predicate&& predicate);
+		friend class JobHandle;
+		friend class JobFence;
+
+		std::vector<UniquePtr<WorkerQueue>> Queues;
+		std::vector<std::thread> Workers;
+		std::atomic<unsigned int> NextExternalQueue;
+		std::atomic<unsigned int> QueuedJobCount;
+
+		std::mutex SleepMutex;
+		std::condition_variable SleepCondition;
+		bool bStopping;
+
+		JobFence FrameFence;
+	};
+}
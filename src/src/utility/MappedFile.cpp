@@ -0,0 +1,142 @@
+#include <utility/MappedFile.h>
+
+#ifdef GEE_OS_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GEE
+{
+	MappedFile::MappedFile() :
+		Data(nullptr),
+		Size(0)
+#ifdef GEE_OS_WINDOWS
+		, FileHandle(nullptr),
+		MappingHandle(nullptr)
+#endif
+	{
+	}
+
+	MappedFile::MappedFile(MappedFile&& file) noexcept :
+		MappedFile()
+	{
+		*this = std::move(file);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+	{
+		if (this == &file)
+			return *this;
+
+		Close();
+		std::swap(Data, file.Data);
+		std::swap(Size, file.Size);
+#ifdef GEE_OS_WINDOWS
+		std::swap(FileHandle, file.FileHandle);
+		std::swap(MappingHandle, file.MappingHandle);
+#endif
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef GEE_OS_WINDOWS
+	bool MappedFile::Open(const String& path)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		Data = static_cast<const unsigned char*>(view);
+		Size = static_cast<std::size_t>(fileSize.QuadPart);
+		FileHandle = file;
+		MappingHandle = mapping;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (Data)
+			UnmapViewOfFile(Data);
+		if (MappingHandle)
+			CloseHandle(MappingHandle);
+		if (FileHandle)
+			CloseHandle(FileHandle);
+
+		Data = nullptr;
+		Size = 0;
+		FileHandle = MappingHandle = nullptr;
+	}
+#else
+	bool MappedFile::Open(const String& path)
+	{
+		Close();
+
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);	// the mapping keeps its own reference to the file
+		if (view == MAP_FAILED)
+			return false;
+
+		Data = static_cast<const unsigned char*>(view);
+		Size = static_cast<std::size_t>(fileStat.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (Data)
+			munmap(const_cast<unsigned char*>(Data), Size);
+
+		Data = nullptr;
+		Size = 0;
+	}
+#endif
+}
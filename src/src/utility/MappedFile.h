@@ -0,0 +1,40 @@
+#pragma once
+#include <utility/Utility.h>
+#include <utility/OperatingSystem.h>
+#include <cstddef>
+
+namespace GEE
+{
+	/**
+	 * @brief Read-only memory mapping of a whole file. The contents stay valid until the MappedFile is closed or destroyed.
+	 * The mapping starts at a page boundary, so data stored in the file at offsets aligned to 16 bytes can be read in place.
+	*/
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) noexcept;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) noexcept;
+		~MappedFile();
+
+		/**
+		 * @return true if the file has been mapped. Empty files cannot be mapped.
+		*/
+		bool Open(const String& path);
+		void Close();
+
+		bool IsOpen() const { return Data != nullptr; }
+		const unsigned char* GetData() const { return Data; }
+		std::size_t GetSize() const { return Size; }
+
+	private:
+		const unsigned char* Data;
+		std::size_t Size;
+#ifdef GEE_OS_WINDOWS
+		void* FileHandle;
+		void* MappingHandle;
+#endif
+	};
+}
@@ -0,0 +1,221 @@
+#include <utility/ScopeProfiler.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace GEE
+{
+	std::atomic<bool> ScopeProfiler::bEnabled(false);
+
+	namespace
+	{
+		struct RecordedScope
+		{
+			const char* Name;
+			std::uint64_t BeginTimestamp, EndTimestamp;
+		};
+
+		struct RecordedCounter
+		{
+			const char* Name;
+			std::uint64_t Timestamp;
+			double Value;
+		};
+	}
+
+	/**
+	 * @brief Ring buffer written by one thread at a time. WriteCount is the total number of scopes recorded to the track; the scope with index i is stored at i % ScopesPerThread.
+	 * Clearing only moves ExportedFrom, so it never races with the writer.
+	*/
+	struct ScopeTrack
+	{
+		std::vector<RecordedScope> Scopes;
+		std::atomic<std::uint64_t> WriteCount;
+		std::uint64_t ExportedFrom;	// the index of the first scope recorded after the last Clear() call
+		String Name;
+		unsigned int TrackIndex;
+
+		ScopeTrack(unsigned int trackIndex, const String& name) :
+			Scopes(ScopeProfiler::ScopesPerThread),
+			WriteCount(0),
+			ExportedFrom(0),
+			Name(name),
+			TrackIndex(trackIndex)
+		{
+		}
+	};
+
+	namespace
+	{
+		std::mutex RegistryMutex;	// guards the list of tracks, their names, interned names and counters; never locked while recording a scope
+		std::vector<RecordedCounter> Counters;
+		std::vector<UniquePtr<ScopeTrack>> Tracks;	// tracks are never freed, so scopes of finished threads can still be exported
+		std::unordered_set<String> InternedNames;	// node-based, so the strings never move
+		thread_local ScopeTrack* CurrentThreadTrack = nullptr;
+		thread_local String CurrentThreadName;	// the name given before the thread recorded its first scope
+
+		ScopeTrack& AddTrackLocked(const String& name)
+		{
+			const unsigned int trackIndex = static_cast<unsigned int>(Tracks.size());
+			Tracks.push_back(MakeUnique<ScopeTrack>(trackIndex, (name.empty()) ? ("Thread " + std::to_string(trackIndex)) : (name)));
+			return *Tracks.back();
+		}
+
+		ScopeTrack& GetThreadTrack()
+		{
+			if (!CurrentThreadTrack)
+			{
+				std::lock_guard<std::mutex> lock(RegistryMutex);
+				CurrentThreadTrack = &AddTrackLocked(CurrentThreadName);
+			}
+
+			return *CurrentThreadTrack;
+		}
+
+		void WriteJsonString(std::ostream& stream, const char* str)
+		{
+			stream << '"';
+			for (; *str; str++)
+			{
+				if (*str == '"' || *str == '\\')
+					stream << '\\' << *str;
+				else if (static_cast<unsigned char>(*str) < 0x20)
+					stream << ' ';
+				else
+					stream << *str;
+			}
+			stream << '"';
+		}
+	}
+
+	void ScopeProfiler::SetEnabled(bool enabled)
+	{
+		bEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void ScopeProfiler::SetThreadName(const String& name)
+	{
+		// The track is not allocated yet, because the thread might never record anything.
+		CurrentThreadName = name;
+		if (CurrentThreadTrack)
+		{
+			std::lock_guard<std::mutex> lock(RegistryMutex);
+			CurrentThreadTrack->Name = name;
+		}
+	}
+
+	ScopeTrack& ScopeProfiler::AddTrack(const String& name)
+	{
+		std::lock_guard<std::mutex> lock(RegistryMutex);
+		return AddTrackLocked(name);
+	}
+
+	const char* ScopeProfiler::InternName(const String& name)
+	{
+		std::lock_guard<std::mutex> lock(RegistryMutex);
+		return InternedNames.insert(name).first->c_str();
+	}
+
+	std::uint64_t ScopeProfiler::GetTimestamp()
+	{
+		static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	void ScopeProfiler::RecordScope(const char* name, std::uint64_t beginTimestamp, std::uint64_t endTimestamp)
+	{
+		RecordScope(GetThreadTrack(), name, beginTimestamp, endTimestamp);
+	}
+
+	void ScopeProfiler::RecordScope(ScopeTrack& track, const char* name, std::uint64_t beginTimestamp, std::uint64_t endTimestamp)
+	{
+		const std::uint64_t index = track.WriteCount.load(std::memory_order_relaxed);
+		track.Scopes[index % ScopesPerThread] = RecordedScope{ name, beginTimestamp, endTimestamp };
+		track.WriteCount.store(index + 1, std::memory_order_release);
+	}
+
+	void ScopeProfiler::RecordCounter(const char* name, double value)
+	{
+		const std::uint64_t timestamp = GetTimestamp();
+		std::lock_guard<std::mutex> lock(RegistryMutex);
+		Counters.push_back(RecordedCounter{ name, timestamp, value });
+	}
+
+	bool ScopeProfiler::ExportChromeTrace(const String& filepath)
+	{
+		std::ofstream file(filepath);
+		if (!file.good())
+		{
+			std::cout << "ERROR: Cannot open " << filepath << " to export the profiled scopes.\n";
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(RegistryMutex);
+		std::vector<RecordedScope> scopes;
+		scopes.reserve(ScopesPerThread);
+		unsigned int exportedCount = 0;
+
+		// Timestamps are in microseconds; three decimal places keep the nanosecond precision.
+		file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool bFirstEvent = true;
+		for (const auto& track : Tracks)
+		{
+			const std::uint64_t countBefore = track->WriteCount.load(std::memory_order_acquire);
+			const std::uint64_t first = std::max((countBefore > ScopesPerThread) ? (countBefore - ScopesPerThread) : (0), track->ExportedFrom);
+			scopes.clear();
+			for (std::uint64_t i = first; i < countBefore; i++)
+				scopes.push_back(track->Scopes[i % ScopesPerThread]);
+
+			// The thread could have overwritten the oldest copied scopes in the meantime (the scope with index i is overwritten while WriteCount is i + ScopesPerThread).
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const std::uint64_t countAfter = track->WriteCount.load(std::memory_order_relaxed);
+			const std::uint64_t firstValid = (countAfter >= ScopesPerThread) ? (countAfter - ScopesPerThread + 1) : (0);
+			const std::size_t skippedCount = static_cast<std::size_t>(std::min<std::uint64_t>((firstValid > first) ? (firstValid - first) : (0), scopes.size()));
+
+			file << ((bFirstEvent) ? ("") : (",")) << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track->TrackIndex << ",\"args\":{\"name\":";
+			WriteJsonString(file, track->Name.c_str());
+			file << "}}";
+			bFirstEvent = false;
+
+			for (std::size_t i = skippedCount; i < scopes.size(); i++)
+			{
+				const RecordedScope& scope = scopes[i];
+				file << ",\n{\"name\":";
+				WriteJsonString(file, scope.Name);
+				file << ",\"cat\":\"GEE\",\"ph\":\"X\",\"pid\":0,\"tid\":" << track->TrackIndex << ",\"ts\":" << static_cast<double>(scope.BeginTimestamp) / 1000.0 << ",\"dur\":" << static_cast<double>(scope.EndTimestamp - scope.BeginTimestamp) / 1000.0 << '}';
+			}
+			exportedCount += static_cast<unsigned int>(scopes.size() - skippedCount);
+		}
+
+		for (const RecordedCounter& counter : Counters)
+		{
+			file << ((bFirstEvent) ? ("") : (",")) << "\n{\"name\":";
+			WriteJsonString(file, counter.Name);
+			file << ",\"cat\":\"GEE\",\"ph\":\"C\",\"pid\":0,\"ts\":" << static_cast<double>(counter.Timestamp) / 1000.0 << ",\"args\":{\"value\":" << counter.Value << "}}";
+			bFirstEvent = false;
+		}
+		file << "\n]}\n";
+
+		if (!file.good())
+		{
+			std::cout << "ERROR: Cannot write the profiled scopes to " << filepath << ".\n";
+			return false;
+		}
+
+		std::cout << "INFO: Exported " << exportedCount << " profiled scopes from " << Tracks.size() << " tracks and " << Counters.size() << " counter values to " << filepath << ".\n";
+		return true;
+	}
+
+	void ScopeProfiler::Clear()
+	{
+		std::lock_guard<std::mutex> lock(RegistryMutex);
+		for (auto& track : Tracks)
+			track->ExportedFrom = track->WriteCount.load(std::memory_order_acquire);
+		Counters.clear();
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <utility/Utility.h>
+#include <atomic>
+#include <cstdint>
+
+// Define GEE_DISABLE_SCOPE_PROFILER to compile the scopes out completely.
+#define GEE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GEE_PROFILE_CONCAT(a, b) GEE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef GEE_DISABLE_SCOPE_PROFILER
+	/**
+	 * @brief Records the time spent in the enclosing scope. The name must be a string with static storage duration (e.g. a literal).
+	*/
+	#define GEE_PROFILE_SCOPE(name) ::GEE::ProfileScope GEE_PROFILE_CONCAT(geeProfileScope, __LINE__)(name)
+	/**
+	 * @brief Like GEE_PROFILE_SCOPE, but for names which are built at runtime (e.g. the name of a scene). The name is interned while the profiler is enabled, which takes a lock, so it should only be used for coarse scopes.
+	*/
+	#define GEE_PROFILE_SCOPE_STRING(name) ::GEE::ProfileScope GEE_PROFILE_CONCAT(geeProfileScope, __LINE__)((::GEE::ScopeProfiler::IsEnabled()) ? (::GEE::ScopeProfiler::InternName(name)) : (nullptr))
+	/**
+	 * @brief Records the current value of a counter (see ScopeProfiler::RecordCounter()). The name must be a string with static storage duration.
+	*/
+	#define GEE_PROFILE_COUNTER(name, value) do { if (::GEE::ScopeProfiler::IsEnabled()) ::GEE::ScopeProfiler::RecordCounter(name, static_cast<double>(value)); } while (false)
+#else
+	#define GEE_PROFILE_SCOPE(name)
+	#define GEE_PROFILE_SCOPE_STRING(name)
+	#define GEE_PROFILE_COUNTER(name, value)
+#endif
+
+namespace GEE
+{
+	struct ScopeTrack;
+
+	/**
+	 * @brief Records the beginning and the end of every profiled scope (see GEE_PROFILE_SCOPE) and exports them as a Chrome trace, which can be opened in chrome://tracing or Perfetto. Nested scopes show up as a hierarchy.
+	 * Each thread writes to its own ring buffer (track), so recording does not take any locks; when a buffer is full, the oldest scopes are overwritten. The buffers are allocated when a thread records its first scope.
+	 * Disabled by default. A disabled profiler only costs a relaxed atomic load per scope.
+	*/
+	class ScopeProfiler
+	{
+	public:
+		/**
+		 * @brief The number of scopes each thread keeps.
+		*/
+		static constexpr unsigned int ScopesPerThread = 1u << 16;
+
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Names the calling thread in exported traces. Threads which are not named are exported as "Thread <index>".
+		*/
+		static void SetThreadName(const String& name);
+		/**
+		 * @return a pointer to a copy of the name, which stays valid until the program ends. The same pointer is returned for equal names.
+		*/
+		static const char* InternName(const String& name);
+
+		/**
+		 * @return the number of nanoseconds since the profiler was first used. Monotonic.
+		*/
+		static std::uint64_t GetTimestamp();
+		static void RecordScope(const char* name, std::uint64_t beginTimestamp, std::uint64_t endTimestamp);
+
+		/**
+		 * @brief Adds a track which does not belong to any thread, e.g. for GPU timings. The track stays valid until the program ends.
+		*/
+		static ScopeTrack& AddTrack(const String& name);
+		/**
+		 * @brief Records a scope to the given track. Only one thread at a time can record to a track.
+		*/
+		static void RecordScope(ScopeTrack&, const char* name, std::uint64_t beginTimestamp, std::uint64_t endTimestamp);
+		/**
+		 * @brief Records the value of a counter at the current time. Counters are exported as graphs above the tracks. Recording takes a lock, so counters should only be used for coarse statistics (e.g. the number of loaded shader programs).
+		*/
+		static void RecordCounter(const char* name, double value);
+
+		/**
+		 * @brief Writes all the recorded scopes and counters to a Chrome trace (JSON) file. Scopes which are overwritten while they are being exported are skipped.
+		 * @return false if the file could not be written.
+		*/
+		static bool ExportChromeTrace(const String& filepath);
+		/**
+		 * @brief Discards all the scopes and counters recorded so far, so they are not exported.
+		*/
+		static void Clear();
+
+	private:
+		static std::atomic<bool> bEnabled;
+	};
+
+	/**
+	 * @brief Created by GEE_PROFILE_SCOPE. Does nothing if the profiler was disabled when it was constructed or the name is nullptr.
+	*/
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name) :
+			Name((ScopeProfiler::IsEnabled()) ? (name) : (nullptr)),
+			BeginTimestamp((Name) ? (ScopeProfiler::GetTimestamp()) : (0))
+		{
+		}
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+		~ProfileScope()
+		{
+			if (Name)
+				ScopeProfiler::RecordScope(Name, BeginTimestamp, ScopeProfiler::GetTimestamp());
+		}
+
+	private:
+		const char* Name;
+		std::uint64_t BeginTimestamp;
+	};
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <initializer_list>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace GEE
+{
+	/**
+	 * @brief A non-owning view of a sequence of objects of type T, similar to C++20's std::span.
+	 * Stored is the type of the elements of the viewed array. By default it is T, so the Span views a contiguous array of T.
+	 * It can also be a (smart) pointer to T (see IndirectSpan), so arrays of smart pointers (e.g. std::vector<UniquePtr<T>>) can be viewed without copying the pointed objects or creating a temporary array of raw pointers.
+	 * Elements are accessed through a pointer to the stored element, so iterating does not call anything which cannot be inlined.
+	 * The viewed container must outlive the Span and must not be resized while the Span is used. Passing an initializer list is safe only for the duration of the full expression (e.g. a function call argument).
+	*/
+	template <typename T, typename Stored = T>
+	class Span
+	{
+		static constexpr bool bIndirect = !std::is_same_v<std::remove_const_t<Stored>, std::remove_const_t<T>>;
+		template <typename S> using EnableIfContiguous = std::enable_if_t<std::is_same_v<std::remove_const_t<S>, std::remove_const_t<T>>>;
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			explicit Iterator(Stored* element) : Element(element) {}
+
+			T& operator*() const { return Span::Access(*Element); }
+			T* operator->() const { return &Span::Access(*Element); }
+			Iterator& operator++() { Element++; return *this; }
+			Iterator operator++(int) { Iterator copy = *this; Element++; return copy; }
+			bool operator==(const Iterator& rhs) const { return Element == rhs.Element; }
+			bool operator!=(const Iterator& rhs) const { return !(*this == rhs); }
+
+		private:
+			Stored* Element;
+		};
+
+		Span() : Data(nullptr), Size(0) {}
+		Span(Stored* data, std::size_t size) : Data(data), Size(size) {}
+		/**
+		 * @brief Views a single object.
+		*/
+		template <typename S = Stored, typename = EnableIfContiguous<S>>
+		explicit Span(T& obj) : Span(&obj, 1) {}
+		template <typename S = Stored, typename = EnableIfContiguous<S>>
+		Span(std::initializer_list<std::remove_const_t<T>> list) : Span(list.begin(), list.size()) { static_assert(std::is_const_v<T>, "Only a Span of const objects can view an initializer list."); }
+
+		template <typename Allocator>
+		Span(std::vector<std::remove_const_t<Stored>, Allocator>& vec) : Span(vec.data(), vec.size()) {}
+		template <typename Allocator>
+		Span(const std::vector<std::remove_const_t<Stored>, Allocator>& vec) : Span(vec.data(), vec.size()) { static_assert(std::is_const_v<Stored>, "Only a Span of const elements can view a const vector."); }
+
+		T& operator[](std::size_t index) const { return Access(Data[index]); }
+		std::size_t size() const { return Size; }
+		bool empty() const { return Size == 0; }
+
+		Iterator begin() const { return Iterator(Data); }
+		Iterator end() const { return Iterator(Data + Size); }
+
+	private:
+		static T& Access(Stored& element)
+		{
+			if constexpr (bIndirect)
+				return *element;
+			else
+				return element;
+		}
+
+		Stored* Data;
+		std::size_t Size;
+	};
+
+	/**
+	 * @brief A Span of the objects pointed to by the elements of an array of (smart) pointers, e.g. IndirectSpan<const MeshInstance, UniquePtr<MeshInstance>> views a std::vector<UniquePtr<MeshInstance>>.
+	*/
+	template <typename T, typename PointerType>
+	using IndirectSpan = Span<T, const PointerType>;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <utility/Utility.h>
+#include <game/GameManager.h>
 #include <functional>
 #include <algorithm>
 #include <sstream>
@@ -16,18 +17,25 @@ namespace GEE
 	void UniformBuffer::Generate(unsigned int blockBindingSlot, size_t size, const float* data, GLenum usage)
 	{
 		Dispose();
+		offsetCache = 0;
+		BlockBindingSlot = blockBindingSlot;
+
+		// Headless games have no OpenGL context. Writes to buffers which have not been generated are ignored.
+		if (GameManager::IsHeadless())
+			return;
+
 		glGenBuffers(1, &UBO);
 
 		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
 		glBufferData(GL_UNIFORM_BUFFER, size, data, usage);
 		glBindBufferBase(GL_UNIFORM_BUFFER, blockBindingSlot, UBO);
-
-		offsetCache = 0;
-		BlockBindingSlot = blockBindingSlot;
 	}
 
 	void UniformBuffer::BindToSlot(unsigned int blockBindingSlot, bool isAlreadyBound)
 	{
+		if (!HasBeenGenerated())
+			return;
+
 		if (!isAlreadyBound)
 			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
 		glBindBufferBase(GL_UNIFORM_BUFFER, blockBindingSlot, UBO);
@@ -40,8 +48,11 @@ namespace GEE
 
 	void UniformBuffer::SubData1i(int data, size_t offset)
 	{
-		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
-		glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(int), &data);
+		if (HasBeenGenerated())
+		{
+			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+			glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(int), &data);
+		}
 		offsetCache = offset + sizeof(int);
 	}
 
@@ -52,8 +63,11 @@ namespace GEE
 
 	void UniformBuffer::SubData(size_t size, const float* data, size_t offset)
 	{
-		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
-		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+		if (HasBeenGenerated())
+		{
+			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+			glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+		}
 		offsetCache = offset + size;
 	}
 
@@ -98,6 +112,7 @@ namespace GEE
 	{
 		if (HasBeenGenerated())
 			glDeleteBuffers(1, &UBO); 
+		UBO = 0;
 	}
 
 	String BoolToString(bool b)
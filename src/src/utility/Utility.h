@@ -6,6 +6,8 @@
 #include <glad/glad.h>
 #include <utility/Asserts.h>
 #include <utility>
+#include <cstring>
+#include <type_traits>
 #include <utility/CerealNames.h>
 #include <cereal/types/polymorphic.hpp>
 
@@ -194,6 +196,59 @@ namespace GEE
 		size_t offsetCache;
 	};
 
+	/**
+	 * @brief Owns a UniformBuffer with a single std140 block described by BlockData (which must be a trivially copyable struct with explicit padding).
+	 * The block is uploaded only if the data passed to Bind() differs from the data that was uploaded previously.
+	 * Copies do not share the GL buffer; each copy generates its own one when it is bound for the first time.
+	*/
+	template <typename BlockData>
+	class CachedUniformBuffer
+	{
+	public:
+		CachedUniformBuffer() : UploadedData() {}
+		CachedUniformBuffer(const CachedUniformBuffer&) : CachedUniformBuffer() {}
+		CachedUniformBuffer(CachedUniformBuffer&& buffer) noexcept : Buffer(buffer.Buffer), UploadedData(buffer.UploadedData) { buffer.Buffer = UniformBuffer(); }
+		CachedUniformBuffer& operator=(const CachedUniformBuffer&) { return *this; }
+		CachedUniformBuffer& operator=(CachedUniformBuffer&& buffer) noexcept
+		{
+			if (this != &buffer)
+			{
+				Buffer.Dispose();
+				Buffer = buffer.Buffer;
+				UploadedData = buffer.UploadedData;
+				buffer.Buffer = UniformBuffer();
+			}
+			return *this;
+		}
+		~CachedUniformBuffer() { Buffer.Dispose(); }
+
+		/**
+		 * @brief Uploads the data if it has changed since the last call and binds the buffer to the passed block binding slot.
+		*/
+		void Bind(const BlockData& data, unsigned int blockBindingSlot)
+		{
+			static_assert(std::is_trivially_copyable_v<BlockData> && sizeof(BlockData) % 16 == 0, "BlockData must be a trivially copyable std140 block.");
+			if (!Buffer.HasBeenGenerated())
+			{
+				Buffer.Generate(blockBindingSlot, sizeof(BlockData), reinterpret_cast<const float*>(&data));
+				UploadedData = data;
+				return;
+			}
+
+			const bool bChanged = std::memcmp(&UploadedData, &data, sizeof(BlockData)) != 0;
+			if (bChanged)
+			{
+				Buffer.SubData(sizeof(BlockData), reinterpret_cast<const float*>(&data), 0);
+				UploadedData = data;
+			}
+			Buffer.BindToSlot(blockBindingSlot, bChanged);
+		}
+
+	private:
+		UniformBuffer Buffer;
+		BlockData UploadedData;
+	};
+
 	/*
 	==========================================
 	==========================================
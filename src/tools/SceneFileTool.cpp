@@ -0,0 +1,120 @@
+// Converts projects between the JSON and the binary scene format (assetload/SceneFile.h) and measures both formats.
+// Usage: gee_scene_tool convert <input file> <output file>	- the formats are deduced from the extensions (.json or .geebin)
+//        gee_scene_tool stats <project file> [iterations]	- reports load time, save time and file size of both formats
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <editor/GameEngineEngineEditor.h>
+#include <assetload/FileLoader.h>
+#include <assetload/SceneFile.h>
+#include <game/GameScene.h>
+#include <utility/CommandLine.h>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace GEE;
+Editor::EditorManager* Editor::EditorEventProcessor::EditorHandle = nullptr;
+
+template <typename Func>
+double MeasureMilliseconds(Func&& func)
+{
+	auto begin = std::chrono::steady_clock::now();
+	func();
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+GameScene* LoadScene(Editor::GameEngineEngineEditor& editor, const std::string& path)
+{
+	static unsigned int loadedSceneCount = 0;
+	const std::string sceneName = "GEE_Tool_Scene" + std::to_string(loadedSceneCount++);
+	if (!EngineDataLoader::SetupSceneFromFile(&editor, path, sceneName))	// not Game::LoadSceneFromFile(), which could load the binary file instead of the requested JSON file
+	{
+		std::cerr << "ERROR: Cannot load " << path << ".\n";
+		return nullptr;
+	}
+
+	return editor.GetScene(sceneName);
+}
+
+int Convert(Editor::GameEngineEngineEditor& editor, const std::string& inputPath, const std::string& outputPath)
+{
+	GameScene* scene = LoadScene(editor, inputPath);
+	if (!scene || !SceneFile::Save(*scene, *editor.GetEditorSettings(), outputPath))
+		return 1;
+
+	std::cout << "Converted " << inputPath << " to " << outputPath << ".\n";
+	return 0;
+}
+
+int PrintStats(Editor::GameEngineEngineEditor& editor, const std::string& projectPath, unsigned int iterations)
+{
+	// The first load reads all the tree files used by the project. The trees stay loaded, so the measured loads only include reading the project file.
+	GameScene* scene = LoadScene(editor, projectPath);
+	if (!scene)
+		return 1;
+
+	const std::string tempDirectory = (std::filesystem::temp_directory_path() / "gee_scene_tool").string();
+	std::filesystem::create_directories(tempDirectory);
+
+	std::cout << std::fixed << std::setprecision(2) << "Project " << projectPath << ", " << iterations << " iterations\n";
+	std::cout << "format\tsize (KB)\tsave (ms)\tload (ms)\n";
+	for (SceneFileFormat format : { SceneFileFormat::Json, SceneFileFormat::Binary })
+	{
+		const std::string path = SceneFile::GetPathInFormat(tempDirectory + "/project.json", format);
+		double saveTime = 0.0, loadTime = 0.0;
+		for (unsigned int i = 0; i < iterations; i++)
+		{
+			saveTime += MeasureMilliseconds([&]() { SceneFile::Save(*scene, *editor.GetEditorSettings(), path); });
+			loadTime += MeasureMilliseconds([&]() { LoadScene(editor, path); });
+		}
+
+		std::cout << ((format == SceneFileFormat::Json) ? ("json") : ("binary")) << '\t' << static_cast<double>(std::filesystem::file_size(path)) / 1024.0 << "\t\t" << saveTime / iterations << "\t\t" << loadTime / iterations << '\n';
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	const std::string mode = (argc > 1) ? (argv[1]) : (std::string());
+	unsigned int iterations = 5;
+	if (argc < 3 || (mode != "convert" && mode != "stats") || (mode == "convert" && argc < 4) || (mode == "stats" && argc > 3 && !CommandLine::ParseUnsigned(argv[3], iterations, 1)))
+	{
+		std::cerr << "Usage: gee_scene_tool convert <input file> <output file>\n"
+					 "       gee_scene_tool stats <project file> [iterations (at least 1)]\n";
+		return 1;
+	}
+
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, GEE_GL_VERSION_MAJOR);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, GEE_GL_VERSION_MINOR);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);	// meshes and textures still need an OpenGL context
+
+	SystemWindow* programWindow = glfwCreateWindow(800, 600, "GEE Scene Tool", nullptr, nullptr);
+	if (!programWindow)
+	{
+		std::cerr << "CRITICAL ENGINE ERROR: Cannot create GLFW window. Please check that your system supports OpenGL " <<
+			GEE_GL_VERSION_MAJOR << "." << GEE_GL_VERSION_MINOR << ".\n";
+		return -1;
+	}
+
+	glfwMakeContextCurrent(programWindow);
+
+	if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+	{
+		std::cerr << "CRITICAL ENGINE ERROR: Cannot load GL functions.";
+		return -1;
+	}
+
+	Editor::GameEngineEngineEditor editor(programWindow, GameSettings());
+
+	if (mode == "convert")
+		return Convert(editor, argv[2], argv[3]);
+
+	return PrintStats(editor, argv[2], iterations);
+}